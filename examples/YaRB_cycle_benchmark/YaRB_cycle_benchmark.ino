@@ -0,0 +1,324 @@
+/*
+    YaRB cycle benchmark
+
+    This example sketch measures the number of CPU cycles per call of
+    every function of the IYaRB interface, for every implementation which
+    fits on the board. micros() is far too coarse for single calls (4 us
+    resolution on AVR), so a cycle counter is used instead:
+
+      - Cortex-M3/M4/M7/M33: the DWT cycle counter (CYCCNT)
+      - Cortex-M0/M0+:       SysTick (counts CPU cycles on all Arduino
+                             cores I know of)
+      - AVR:                 Timer1 without prescaler
+
+    Each call is sampled SAMPLES times with interrupts disabled, from the
+    same state of the ring buffer. The time of an empty measurement is
+    subtracted. Bulk calls are measured with a block of BLOCK bytes twice:
+    once where the block does not cross the end of the array (split 0) and
+    once where it does (split 1). For YaRBmt, the position within the
+    array cannot be controlled (split -).
+
+    The results are printed as CSV, one line per case, with the columns
+
+        board, impl, op, block, split, min, median, max
+
+    (all times in cycles), followed by a line starting with "#" with the
+    counter and the overhead. Results from different boards can simply
+    be concatenated.
+
+    On boards with little flash (e.g. Arduino Uno), not all implementations
+    fit at the same time, only five are enabled on AVR by default. Comment
+    out the ones you do not need below, or enable others.
+
+    This example code is in the public domain.
+*/
+
+#include <yarb.h>
+#include <yarbc.h>
+#include <yarbs.h>
+#include <yarbe.h>
+#include <yarbl.h>
+#if !defined(__AVR__)
+#include <yarbm.h>
+#endif
+
+// implementations to benchmark
+#define BENCH_YARB
+#define BENCH_YARBT
+#define BENCH_YARB2
+#define BENCH_YARB2T
+#define BENCH_YARBST
+#if !defined(__AVR__)
+#define BENCH_YARBC
+#define BENCH_YARBCT
+#define BENCH_YARBS
+#define BENCH_YARBE
+#define BENCH_YARBLT
+#endif
+#if defined(YARB_HAS_CAS)
+#define BENCH_YARBMT
+#endif
+
+constexpr size_t  CAPACITY = 64;  // capacity of all ring buffers
+constexpr size_t  BLOCK = 16;     // block size for bulk calls
+constexpr uint8_t SAMPLES = 15;   // samples per case (odd, for the median)
+
+#if defined(ARDUINO_BOARD)
+const char board[] = ARDUINO_BOARD;
+#elif defined(__AVR__)
+const char board[] = "AVR";
+#elif defined(__arm__)
+const char board[] = "ARM";
+#else
+const char board[] = "unknown";
+#endif
+
+#if defined(__AVR__)
+const char counter[] = "Timer1";
+void cycles_init(void) {
+    TCCR1A = 0;
+    TCCR1B = _BV(CS10);  // no prescaler
+}
+inline uint16_t cycles_now(void) {
+    return TCNT1;
+}
+inline uint32_t cycles_between(uint16_t start, uint16_t stop) {
+    return static_cast<uint16_t>(stop - start);
+}
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+// debug and DWT registers, the same on all Cortex-M3 and higher cores
+#define CYC_DEMCR  (*reinterpret_cast<volatile uint32_t*>(0xE000EDFC))
+#define CYC_CTRL   (*reinterpret_cast<volatile uint32_t*>(0xE0001000))
+#define CYC_CYCCNT (*reinterpret_cast<volatile uint32_t*>(0xE0001004))
+#define CYC_LAR    (*reinterpret_cast<volatile uint32_t*>(0xE0001FB0))
+const char counter[] = "DWT";
+void cycles_init(void) {
+    CYC_DEMCR |= (1UL << 24);  // TRCENA: enable DWT
+    CYC_LAR = 0xC5ACCE55;      // unlock (only needed on Cortex-M7)
+    CYC_CYCCNT = 0;
+    CYC_CTRL |= 1;             // CYCCNTENA
+}
+inline uint32_t cycles_now(void) {
+    return CYC_CYCCNT;
+}
+inline uint32_t cycles_between(uint32_t start, uint32_t stop) {
+    return stop - start;
+}
+#elif defined(__arm__)
+// SysTick registers, the same on all Cortex-M cores
+#define CYC_SYST_CSR (*reinterpret_cast<volatile uint32_t*>(0xE000E010))
+#define CYC_SYST_RVR (*reinterpret_cast<volatile uint32_t*>(0xE000E014))
+#define CYC_SYST_CVR (*reinterpret_cast<volatile uint32_t*>(0xE000E018))
+const char counter[] = "SysTick";
+void cycles_init(void) {
+    if (!(CYC_SYST_CSR & 1)) {
+        // not used by the core: run it freely with the CPU clock
+        CYC_SYST_RVR = 0x00FFFFFF;
+        CYC_SYST_CVR = 0;
+        CYC_SYST_CSR = 5;
+    }
+}
+inline uint32_t cycles_now(void) {
+    return CYC_SYST_CVR;
+}
+inline uint32_t cycles_between(uint32_t start, uint32_t stop) {
+    // SysTick counts down and is reloaded with SYST_RVR
+    return (start >= stop) ? (start - stop) : (start + CYC_SYST_RVR + 1 - stop);
+}
+#else
+// no cycle counter known for this architecture: microseconds
+const char counter[] = "micros";
+void cycles_init(void) {
+}
+inline uint32_t cycles_now(void) {
+    return micros();
+}
+inline uint32_t cycles_between(uint32_t start, uint32_t stop) {
+    return stop - start;
+}
+#endif
+
+uint8_t data[CAPACITY];   // random source data
+uint8_t buf[CAPACITY];    // destination for get() and peek()
+uint32_t overhead = 0;    // cycles of an empty measurement
+volatile size_t sink;     // keeps the results of the calls alive
+
+/*
+ * Set the write position of an empty ring buffer to exactly 'to_end'
+ * free slots before the end of the array. The distance is taken from
+ * writeReserve(), which never crosses the end of the array. Return
+ * false if the position cannot be controlled (writeReserve() returns 0).
+ */
+bool position(IYaRB &rb, size_t to_end) {
+    rb.flush();
+    for (uint8_t i=0; i<8; i++) {
+        uint8_t *region;
+        const size_t d = rb.writeReserve(&region);
+        if (d == to_end) return true;
+        const size_t n = (d > to_end) ? d - to_end : d;
+        if (n == 0) return false;
+        rb.put(data, n, true);
+        rb.discard(n);
+    }
+    return false;
+}
+
+// sort samples and print one line of results
+void report(const __FlashStringHelper *impl, const __FlashStringHelper *op, size_t block, int8_t split, uint32_t *samples) {
+    for (uint8_t i=1; i<SAMPLES; i++) {
+        const uint32_t s = samples[i];
+        uint8_t j = i;
+        for (; j>0 && samples[j-1] > s; j--) {
+            samples[j] = samples[j-1];
+        }
+        samples[j] = s;
+    }
+    Serial.print(board);
+    Serial.print(',');
+    Serial.print(impl);
+    Serial.print(',');
+    Serial.print(op);
+    Serial.print(',');
+    Serial.print(block);
+    Serial.print(',');
+    if (split < 0) Serial.print('-');
+    else           Serial.print(split);
+    Serial.print(',');
+    Serial.print(samples[0]);
+    Serial.print(',');
+    Serial.print(samples[SAMPLES/2]);
+    Serial.print(',');
+    Serial.println(samples[SAMPLES-1]);
+}
+
+// measure one call: 'prepare' sets the state (not timed), 'call' is timed
+template <class PREPARE, class CALL>
+void run(const __FlashStringHelper *impl, const __FlashStringHelper *op, size_t block, int8_t split, PREPARE prepare, CALL call) {
+    uint32_t samples[SAMPLES];
+    for (uint8_t i=0; i<SAMPLES; i++) {
+        prepare();
+        noInterrupts();
+        const auto t0 = cycles_now();
+        sink = call();
+        const auto t1 = cycles_now();
+        interrupts();
+        const uint32_t d = cycles_between(t0, t1);
+        samples[i] = (d > overhead) ? (d - overhead) : 0;
+    }
+    if (impl) {
+        report(impl, op, block, split, samples);
+    }
+    else { // calibration: minimum of an empty measurement
+        overhead = samples[0];
+        for (uint8_t i=1; i<SAMPLES; i++) {
+            if (samples[i] < overhead) overhead = samples[i];
+        }
+    }
+}
+
+/*
+ * Measure all functions of one ring buffer. The calls go directly to
+ * the (final) class RB, without virtual dispatch. Preparing the state
+ * goes through IYaRB.
+ */
+template <class RB>
+void bench(RB &rb, const __FlashStringHelper *impl) {
+    IYaRB &irb = rb;
+    uint8_t *region;
+    const uint8_t *cregion;
+    const size_t middle = CAPACITY / 2;    // block does not cross the end
+    const size_t across = BLOCK / 2;       // block crosses the end
+    auto empty  = [&]() { position(irb, middle); };
+    auto single = [&]() { position(irb, middle); irb.put(data[0]); };
+    auto filled = [&]() { position(irb, middle); irb.put(data, BLOCK, false); };
+
+    // single-byte paths
+    run(impl, F("put"),  1, 0, empty,  [&]() { return rb.put(data[0]); });
+    run(impl, F("get"),  1, 0, single, [&]() { return rb.get(buf); });
+    run(impl, F("peek"), 1, 0, single, [&]() { return rb.peek(buf); });
+    run(impl, F("peek_offset"), 1, 0, filled, [&]() { return rb.peek(buf, BLOCK-1); });
+
+    // bulk and zero-copy paths, without and with crossing the end
+    for (uint8_t s=0; s<2; s++) {
+        const size_t to_end = s ? across : middle;
+        const int8_t split = position(irb, to_end) ? s : -1;
+        auto at   = [&]() { position(irb, to_end); };
+        auto full = [&]() { position(irb, to_end); irb.put(data, BLOCK, false); };
+        run(impl, F("put"),          BLOCK, split, at,   [&]() { return rb.put(data, BLOCK, false); });
+        run(impl, F("get"),          BLOCK, split, full, [&]() { return rb.get(buf, BLOCK); });
+        run(impl, F("peek"),         BLOCK, split, full, [&]() { return rb.peek(buf, BLOCK, 0); });
+        run(impl, F("discard"),      BLOCK, split, full, [&]() { return rb.discard(BLOCK); });
+        run(impl, F("writeReserve"), BLOCK, split, at,   [&]() { return rb.writeReserve(&region); });
+        run(impl, F("commit"),       BLOCK, split, [&]() { position(irb, to_end); irb.writeReserve(&region); },
+                                                         [&]() { return rb.commit(BLOCK); });
+        run(impl, F("readSpan"),     BLOCK, split, full, [&]() { return rb.readSpan(&cregion); });
+        run(impl, F("consume"),      BLOCK, split, full, [&]() { return rb.consume(BLOCK); });
+    }
+
+    // queries
+    run(impl, F("size"),     0, 0, filled, [&]() { return rb.size(); });
+    run(impl, F("free"),     0, 0, filled, [&]() { return rb.free(); });
+    run(impl, F("capacity"), 0, 0, filled, [&]() { return rb.capacity(); });
+    run(impl, F("isFull"),   0, 0, filled, [&]() { return static_cast<size_t>(rb.isFull()); });
+    run(impl, F("isEmpty"),  0, 0, filled, [&]() { return static_cast<size_t>(rb.isEmpty()); });
+    run(impl, F("flush"),    0, 0, filled, [&]() { rb.flush(); return static_cast<size_t>(0); });
+}
+
+void setup() {
+
+    Serial.begin(115200);
+    while (!Serial);
+
+    cycles_init();
+    for (size_t i=0; i<sizeof(data); i++) {
+        data[i] = static_cast<uint8_t>(random(1, 256));  // no delimiters for YaRBc
+    }
+    // calibrate: time of an empty measurement
+    run(nullptr, nullptr, 0, 0, []() {}, []() { return static_cast<size_t>(0); });
+
+    Serial.println(F("board,impl,op,block,split,min,median,max"));
+#if defined(BENCH_YARB)
+    { YaRB rb(CAPACITY);               bench(rb, F("YaRB")); }
+#endif
+#if defined(BENCH_YARBT)
+    { YaRBt<CAPACITY> rb;              bench(rb, F("YaRBt")); }
+#endif
+#if defined(BENCH_YARB2)
+    { YaRB2 rb(CAPACITY);              bench(rb, F("YaRB2")); }
+#endif
+#if defined(BENCH_YARB2T)
+    { YaRB2t<CAPACITY> rb;             bench(rb, F("YaRB2t")); }
+#endif
+#if defined(BENCH_YARBC)
+    { YaRBc rb(CAPACITY);              bench(rb, F("YaRBc")); }
+#endif
+#if defined(BENCH_YARBCT)
+    { YaRBct<CAPACITY> rb;             bench(rb, F("YaRBct")); }
+#endif
+#if defined(BENCH_YARBS)
+    { YaRBs rb(CAPACITY);              bench(rb, F("YaRBs")); }
+#endif
+#if defined(BENCH_YARBST)
+    { YaRBst<CAPACITY> rb;             bench(rb, F("YaRBst")); }
+#endif
+#if defined(BENCH_YARBE)
+    { YaRBe rb(CAPACITY);              bench(rb, F("YaRBe")); }
+#endif
+#if defined(BENCH_YARBLT)
+    { YaRBlt<CAPACITY> rb;             bench(rb, F("YaRBlt")); }
+#endif
+#if defined(BENCH_YARBMT)
+    { YaRBmt<CAPACITY> rb;             bench(rb, F("YaRBmt")); }
+#endif
+    Serial.print(F("# counter "));
+    Serial.print(counter);
+    Serial.print(F(", overhead "));
+    Serial.print(overhead);
+    Serial.print(F(" cycles subtracted, "));
+    Serial.print(SAMPLES);
+    Serial.println(F(" samples per case"));
+
+} // end of setup()
+
+void loop() {
+}
@@ -0,0 +1,173 @@
+/*
+    YaRB lock latency benchmark
+
+    This example sketch measures the worst-case time a YaRBlt ring buffer
+    holds its lock for each lock policy available on the board. While the
+    lock is held, interrupts are masked (YaRBLockIrq: all of them,
+    YaRBLockBasepri: those with the same or lower urgency), so this is the
+    worst-case additional interrupt latency caused by the ring buffer.
+
+    For comparison, the same is measured for a YaRBt which is protected by
+    disabling interrupts around the whole put()/get() call, including the
+    copy of the data.
+
+    The lock policy is wrapped in a policy which reads a cycle counter
+    right after entering and right before leaving the critical section:
+    SysTick on Cortex-M (counts CPU cycles on all Arduino cores I know of),
+    Timer1 without prescaler on AVR. On other architectures, micros() is
+    used instead, which is only good for rough numbers. The wrapper itself
+    adds a few cycles.
+
+    Expected result: the lock window of YaRBlt does not depend on the block
+    size, the one of the simple YaRBt does, growing linearly with it.
+
+    This example code is in the public domain.
+*/
+
+#include <yarb.h>
+#include <yarbl.h>
+
+#if defined(__AVR__)
+const char unit[] = " cycles";
+void cycles_init(void) {
+    TCCR1A = 0;
+    TCCR1B = _BV(CS10);  // no prescaler
+}
+uint16_t cycles_now(void) {
+    return TCNT1;
+}
+uint32_t cycles_between(uint16_t start, uint16_t stop) {
+    return static_cast<uint16_t>(stop - start);
+}
+#elif defined(__arm__)
+// SysTick registers, the same on all Cortex-M cores
+#define SYST_RVR (*reinterpret_cast<volatile uint32_t*>(0xE000E014))
+#define SYST_CVR (*reinterpret_cast<volatile uint32_t*>(0xE000E018))
+const char unit[] = " cycles";
+void cycles_init(void) {
+}
+uint32_t cycles_now(void) {
+    return SYST_CVR;
+}
+uint32_t cycles_between(uint32_t start, uint32_t stop) {
+    // SysTick counts down and is reloaded with SYST_RVR
+    return (start >= stop) ? (start - stop) : (start + SYST_RVR + 1 - stop);
+}
+#else
+// no cycle counter known for this architecture: microseconds
+const char unit[] = " us";
+void cycles_init(void) {
+}
+uint32_t cycles_now(void) {
+    return micros();
+}
+uint32_t cycles_between(uint32_t start, uint32_t stop) {
+    return stop - start;
+}
+#endif
+
+uint32_t worst = 0;  // longest lock window seen so far (cycles, or us)
+
+// measuring wrapper around any lock policy
+template <class LOCK>
+struct Timed {
+    typedef typename LOCK::state state;
+    state lock(void) {
+        const state s = lk.lock();
+        t0 = cycles_now();
+        return s;
+    }
+    void unlock(state s) {
+        const uint32_t d = cycles_between(t0, cycles_now());
+        if (d > worst) worst = d;
+        lk.unlock(s);
+    }
+    LOCK lk;
+    decltype(cycles_now()) t0;
+};
+
+constexpr size_t CAPACITY = 256;
+const size_t blocks[] = {1, 16, 64, 256};
+uint8_t data[CAPACITY];
+
+template <class RB>
+void measure(RB &rb, const __FlashStringHelper *name) {
+    for (size_t block : blocks) {
+        worst = 0;
+        for (int i=0; i<100; i++) {
+            if (block == 1) {
+                rb.put(data[0]);
+                rb.get(data);
+            }
+            else {
+                rb.put(data, block, false);
+                rb.get(data, block);
+            }
+        }
+        Serial.print(name);
+        Serial.print(F(", block "));
+        Serial.print(block);
+        Serial.print(F(": "));
+        Serial.print(worst);
+        Serial.println(unit);
+    }
+}
+
+#if defined(YARB_HAS_LOCK_IRQ)
+// YaRBt protected by disabling interrupts around the whole call,
+// lock window measured the same way
+void measure_whole_call(void) {
+    static YaRBt<CAPACITY> rb;
+    Timed<YaRBLockIrq> t;
+    for (size_t block : blocks) {
+        worst = 0;
+        for (int i=0; i<100; i++) {
+            Timed<YaRBLockIrq>::state s = t.lock();
+            rb.put(data, block, false);
+            t.unlock(s);
+            s = t.lock();
+            rb.get(data, block);
+            t.unlock(s);
+        }
+        Serial.print(F("YaRBt, whole call with interrupts disabled, block "));
+        Serial.print(block);
+        Serial.print(F(": "));
+        Serial.print(worst);
+        Serial.println(unit);
+    }
+}
+#endif
+
+void setup() {
+
+    Serial.begin(115200);
+    while (!Serial);
+
+    Serial.println(F("\n\nStarting lock latency benchmark for YaRB\n"));
+    cycles_init();
+    for (size_t i=0; i<sizeof(data); i++) {
+        data[i] = static_cast<uint8_t>(random(0, 256));
+    }
+
+    static YaRBlt<CAPACITY, Timed<YaRBLockNone> > rb_none;
+    measure(rb_none, F("YaRBlt<YaRBLockNone>"));
+#if defined(YARB_HAS_LOCK_IRQ)
+    static YaRBlt<CAPACITY, Timed<YaRBLockIrq> > rb_irq;
+    measure(rb_irq, F("YaRBlt<YaRBLockIrq>"));
+#endif
+#if defined(YARB_HAS_LOCK_BASEPRI)
+    // mask priorities 4 and lower, shifted to the implemented priority bits
+    // (__NVIC_PRIO_BITS from the CMSIS device header, e.g. 3 on SAMD51)
+    static YaRBlt<CAPACITY, Timed<YaRBLockBasepri<(4 << (8 - __NVIC_PRIO_BITS))> > > rb_basepri;
+    measure(rb_basepri, F("YaRBlt<YaRBLockBasepri>"));
+#endif
+#if defined(YARB_HAS_LOCK_IRQ)
+    measure_whole_call();
+#endif
+
+    Serial.println(F("\nYaRB lock latency benchmark finished."));
+
+} // end of setup()
+
+void loop() {
+}
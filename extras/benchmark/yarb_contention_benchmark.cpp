@@ -0,0 +1,168 @@
+/*
+    YaRB contention benchmark
+
+    This program measures the throughput of the ring buffers which can be
+    shared by several producer and consumer threads, on a desktop computer
+    (Linux, macOS, ...). Build and run it with
+
+        make yarb_contention_benchmark
+        ./yarb_contention_benchmark            > contention.csv
+        ./yarb_contention_benchmark --json     > contention.json
+        ./yarb_contention_benchmark --mbytes 64
+
+    Compared are (all with a capacity of 1024 bytes):
+
+      - YaRBmt:              lock-free, one compare-and-swap per call
+      - YaRBlt-mutex:        YaRBlt<1024, YaRBLockMutex>, the mutex is only
+                             held to reserve and to publish a range
+      - YaRBt-mutex:         YaRBt<1024> with a std::mutex held for the
+                             whole put()/get() call, including the copy
+
+    for 1, 2 and 4 producers and 1, 2 and 4 consumers, each putting or
+    getting blocks of 1, 16 or 64 bytes. The producers put a total of
+    --mbytes MiB (default 16), the time until the consumers have got all
+    of it is measured.
+
+    The results are printed as CSV (default) or JSON, one record per case
+    with the columns
+
+        impl, producers, consumers, block, mbytes_per_s
+
+    Threads which find the ring buffer full (empty) call
+    std::this_thread::yield(). The numbers depend heavily on the number
+    of cores and on the scheduler, compare them on the same machine only.
+
+    This example code is in the public domain.
+*/
+
+#include "yarb.h"
+#include "yarbl.h"
+#include "yarbm.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::steady_clock bench_clock;
+
+static size_t mbytes = 16;        // MiB per case
+static bool   json = false;       // output format
+static bool   first_record = true;
+
+/*
+ * The usual way to share a ring buffer: one mutex around every call.
+ */
+template <class RB>
+class MutexWrapped {
+    public:
+        size_t put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) {
+            std::lock_guard<std::mutex> guard(m);
+            return rb.put(new_elements, nbr_elements, only_complete);
+        }
+        size_t get(uint8_t *returned_elements, size_t nbr_elements) {
+            std::lock_guard<std::mutex> guard(m);
+            return rb.get(returned_elements, nbr_elements);
+        }
+    private:
+        std::mutex m;
+        RB rb;
+};
+
+static void report(const char *impl, int producers, int consumers, size_t block, double mbytes_per_s) {
+    if (json) {
+        printf("%s\n  {\"impl\": \"%s\", \"producers\": %d, \"consumers\": %d, \"block\": %zu, \"mbytes_per_s\": %.1f}",
+               first_record ? "[" : ",", impl, producers, consumers, block, mbytes_per_s);
+    }
+    else {
+        if (first_record) printf("impl,producers,consumers,block,mbytes_per_s\n");
+        printf("%s,%d,%d,%zu,%.1f\n", impl, producers, consumers, block, mbytes_per_s);
+    }
+    first_record = false;
+}
+
+template <class RB>
+static void bench_case(const char *impl, int producers, int consumers, size_t block) {
+    RB *rb = new RB();
+    const size_t total = mbytes << 20;
+    const size_t per_producer = total / producers;
+    std::atomic<size_t> received{0};
+    std::atomic<unsigned> sum{0};
+    std::vector<std::thread> threads;
+
+    const bench_clock::time_point t0 = bench_clock::now();
+    for (int p=0; p<producers; p++) {
+        threads.emplace_back([=]() {
+            std::vector<uint8_t> src(block, static_cast<uint8_t>(p));
+            size_t sent = 0;
+            while (sent < per_producer) {
+                const size_t n = (per_producer - sent < block) ? (per_producer - sent) : block;
+                const size_t added = rb->put(src.data(), n, false);
+                if (added == 0) std::this_thread::yield();
+                sent += added;
+            }
+        });
+    }
+    for (int c=0; c<consumers; c++) {
+        threads.emplace_back([&, block]() {
+            std::vector<uint8_t> dst(block);
+            unsigned s = 0;
+            while (received.load(std::memory_order_relaxed) < per_producer * producers) {
+                const size_t got = rb->get(dst.data(), block);
+                if (got == 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                s += dst[0];
+                received.fetch_add(got, std::memory_order_relaxed);
+            }
+            sum += s;
+        });
+    }
+    for (std::thread &t : threads) t.join();
+    const bench_clock::time_point t1 = bench_clock::now();
+
+    const double s = std::chrono::duration<double>(t1 - t0).count();
+    report(impl, producers, consumers, block, (per_producer * producers) / s / (1 << 20));
+    delete rb;
+}
+
+template <class RB>
+static void bench_impl(const char *impl) {
+    const int threads[] = {1, 2, 4};
+    const size_t blocks[] = {1, 16, 64};
+    for (int producers : threads) {
+        for (int consumers : threads) {
+            for (size_t block : blocks) {
+                bench_case<RB>(impl, producers, consumers, block);
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    for (int i=1; i<argc; i++) {
+        if (!strcmp(argv[i], "--json")) {
+            json = true;
+        }
+        else if (!strcmp(argv[i], "--mbytes") && i+1 < argc) {
+            mbytes = strtoul(argv[++i], nullptr, 10);
+            if (mbytes == 0) mbytes = 1;
+        }
+        else {
+            fprintf(stderr, "usage: %s [--json] [--mbytes N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    bench_impl<YaRBmt<1024> >("YaRBmt");
+    bench_impl<YaRBlt<1024, YaRBLockMutex> >("YaRBlt-mutex");
+    bench_impl<MutexWrapped<YaRBt<1024> > >("YaRBt-mutex");
+
+    if (json) printf("%s]\n", first_record ? "[" : "\n");
+    return 0;
+}
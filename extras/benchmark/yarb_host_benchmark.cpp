@@ -0,0 +1,293 @@
+/*
+    YaRB host benchmark
+
+    This program benchmarks the YaRB ring buffer implementations on a 
+    desktop computer (Linux, macOS, ...), without any Arduino board.
+    Build and run it with
+    
+        make
+        ./yarb_host_benchmark            > results.csv
+        ./yarb_host_benchmark --json     > results.json
+        ./yarb_host_benchmark --reps 100000
+
+    Every implementation is measured with capacities 255 and 256 (i.e.
+    a non-power-of-two vs. a power-of-two capacity) for:
+    
+      - put_single/get_single: fill/drain the whole buffer with 
+        single-byte calls
+      - put_bulk/get_bulk/discard: one call with a block of 2, 16, 64 
+        or 128 bytes, starting 
+          - "nowrap": at a position where the block does not wrap around
+          - "wrap":   in the middle of the block at the end of the array
+    
+    Each case is run with direct calls on the concrete class ("direct")
+    and through an IYaRB reference ("virtual").
+    
+    The results are printed as CSV (default) or JSON, one record per case
+    with the columns
+    
+        impl, capacity, op, block, position, dispatch, ns_per_byte, calls_per_s
+    
+    so the output of two releases can be compared with any tool.
+    
+    Each call is timed individually with std::chrono::steady_clock. The
+    overhead of the timer itself is measured at start-up and subtracted.
+    For very small blocks, the numbers are still dominated by timer 
+    resolution, compare them between runs on the same machine only.
+
+    This example code is in the public domain.
+*/
+
+#include "yarb.h"
+#include "yarbc.h"
+#include "yarbe.h"
+#include "yarbl.h"
+#include "yarbp.h"
+#include "yarbs.h"
+#include "yarbv.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock bench_clock;
+
+static size_t reps = 20000;       // measured calls per case
+static bool   json = false;       // output format
+static bool   first_record = true;
+static double timer_overhead = 0; // ns per pair of now() calls
+static unsigned sink = 0;         // prevent optimizing away the reads
+
+// byte classes for YaRBpt: COBS frames and lines, HDLC flags and escapes
+static constexpr YaRBByteClass classes[3] = {
+    yarb_byte_class(0x00, '\n'), yarb_byte_class(0x7E), yarb_byte_class(0x7D)
+};
+
+static double ns_between(bench_clock::time_point a, bench_clock::time_point b) {
+    return std::chrono::duration<double, std::nano>(b - a).count();
+}
+
+static void calibrate_timer(void) {
+    // take the minimum average over some rounds
+    double best = 1e30;
+    for (int round=0; round<10; round++) {
+        double sum = 0;
+        for (int i=0; i<10000; i++) {
+            const bench_clock::time_point t0 = bench_clock::now();
+            const bench_clock::time_point t1 = bench_clock::now();
+            sum += ns_between(t0, t1);
+        }
+        if (sum / 10000 < best) best = sum / 10000;
+    }
+    timer_overhead = best;
+}
+
+static void report(const char *impl, size_t capacity, const char *op, size_t block, 
+                   const char *position, const char *dispatch, 
+                   double total_ns, size_t timings, size_t calls, size_t bytes) {
+    // subtract timer overhead, but never report negative times
+    double net_ns = total_ns - timer_overhead * timings;
+    if (net_ns < 0) net_ns = 0;
+    const double ns_per_byte = net_ns / bytes;
+    const double calls_per_s = net_ns > 0 ? calls / (net_ns * 1e-9) : 0;
+    if (json) {
+        printf("%s\n  {\"impl\": \"%s\", \"capacity\": %zu, \"op\": \"%s\", \"block\": %zu, "
+               "\"position\": \"%s\", \"dispatch\": \"%s\", \"ns_per_byte\": %.4f, \"calls_per_s\": %.0f}",
+               first_record ? "[" : ",", impl, capacity, op, block, position, dispatch, ns_per_byte, calls_per_s);
+    }
+    else {
+        if (first_record) printf("impl,capacity,op,block,position,dispatch,ns_per_byte,calls_per_s\n");
+        printf("%s,%zu,%s,%zu,%s,%s,%.4f,%.0f\n", 
+               impl, capacity, op, block, position, dispatch, ns_per_byte, calls_per_s);
+    }
+    first_record = false;
+}
+
+/*
+ * Helper to move the (empty) ring buffer to a known array position. 
+ * All implementations start at position 0 and we keep track of the
+ * position ourselves. Moving is done with commit()/consume(), which do
+ * not copy data.
+ */
+template <class RB>
+class Positioner {
+    public:
+        Positioner(RB &rb) : rb{rb}, slots{0}, pos{0} {
+            // determine number of array slots: after advancing by 
+            // capacity() bytes, the reserved region reaches up to the 
+            // end of the array (i.e. slots - capacity bytes), or we are
+            // back at the start of the array
+            const size_t cap = rb.capacity();
+            move_by(cap);
+            uint8_t *region;
+            const size_t len = rb.writeReserve(&region);
+            slots = (len == cap) ? cap : cap + len;
+            pos = cap % slots;
+        }
+        void move_to(size_t p) {
+            move_by((p + slots - pos) % slots);
+            pos = p;
+        }
+        void moved(size_t nbr_elements) {
+            pos = (pos + nbr_elements) % slots;
+        }
+        size_t wrap_position(size_t block) const {
+            return slots - block/2;
+        }
+    private:
+        void move_by(size_t n) {
+            while (n) {
+                uint8_t *region;
+                size_t len = rb.writeReserve(&region);
+                if (len > n) len = n;
+                rb.commit(len);
+                rb.consume(len);
+                n -= len;
+            }
+        }
+        RB &rb;
+        size_t slots;
+        size_t pos;
+};
+
+template <class RB>
+static void bench_single(RB &rb, Positioner<RB> &ps, const char *impl, const char *dispatch) {
+    const size_t cap = rb.capacity();
+    const size_t rounds = reps / cap + 1;
+    double put_ns = 0, get_ns = 0;
+    for (size_t r=0; r<rounds; r++) {
+        bench_clock::time_point t0 = bench_clock::now();
+        for (size_t i=0; i<cap; i++) rb.put(static_cast<uint8_t>(i));
+        bench_clock::time_point t1 = bench_clock::now();
+        put_ns += ns_between(t0, t1);
+        uint8_t b = 0;
+        t0 = bench_clock::now();
+        for (size_t i=0; i<cap; i++) {
+            rb.get(&b);
+            sink += b;
+        }
+        t1 = bench_clock::now();
+        get_ns += ns_between(t0, t1);
+        ps.moved(cap);
+    }
+    // one timing per round, not per call
+    report(impl, cap, "put_single", 1, "any", dispatch, put_ns, rounds, rounds*cap, rounds*cap);
+    report(impl, cap, "get_single", 1, "any", dispatch, get_ns, rounds, rounds*cap, rounds*cap);
+}
+
+template <class RB>
+static void bench_bulk(RB &rb, Positioner<RB> &ps, const char *impl, const char *dispatch, 
+                       size_t block, bool wrap) {
+    const size_t cap = rb.capacity();
+    const size_t start = wrap ? ps.wrap_position(block) : 0;
+    const char *position = wrap ? "wrap" : "nowrap";
+    std::vector<uint8_t> src(block), dst(block);
+    for (size_t i=0; i<block; i++) src[i] = static_cast<uint8_t>(i*7);
+    double put_ns = 0, get_ns = 0, discard_ns = 0;
+    for (size_t r=0; r<reps; r++) {
+        // put and get at the same position
+        ps.move_to(start);
+        bench_clock::time_point t0 = bench_clock::now();
+        rb.put(src.data(), block, false);
+        bench_clock::time_point t1 = bench_clock::now();
+        put_ns += ns_between(t0, t1);
+        t0 = bench_clock::now();
+        rb.get(dst.data(), block);
+        t1 = bench_clock::now();
+        get_ns += ns_between(t0, t1);
+        sink += dst[block-1];
+        ps.moved(block);
+        // discard at the same position, data is filled in untimed
+        ps.move_to(start);
+        rb.put(src.data(), block, false);
+        t0 = bench_clock::now();
+        rb.discard(block);
+        t1 = bench_clock::now();
+        discard_ns += ns_between(t0, t1);
+        ps.moved(block);
+    }
+    report(impl, cap, "put_bulk", block, position, dispatch, put_ns, reps, reps, reps*block);
+    report(impl, cap, "get_bulk", block, position, dispatch, get_ns, reps, reps, reps*block);
+    report(impl, cap, "discard", block, position, dispatch, discard_ns, reps, reps, reps*block);
+}
+
+template <class RB>
+static void bench_all(RB &rb, const char *impl, const char *dispatch) {
+    Positioner<RB> ps(rb);
+    bench_single(rb, ps, impl, dispatch);
+    const size_t blocks[] = {2, 16, 64, 128};
+    for (size_t block : blocks) {
+        if (block > rb.capacity()) continue;
+        bench_bulk(rb, ps, impl, dispatch, block, false);
+        bench_bulk(rb, ps, impl, dispatch, block, true);
+    }
+}
+
+/*
+ * Benchmark one ring buffer instance twice: with the concrete type
+ * (the compiler knows the type and calls directly) and through a base
+ * class reference (the pointer is laundered through a volatile, so the
+ * compiler cannot devirtualize the calls).
+ */
+template <class RB>
+static void bench_impl(RB &rb, const char *impl) {
+    bench_all(rb, impl, "direct");
+    IYaRB * volatile laundered = &rb;
+    bench_all(*laundered, impl, "virtual");
+}
+
+int main(int argc, char **argv) {
+    for (int i=1; i<argc; i++) {
+        if (!strcmp(argv[i], "--json")) {
+            json = true;
+        }
+        else if (!strcmp(argv[i], "--reps") && i+1 < argc) {
+            reps = strtoul(argv[++i], nullptr, 10);
+            if (reps == 0) reps = 1;
+        }
+        else {
+            fprintf(stderr, "usage: %s [--json] [--reps N]\n", argv[0]);
+            return 1;
+        }
+    }
+    calibrate_timer();
+    
+    { YaRB a(255);       bench_impl(a, "YaRB");  }
+    { YaRB a(256);       bench_impl(a, "YaRB");  }
+    { YaRBt<255> a;      bench_impl(a, "YaRBt"); }
+    { YaRBt<256> a;      bench_impl(a, "YaRBt"); }
+    { YaRB2 a(255);      bench_impl(a, "YaRB2");  }
+    { YaRB2 a(256);      bench_impl(a, "YaRB2");  }
+    { YaRB2t<255> a;     bench_impl(a, "YaRB2t"); }
+    { YaRB2t<256> a;     bench_impl(a, "YaRB2t"); }
+    { YaRBc a(255);      bench_impl(a, "YaRBc");  }
+    { YaRBc a(256);      bench_impl(a, "YaRBc");  }
+    { YaRBct<255> a;     bench_impl(a, "YaRBct"); }
+    { YaRBct<256> a;     bench_impl(a, "YaRBct"); }
+    { YaRBpt<255, 3> a(classes); bench_impl(a, "YaRBpt"); }
+    { YaRBpt<256, 3> a(classes); bench_impl(a, "YaRBpt"); }
+    { YaRBs a(255);      bench_impl(a, "YaRBs");  }
+    { YaRBs a(256);      bench_impl(a, "YaRBs");  }
+    { YaRBst<255> a;     bench_impl(a, "YaRBst"); }
+    { YaRBst<256> a;     bench_impl(a, "YaRBst"); }
+    { YaRBe a(255);      bench_impl(a, "YaRBe");  }
+    { YaRBe a(256);      bench_impl(a, "YaRBe");  }
+    { YaRBlt<255> a;     bench_impl(a, "YaRBlt");  }
+    { YaRBlt<256> a;     bench_impl(a, "YaRBlt");  }
+#if defined(YARB_HAS_LOCK_MUTEX)
+    { YaRBlt<255, YaRBLockMutex> a; bench_impl(a, "YaRBlt-mutex"); }
+    { YaRBlt<256, YaRBLockMutex> a; bench_impl(a, "YaRBlt-mutex"); }
+#endif
+#if defined(YARB_HOSTED)
+    // capacity is rounded up to the page size
+    { YaRBv a(256);      if (a.capacity()) bench_impl(a, "YaRBv"); }
+#endif
+
+    if (json) printf("%s]\n", first_record ? "[" : "\n");
+    // print the checksum, so the compiler cannot drop the reads
+    fprintf(stderr, "checksum %u\n", sink);
+    return 0;
+}
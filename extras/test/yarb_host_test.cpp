@@ -0,0 +1,200 @@
+/*
+    YaRB host tests
+
+    This program checks corner cases of the YaRB ring buffer 
+    implementations on a desktop computer (Linux, macOS, ...), without
+    any Arduino board. Build and run it with
+    
+        make test
+
+    Every failed check is printed with its line number. The exit code is
+    the number of failed checks.
+
+    This example code is in the public domain.
+*/
+
+#include "yarb.h"
+#include "yarbc.h"
+#include "yarbe.h"
+#include "yarbp.h"
+#include "yarb_pool.h"
+
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <utility>
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static const uint8_t abc[] = {'a', 'b', 'c'};
+
+// CRC-16/CCITT-FALSE of "abc"
+static const uint32_t crc_abc = 0x514A;
+
+// a tracker attached while a message is partly stored
+static void test_crc_attach_mid_message(void) {
+    YaRBc rb(16);
+    YaRBCrcTracker<YaRBCrc16> tracker;
+    const uint8_t c0[] = {'c', 0};
+    rb.put(abc, 2, false);
+    rb.attachCrc(&tracker);
+    rb.put(c0, 2, false);
+    uint8_t buf[8];
+    uint32_t crc = 0;
+    CHECK(rb.getMessage(buf, sizeof(buf), &crc) == 4);
+    CHECK(crc == crc_abc);
+    // the next message gets a snapshot again
+    const uint8_t abc0[] = {'a', 'b', 'c', 0};
+    rb.put(abc0, 4, false);
+    CHECK(rb.messageCrc(&crc) && crc == crc_abc);
+}
+
+// CRC-16/CCITT-FALSE of "bc" and "c"
+static const uint32_t crc_bc = 0x2C82;
+static const uint32_t crc_c  = 0xBD35;
+
+// bytes of the oldest message are removed without its delimiter
+template <class RB>
+static void check_crc_truncated(RB &rb) {
+    const uint8_t abc0[] = {'a', 'b', 'c', 0};
+    uint8_t buf[8];
+    uint32_t crc = 0;
+    // single-byte get()
+    rb.put(abc0, 4, false);
+    rb.get(buf);
+    CHECK(rb.messageCrc(&crc) && crc == crc_bc);
+    rb.flush();
+    // bulk get()
+    rb.put(abc0, 4, false);
+    rb.get(buf, 2);
+    CHECK(rb.messageCrc(&crc) && crc == crc_c);
+    rb.flush();
+    // discard(), also with an older complete message before
+    rb.put(abc0, 4, false);
+    rb.put(abc0, 4, false);
+    rb.discard(5);
+    CHECK(rb.messageCrc(&crc) && crc == crc_bc);
+    CHECK(rb.getMessage(buf, sizeof(buf), &crc) == 3 && crc == crc_bc);
+    // incomplete message, completed after the removal
+    rb.put(abc0, 2, false);
+    rb.get(buf);
+    rb.put(abc0+2, 2, false);
+    CHECK(rb.messageCrc(&crc) && crc == crc_bc);
+    rb.flush();
+    // removing whole messages keeps the snapshots
+    rb.put(abc0, 4, false);
+    rb.put(abc0, 4, false);
+    rb.discard(4);
+    CHECK(rb.messageCrc(&crc) && crc == crc_abc);
+    rb.flush();
+}
+
+static void test_crc_truncated(void) {
+    YaRBc rb(16);
+    YaRBCrcTracker<YaRBCrc16> tracker;
+    rb.attachCrc(&tracker);
+    check_crc_truncated(rb);
+    YaRBct<16, 8, YaRBNoStats, YaRBCrcTracker<YaRBCrc16>> rbt;
+    check_crc_truncated(rbt);
+    YaRBct<15, 8, YaRBNoStats, YaRBCrcTracker<YaRBCrc16>> rbt2;
+    check_crc_truncated(rbt2);
+}
+
+// the oldest bytes are dropped in overwrite mode
+static void test_crc_overwrite(void) {
+    YaRBc rb(4, 0, 8, true);
+    YaRBCrcTracker<YaRBCrc16> tracker;
+    rb.attachCrc(&tracker);
+    const uint8_t abc0[] = {'a', 'b', 'c', 0};
+    uint32_t crc = 0;
+    rb.put(abc0, 4, false);
+    rb.put('x');
+    CHECK(rb.messageCrc(&crc) && crc == crc_bc);
+}
+
+// byte classes given as a temporary, with more than 8 member values
+static void test_classes_temporary(void) {
+    YaRBpt<64, 2> rb({yarb_byte_class('\n'), yarb_byte_class(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 11, 12)});
+    const uint8_t data[] = {1, 2, '\n', 3, '\n', 99};
+    rb.put(data, sizeof(data), false);
+    rb.put(5);
+    CHECK(rb.count(0) == 2);
+    CHECK(rb.count(1) == 4);
+    CHECK(rb.messageLength() == 3);
+    uint8_t buf[8];
+    CHECK(rb.getMessage(buf, sizeof(buf)) == 3);
+    CHECK(rb.count(0) == 1 && rb.count(1) == 2);
+}
+
+// an elastic ring buffer which cannot grow fails softly
+static void test_elastic_no_memory(void) {
+    YaRBe rb(16);
+    CHECK(!rb.reserve(YaRBe::limit() / 2));
+    CHECK(rb.capacity() == 16);
+}
+
+// An exhausted pool gives a capacity of 0 without falling back to the heap,
+// and the block is not given back to the pool on destruction.
+static void test_pool_exhausted(void) {
+    static uint8_t memory[8];
+    YaRBPool pool(memory, sizeof(memory), sizeof(memory));
+    YaRB first(pool);
+    CHECK(first.capacity() == sizeof(memory) - 1);
+    {
+        YaRB second(pool);
+        YaRB2 third(pool);
+        YaRBc fourth(pool);
+        CHECK(second.capacity() == 0 && third.capacity() == 0 && fourth.capacity() == 0);
+        CHECK(second.put('a') == 0 && third.put('a') == 0 && fourth.put('a') == 0);
+    }
+    CHECK(!pool.acquire());
+}
+
+// A YaRBStats declared without an initializer starts with all counters at 0.
+static void test_stats_local(void) {
+    alignas(YaRBStats) uint8_t garbage[sizeof(YaRBStats)];
+    memset(garbage, 0xA5, sizeof(garbage));
+    YaRBStats *st = new (garbage) YaRBStats;
+    YaRBc rb(8);
+    rb.attachStats(st);
+    rb.put('a');
+    CHECK(st->peak == 1 && st->total_in == 1 && st->total_out == 0);
+    CHECK(st->rejected == 0 && st->refusals == 0 && st->overwritten == 0 && st->empty_gets == 0);
+    rb.attachStats(nullptr);
+}
+
+// A moved-from ring buffer in overwrite mode drops every new element.
+static void test_overwrite_moved_from(void) {
+    YaRB rb(4, true);
+    YaRB other(std::move(rb));
+    const uint8_t bytes[3] = {'a', 'b', 'c'};
+    CHECK(rb.capacity() == 0);
+    CHECK(rb.put('a') == 1 && rb.put(bytes, 3, false) == 3);
+    CHECK(rb.isEmpty() && rb.size() == 0);
+}
+
+int main(void) {
+    test_crc_attach_mid_message();
+    test_crc_truncated();
+    test_crc_overwrite();
+    test_classes_temporary();
+    test_elastic_no_memory();
+    test_pool_exhausted();
+    test_stats_local();
+    test_overwrite_moved_from();
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+    }
+    else {
+        printf("all checks passed\n");
+    }
+    return failures;
+}
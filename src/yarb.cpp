@@ -31,7 +31,16 @@
  */
  
 #include "yarb.h"
-#include <string.h>  // memcpy(), for copy constructor
+#include <string.h>  // memcpy()
+
+/*
+ * Note:
+ * A moved-from YaRB or YaRB2 has a capacity of 0. It still needs an array
+ * (of one byte for YaRB), which is never read. All moved-from instances
+ * share this array, so moving never allocates. The same holds for a ring
+ * buffer whose caller-owned storage or pool block is missing.
+ */
+static uint8_t yarb_moved_from[1];
 
 /* YaRB */
 
@@ -43,74 +52,227 @@
  *          The target capacity of the ring buffer. The array to hold all
  *          elements is allocated upon construction. The size is constant
  *          and cannot be changed afterwards.
+ * @param   overwrite
+ *          If true, put() never fails: when the ring buffer is full, the
+ *          oldest elements are dropped to make room for the new ones.
+ *          If false (default), new elements are dropped instead.
  * @note    capacity is the effectively usable capacity of the ring buffer.
  *          This implementation allocates one additional byte internally.
  */
-YaRB::YaRB(size_t capacity) 
-    : cap{capacity+1}, readindex{0}, writeindex{0}, arraypointer{nullptr} {
+YaRB::YaRB(size_t capacity, bool overwrite) 
+    : cap{capacity+1}, ovw{overwrite}, readindex{0}, writeindex{0}, arraypointer{nullptr},
+      own{true}, pool{nullptr} {
     arraypointer = new uint8_t[cap];
 }
 
+/**
+ * @brief   Constructor using caller-owned storage.
+ * @details No memory is allocated, the ring buffer uses the given storage
+ *          for its array. The storage must outlive the ring buffer.
+ * @param   storage
+ *          Start of the storage, e.g. a static array or a part of an arena.
+ * @param   storage_size
+ *          Size of the storage in bytes. The capacity of the ring buffer
+ *          is storage_size-1 (see storageSize()). If storage is nullptr or
+ *          storage_size is 0, the ring buffer has a capacity of 0.
+ * @param   overwrite
+ *          Overwrite mode, see YaRB(size_t capacity, bool overwrite).
+ */
+YaRB::YaRB(uint8_t *storage, size_t storage_size, bool overwrite) 
+    : cap{(storage && storage_size) ? storage_size : 1}, ovw{overwrite}, readindex{0}, writeindex{0}, 
+      arraypointer{storage}, own{false}, pool{nullptr} {
+    if (!storage || !storage_size) {
+        // a capacity of 0 still needs an array of one byte,
+        // never allocate it (see yarb_moved_from)
+        arraypointer = yarb_moved_from;
+    }
+}
+
+/**
+ * @brief   Constructor using a block from a pool as storage.
+ * @details The block is given back to the pool by the destructor. 
+ * @param   pool
+ *          The pool to take the block from. The capacity of the ring 
+ *          buffer is pool.blockSize()-1. If there is no free block, the
+ *          ring buffer has a capacity of 0.
+ * @param   overwrite
+ *          Overwrite mode, see YaRB(size_t capacity, bool overwrite).
+ */
+YaRB::YaRB(YaRBPool &pool, bool overwrite) 
+    : YaRB(pool.acquire(), pool.blockSize(), overwrite) {
+    if (arraypointer != yarb_moved_from) this->pool = &pool;
+}
+
 /**
  * @brief   The copy constructor.
+ * @details The copy always allocates its own array.
  * @param   rb
  *          Reference to class instance to copy.
  */
 YaRB::YaRB(const YaRB &rb)
-    : cap{rb.cap}, readindex{rb.readindex}, writeindex{rb.writeindex}, arraypointer{nullptr} {
+    : cap{rb.cap}, ovw{rb.ovw}, readindex{rb.readindex}, writeindex{rb.writeindex}, arraypointer{nullptr},
+      own{true}, pool{nullptr} {
     arraypointer = new uint8_t[cap];
-    memcpy(arraypointer, &(rb.arraypointer), cap);        
+    copyElements(rb);
+}
+
+/**
+ * @brief   The move constructor.
+ * @details The array is taken over from rb, nothing is allocated or 
+ *          copied. rb is left with a capacity of 0.
+ * @param   rb
+ *          Reference to class instance to move from.
+ */
+YaRB::YaRB(YaRB &&rb)
+    : cap{rb.cap}, ovw{rb.ovw}, readindex{rb.readindex}, writeindex{rb.writeindex}, arraypointer{rb.arraypointer},
+      own{rb.own}, pool{rb.pool} {
+    rb.forgetArray();
 }
 
 /**
  * @brief   The destructor.
  */
 YaRB::~YaRB() {
-    delete[] arraypointer;
+    freeArray();
 }
 
-size_t YaRB::put(uint8_t new_element) {
-    if (this->isFull()) {
-        return 0;
-    }
-    else {
-        arraypointer[writeindex] = new_element;
-        writeindex = (writeindex + 1) % cap;
-        return 1;
+/**
+ * @brief   The assignment operator.
+ * @details Afterwards, this ring buffer has the same capacity, mode and
+ *          contents as rb. The existing array is reused if the capacities
+ *          match, otherwise a new one is allocated. Only the size() stored
+ *          bytes are copied.
+ * @param   rb
+ *          Reference to class instance to copy.
+ * @return  Reference to this instance.
+ */
+YaRB& YaRB::operator=(const YaRB &rb) {
+    // protect against self-assignment
+    if (this == &rb) return *this;
+    if (cap != rb.cap) {
+        freeArray();
+        cap = rb.cap;
+        arraypointer = new uint8_t[cap];
+        own = true;
+        pool = nullptr;
     }
+    ovw = rb.ovw;
+    readindex = rb.readindex;
+    writeindex = rb.writeindex;
+    copyElements(rb);
+    return *this;
 }
-        
+
+/**
+ * @brief   The move assignment operator.
+ * @details The own array is freed (or given back to its pool) and the
+ *          array of rb is taken over. rb is left with a capacity of 0.
+ * @param   rb
+ *          Reference to class instance to move from.
+ * @return  Reference to this instance.
+ */
+YaRB& YaRB::operator=(YaRB &&rb) {
+    // protect against self-assignment
+    if (this == &rb) return *this;
+    freeArray();
+    cap = rb.cap;
+    ovw = rb.ovw;
+    readindex = rb.readindex;
+    writeindex = rb.writeindex;
+    arraypointer = rb.arraypointer;
+    own = rb.own;
+    pool = rb.pool;
+    rb.forgetArray();
+    return *this;
+}
+
 size_t YaRB::put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) {
     // check validity of input pointer (may be nullptr)
     if (!new_elements ) {
         return 0;
     }
+    const size_t requested = nbr_elements;
+    if (ovw) {
+        // overwrite mode: all elements are accepted,
+        // with capacity 0 they are dropped right away
+        if (this->isFull() && this->isEmpty()) {
+            return requested;
+        }
+        if (nbr_elements >= this->capacity()) {
+            // only the newest capacity() elements survive
+            new_elements += nbr_elements - this->capacity();
+            nbr_elements = this->capacity();
+            this->flush();
+        }
+        else if (nbr_elements > this->free()) {
+            // drop oldest elements in one go (O(1), see discard())
+            this->discard(nbr_elements - this->free());
+        }
+    }
     // only add at most free() elements to ring buffer
-    if (nbr_elements > this->free()) {
+    else if (nbr_elements > this->free()) {
         if (only_complete) return 0;
         nbr_elements = this->free();
     }
-    for (size_t i=0; i<nbr_elements; i++) {
-          // re-implementation is about 3-4 times faster than calling
-          // single-element put()
-          arraypointer[writeindex] = *new_elements;
-          writeindex = (writeindex + 1) % cap;
-          new_elements++;
+    // copy in at most two segments: 
+    // from writeindex to end of array, then from start of array
+    const size_t diff_to_max = cap - writeindex;
+    if (nbr_elements < diff_to_max) { // does not wrap
+        memcpy(arraypointer+writeindex, new_elements, nbr_elements);
+        writeindex += nbr_elements;
     }
-    return nbr_elements;
+    else {
+        memcpy(arraypointer+writeindex, new_elements, diff_to_max);
+        memcpy(arraypointer, new_elements+diff_to_max, nbr_elements-diff_to_max);
+        writeindex = nbr_elements - diff_to_max;
+    }
+    return ovw ? requested : nbr_elements;
 }
 
-size_t YaRB::peek(uint8_t *peeked_element) const {
-    // check for emptyness and validity of output pointer (may be nullptr)
-    if (this->isEmpty() || !peeked_element) {
+size_t YaRB::peek(uint8_t *peeked_element, size_t offset) const {
+    // check for enough elements and validity of output pointer (may be nullptr)
+    if (offset >= this->size() || !peeked_element) {
         return 0;
     }
     else {
-        *peeked_element = arraypointer[readindex];
+        // do modulus calculation "manually" (see discard())
+        const size_t r = readindex;
+        const size_t diff_to_end = cap - r;
+        *peeked_element = arraypointer[(offset < diff_to_end) ? (r + offset) : (offset - diff_to_end)];
         return 1;
     }
 }
 
+size_t YaRB::peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const {
+    // check for nullptr
+    if (!peeked_elements) {
+        return 0;
+    }
+    // only peek at most the size()-offset elements after offset
+    const size_t used = this->size();
+    if (offset >= used) {
+        return 0;
+    }
+    if (nbr_elements > used - offset) {
+        nbr_elements = used - offset;
+    }
+    // first element to peek at, see peek(peeked_element, offset)
+    const size_t r = readindex;
+    const size_t diff = cap - r;
+    const size_t start = (offset < diff) ? (r + offset) : (offset - diff);
+    // copy out in at most two segments, exactly like get(), but leave
+    // readindex unchanged
+    const size_t diff_to_end = cap - start;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        memcpy(peeked_elements, arraypointer+start, nbr_elements);
+    }
+    else {
+        memcpy(peeked_elements, arraypointer+start, diff_to_end);
+        memcpy(peeked_elements+diff_to_end, arraypointer, nbr_elements-diff_to_end);
+    }
+    return nbr_elements;
+}
+
 size_t YaRB::discard(size_t nbr_elements) {
     if (this->size() > nbr_elements) { // there will be remaining elements in buffer
         // Due to danger of integer overflow, we cannot just do
@@ -121,7 +283,7 @@ size_t YaRB::discard(size_t nbr_elements) {
         //
         // The difference between current readindex and cap is always >= 0 (i.e. at least 1)
         size_t diff_to_max = cap - readindex;
-        if (nbr_elements > diff_to_max) { // readindex+nbr_elements > 2*cap --> danger of overflow
+        if (nbr_elements >= diff_to_max) { // readindex+nbr_elements >= cap --> wrap
             readindex = nbr_elements - diff_to_max;
         }
         else { // adding nbr_elements to readindex does not wrap
@@ -139,16 +301,47 @@ size_t YaRB::discard(size_t nbr_elements) {
     }
 }
 
-size_t YaRB::get(uint8_t *returned_element) {
-    // check for emptyness and validity of output pointer (may  be nullptr)
-    if (this->isEmpty() || !returned_element) {
+size_t YaRB::writeReserve(uint8_t **region) {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
         return 0;
     }
-    else {
-        *returned_element = arraypointer[readindex];
-        readindex = (readindex + 1) % cap;
-        return 1;
+    const size_t w = writeindex;
+    *region = arraypointer+w;
+    // the free region ends at the end of the array at the latest
+    const size_t diff_to_end = cap - w;
+    const size_t free_slots = this->free();
+    return (free_slots < diff_to_end) ? free_slots : diff_to_end;
+}
+
+size_t YaRB::commit(size_t nbr_elements) {
+    // only commit at most the region writeReserve() reports
+    uint8_t *region;
+    const size_t reserved = this->writeReserve(&region);
+    if (nbr_elements > reserved) {
+        nbr_elements = reserved;
+    }
+    // the region never wraps, but it may end exactly at the end of the array
+    writeindex += nbr_elements;
+    if (writeindex == cap) writeindex = 0;
+    return nbr_elements;
+}
+
+size_t YaRB::readSpan(const uint8_t **region) const {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
+        return 0;
     }
+    const size_t r = readindex;
+    *region = arraypointer+r;
+    // the stored region ends at the end of the array at the latest
+    const size_t diff_to_end = cap - r;
+    const size_t used = this->size();
+    return (used < diff_to_end) ? used : diff_to_end;
+}
+
+size_t YaRB::consume(size_t nbr_elements) {
+    return this->discard(nbr_elements);
 }
 
 size_t YaRB::get(uint8_t *returned_elements, size_t nbr_elements) {
@@ -161,47 +354,80 @@ size_t YaRB::get(uint8_t *returned_elements, size_t nbr_elements) {
         if (nbr_elements > this->size()) {
             nbr_elements = this->size();
         }
-        for (size_t i=0; i<nbr_elements; i++) {    
-            *returned_elements = arraypointer[readindex];
-            readindex = (readindex + 1 ) % cap;
-            returned_elements++;
+        // copy out in at most two segments:
+        // from readindex to end of array, then from start of array
+        const size_t diff_to_max = cap - readindex;
+        if (nbr_elements < diff_to_max) { // does not wrap
+            memcpy(returned_elements, arraypointer+readindex, nbr_elements);
+            readindex += nbr_elements;
+        }
+        else {
+            memcpy(returned_elements, arraypointer+readindex, diff_to_max);
+            memcpy(returned_elements+diff_to_max, arraypointer, nbr_elements-diff_to_max);
+            readindex = nbr_elements - diff_to_max;
         }
         return nbr_elements;
     }
 }
         
-size_t YaRB::size(void) const {
-    if (writeindex >= readindex) {
-        return writeindex - readindex;
-    }
-    else {
-        return cap - (readindex - writeindex);
-    }
-}
-
-size_t YaRB::free(void) const {
-    return this->capacity() - this->size();
+void YaRB::flush(void) {
+    // fast-forward readindex to position of writeindex
+    readindex = writeindex;
 }
 
-size_t YaRB::capacity(void) const {
-    return cap-1;
+size_t YaRB::limit(void) {
+    return SIZE_MAX - 1;
 }
 
-bool YaRB::isFull(void) const {
-    return readindex == (writeindex + 1) % cap;
+/**
+ * @brief   Get the size of the storage needed for a given capacity.
+ * @param   capacity
+ *          The target capacity of the ring buffer.
+ * @return  Size of the storage in bytes, see YaRB(uint8_t*, size_t, bool).
+ */
+size_t YaRB::storageSize(size_t capacity) {
+    return capacity + 1;
 }
 
-bool YaRB::isEmpty(void) const {
-    return readindex == writeindex;
+/**
+ * @brief   Copy the stored elements of rb to the same positions.
+ * @details The indices of both ring buffers must already be equal. Only 
+ *          size() elements are copied, in at most two segments.
+ * @param   rb
+ *          Reference to class instance to copy from.
+ */
+void YaRB::copyElements(const YaRB &rb) {
+    const size_t r = readindex;
+    const size_t n = rb.size();
+    const size_t diff_to_max = cap - r;
+    if (n <= diff_to_max) { // does not wrap
+        memcpy(arraypointer+r, rb.arraypointer+r, n);
+    }
+    else {
+        memcpy(arraypointer+r, rb.arraypointer+r, diff_to_max);
+        memcpy(arraypointer, rb.arraypointer, n-diff_to_max);
+    }
 }
 
-void YaRB::flush(void) {
-    // fast-forward readindex to position of writeindex
-    readindex = writeindex;
+/**
+ * @brief   Free the array or give it back to its pool.
+ */
+void YaRB::freeArray(void) {
+    if (pool) pool->release(arraypointer);
+    else if (own) delete[] arraypointer;
 }
 
-size_t YaRB::limit(void) {
-    return SIZE_MAX - 1;
+/**
+ * @brief   Let go of the array (after it was moved), leaving an empty
+ *          ring buffer with a capacity of 0.
+ */
+void YaRB::forgetArray(void) {
+    cap = 1;
+    readindex = 0;
+    writeindex = 0;
+    arraypointer = yarb_moved_from;
+    own = false;
+    pool = nullptr;
 }
 
 /* YaRB2 */
@@ -216,37 +442,119 @@ size_t YaRB::limit(void) {
  *          and cannot be changed afterwards.
  */
 YaRB2::YaRB2(size_t capacity) 
-    : cap{capacity}, readindex{0}, writeindex{0}, arraypointer{nullptr} {
+    : cap{capacity}, readindex{0}, writeindex{0}, arraypointer{nullptr},
+      own{true}, pool{nullptr} {
     arraypointer = new uint8_t[cap];
 }
 
+/**
+ * @brief   Constructor using caller-owned storage.
+ * @details No memory is allocated, the ring buffer uses the given storage
+ *          for its array. The storage must outlive the ring buffer.
+ * @param   storage
+ *          Start of the storage, e.g. a static array or a part of an arena.
+ * @param   storage_size
+ *          Size of the storage in bytes, which is also the capacity of the
+ *          ring buffer. If storage is nullptr, the ring buffer has a 
+ *          capacity of 0.
+ */
+YaRB2::YaRB2(uint8_t *storage, size_t storage_size) 
+    : cap{storage ? storage_size : 0}, readindex{0}, writeindex{0}, arraypointer{storage},
+      own{false}, pool{nullptr} {
+    if (!storage) {
+        // capacity 0, never allocate (see yarb_moved_from)
+        arraypointer = yarb_moved_from;
+    }
+}
+
+/**
+ * @brief   Constructor using a block from a pool as storage.
+ * @details The block is given back to the pool by the destructor. 
+ * @param   pool
+ *          The pool to take the block from. The capacity of the ring 
+ *          buffer is pool.blockSize(). If there is no free block, the
+ *          ring buffer has a capacity of 0.
+ */
+YaRB2::YaRB2(YaRBPool &pool) 
+    : YaRB2(pool.acquire(), pool.blockSize()) {
+    if (arraypointer != yarb_moved_from) this->pool = &pool;
+}
+
 /**
  * @brief   The copy constructor.
+ * @details The copy always allocates its own array.
  * @param   rb
  *          Reference to class instance to copy.
  */
 YaRB2::YaRB2(const YaRB2 &rb)
-    : cap{rb.cap}, readindex{rb.readindex}, writeindex{rb.writeindex}, arraypointer{nullptr} {
+    : cap{rb.cap}, readindex{rb.readindex}, writeindex{rb.writeindex}, arraypointer{nullptr},
+      own{true}, pool{nullptr} {
     arraypointer = new uint8_t[cap];
-    memcpy(arraypointer, &(rb.arraypointer), (cap * sizeof(uint8_t)) );        
+    copyElements(rb);
+}
+
+/**
+ * @brief   The move constructor.
+ * @details The array is taken over from rb, nothing is allocated or 
+ *          copied. rb is left with a capacity of 0.
+ * @param   rb
+ *          Reference to class instance to move from.
+ */
+YaRB2::YaRB2(YaRB2 &&rb)
+    : cap{rb.cap}, readindex{rb.readindex}, writeindex{rb.writeindex}, arraypointer{rb.arraypointer},
+      own{rb.own}, pool{rb.pool} {
+    rb.forgetArray();
 }
 
 /**
  * @brief   The destructor.
  */
 YaRB2::~YaRB2() {
-    delete[] arraypointer;
+    freeArray();
 }
 
-size_t YaRB2::put(uint8_t new_element) {
-    if (this->isFull()) {
-        return 0;
-    }
-    else {
-        arraypointer[modcap(writeindex)] = new_element;
-        writeindex = modcap2(writeindex+1);
-        return 1;
+/**
+ * @brief   The assignment operator.
+ * @details See YaRB::operator=(const YaRB &rb).
+ * @param   rb
+ *          Reference to class instance to copy.
+ * @return  Reference to this instance.
+ */
+YaRB2& YaRB2::operator=(const YaRB2 &rb) {
+    // protect against self-assignment
+    if (this == &rb) return *this;
+    if (cap != rb.cap) {
+        freeArray();
+        cap = rb.cap;
+        arraypointer = new uint8_t[cap];
+        own = true;
+        pool = nullptr;
     }
+    readindex = rb.readindex;
+    writeindex = rb.writeindex;
+    copyElements(rb);
+    return *this;
+}
+
+/**
+ * @brief   The move assignment operator.
+ * @details See YaRB::operator=(YaRB &&rb).
+ * @param   rb
+ *          Reference to class instance to move from.
+ * @return  Reference to this instance.
+ */
+YaRB2& YaRB2::operator=(YaRB2 &&rb) {
+    // protect against self-assignment
+    if (this == &rb) return *this;
+    freeArray();
+    cap = rb.cap;
+    readindex = rb.readindex;
+    writeindex = rb.writeindex;
+    arraypointer = rb.arraypointer;
+    own = rb.own;
+    pool = rb.pool;
+    rb.forgetArray();
+    return *this;
 }
 
 size_t YaRB2::put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) {
@@ -259,45 +567,68 @@ size_t YaRB2::put(const uint8_t *new_elements, size_t nbr_elements, bool only_co
         if (only_complete) return 0;
         nbr_elements = this->free();
     }
-    for (size_t i=0; i<nbr_elements; i++) {
-          // re-implementation is about 3-4 times faster than calling
-          // single-element put()
-          arraypointer[modcap(writeindex)] = *new_elements;
-          writeindex = modcap2(writeindex+1);
-          new_elements++;
+    // copy in at most two segments: 
+    // from writeindex to end of array, then from start of array
+    const size_t w = modcap(writeindex);
+    const size_t diff_to_end = cap - w;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        memcpy(arraypointer+w, new_elements, nbr_elements);
     }
+    else {
+        memcpy(arraypointer+w, new_elements, diff_to_end);
+        memcpy(arraypointer, new_elements+diff_to_end, nbr_elements-diff_to_end);
+    }
+    writeindex = advance(writeindex, nbr_elements);
     return nbr_elements;
 }
 
-size_t YaRB2::peek(uint8_t *peeked_element) const {
-    // check for emptyness and validity of output pointer (may be nullptr)
-    if (this->isEmpty() || !peeked_element) {
+size_t YaRB2::peek(uint8_t *peeked_element, size_t offset) const {
+    // check for enough elements and validity of output pointer (may be nullptr)
+    if (offset >= this->size() || !peeked_element) {
         return 0;
     }
     else {
-        *peeked_element = arraypointer[modcap(readindex)];
+        // do modulus calculation "manually" (see discard())
+        const size_t r = modcap(readindex);
+        const size_t diff_to_end = cap - r;
+        *peeked_element = arraypointer[(offset < diff_to_end) ? (r + offset) : (offset - diff_to_end)];
         return 1;
     }
 }
 
+size_t YaRB2::peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const {
+    // check for nullptr
+    if (!peeked_elements) {
+        return 0;
+    }
+    // only peek at most the size()-offset elements after offset
+    const size_t used = this->size();
+    if (offset >= used) {
+        return 0;
+    }
+    if (nbr_elements > used - offset) {
+        nbr_elements = used - offset;
+    }
+    // first element to peek at, see peek(peeked_element, offset)
+    const size_t r = modcap(readindex);
+    const size_t diff = cap - r;
+    const size_t start = (offset < diff) ? (r + offset) : (offset - diff);
+    // copy out in at most two segments, exactly like get(), but leave
+    // readindex unchanged
+    const size_t diff_to_end = cap - start;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        memcpy(peeked_elements, arraypointer+start, nbr_elements);
+    }
+    else {
+        memcpy(peeked_elements, arraypointer+start, diff_to_end);
+        memcpy(peeked_elements+diff_to_end, arraypointer, nbr_elements-diff_to_end);
+    }
+    return nbr_elements;
+}
+
 size_t YaRB2::discard(size_t nbr_elements) {
     if (this->size() > nbr_elements) { // there will be remaining elements in buffer
-        // Due to danger of integer overflow, we cannot just do
-        // readindex = modcap2(readindex + nbr_elements):
-        // readindex + nbr_elements *might* be larger than SIZE_MAX, which
-        // would then overflow, giving wrong results after modcap2.
-        // --> Do modulus calculation "manually".
-        //
-        // The difference between current readindex is always > 0 (i.e. at least 1)
-        size_t diff_to_max = 2*cap - readindex;
-        if (diff_to_max <= nbr_elements) { // readindex+nbr_elements > 2*cap --> danger of overflow
-            readindex = nbr_elements - diff_to_max;
-        }
-        else { // adding nbr_elements to readindex stays in correct range
-            // no need for modcap2(), adding nbr_elements keeps readindex
-            // below 2*cap
-            readindex = readindex + nbr_elements;
-        }
+        readindex = advance(readindex, nbr_elements);
         // return nbr_elements, no matter if we had to wrap around or not
         return nbr_elements;
     }
@@ -310,16 +641,45 @@ size_t YaRB2::discard(size_t nbr_elements) {
     }
 }
 
-size_t YaRB2::get(uint8_t *returned_element) {
-    // check for emptyness and validity of output pointer (may  be nullptr)
-    if (this->isEmpty() || !returned_element) {
+size_t YaRB2::writeReserve(uint8_t **region) {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
         return 0;
     }
-    else {
-        *returned_element = arraypointer[modcap(readindex)];
-        readindex = modcap2(readindex+1);
-        return 1;
+    const size_t w = modcap(writeindex);
+    *region = arraypointer+w;
+    // the free region ends at the end of the array at the latest
+    const size_t diff_to_end = cap - w;
+    const size_t free_slots = this->free();
+    return (free_slots < diff_to_end) ? free_slots : diff_to_end;
+}
+
+size_t YaRB2::commit(size_t nbr_elements) {
+    // only commit at most the region writeReserve() reports
+    uint8_t *region;
+    const size_t reserved = this->writeReserve(&region);
+    if (nbr_elements > reserved) {
+        nbr_elements = reserved;
+    }
+    writeindex = advance(writeindex, nbr_elements);
+    return nbr_elements;
+}
+
+size_t YaRB2::readSpan(const uint8_t **region) const {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
+        return 0;
     }
+    const size_t r = modcap(readindex);
+    *region = arraypointer+r;
+    // the stored region ends at the end of the array at the latest
+    const size_t diff_to_end = cap - r;
+    const size_t used = this->size();
+    return (used < diff_to_end) ? used : diff_to_end;
+}
+
+size_t YaRB2::consume(size_t nbr_elements) {
+    return this->discard(nbr_elements);
 }
 
 size_t YaRB2::get(uint8_t *returned_elements, size_t nbr_elements) {
@@ -332,37 +692,22 @@ size_t YaRB2::get(uint8_t *returned_elements, size_t nbr_elements) {
         if (nbr_elements > this->size()) {
             nbr_elements = this->size();
         }
-        for (size_t i=0; i<nbr_elements; i++) {
-            // re-implementation is about 2 times faster than calling
-            // single-element get()        
-            *returned_elements = arraypointer[modcap(readindex)];
-            readindex = modcap2(readindex+1);
-            returned_elements++;
+        // copy out in at most two segments:
+        // from readindex to end of array, then from start of array
+        const size_t r = modcap(readindex);
+        const size_t diff_to_end = cap - r;
+        if (nbr_elements <= diff_to_end) { // does not wrap
+            memcpy(returned_elements, arraypointer+r, nbr_elements);
+        }
+        else {
+            memcpy(returned_elements, arraypointer+r, diff_to_end);
+            memcpy(returned_elements+diff_to_end, arraypointer, nbr_elements-diff_to_end);
         }
+        readindex = advance(readindex, nbr_elements);
         return nbr_elements;
     }
 }
         
-size_t YaRB2::size(void) const {
-    return modcap2(writeindex-readindex);
-}
-
-size_t YaRB2::free(void) const {
-    return cap - this->size();
-}
-
-size_t YaRB2::capacity(void) const {
-    return cap;
-}
-
-bool YaRB2::isFull(void) const {
-    return this->size() == cap;
-}
-
-bool YaRB2::isEmpty(void) const {
-    return readindex == writeindex;
-}
-
 void YaRB2::flush(void) {
     // fast-forward readindex to position of writeindex
     readindex = writeindex;
@@ -372,11 +717,53 @@ size_t YaRB2::limit(void) {
     return SIZE_MAX / 2;
 }
 
-inline size_t YaRB2::modcap(size_t val) const {
-    return (cap == 0) ? 0 : (val % cap);
+/**
+ * @brief   Get the size of the storage needed for a given capacity.
+ * @param   capacity
+ *          The target capacity of the ring buffer.
+ * @return  Size of the storage in bytes, see YaRB2(uint8_t*, size_t).
+ */
+size_t YaRB2::storageSize(size_t capacity) {
+    return capacity;
 }
 
-inline size_t YaRB2::modcap2(size_t val) const {
-    return (cap == 0) ? 0 : (val % (2 * cap));
+/**
+ * @brief   Copy the stored elements of rb to the same positions.
+ * @details The indices of both ring buffers must already be equal. Only 
+ *          size() elements are copied, in at most two segments.
+ * @param   rb
+ *          Reference to class instance to copy from.
+ */
+void YaRB2::copyElements(const YaRB2 &rb) {
+    const size_t r = modcap(readindex);
+    const size_t n = rb.size();
+    const size_t diff_to_max = cap - r;
+    if (n <= diff_to_max) { // does not wrap
+        memcpy(arraypointer+r, rb.arraypointer+r, n);
+    }
+    else {
+        memcpy(arraypointer+r, rb.arraypointer+r, diff_to_max);
+        memcpy(arraypointer, rb.arraypointer, n-diff_to_max);
+    }
+}
+
+/**
+ * @brief   Free the array or give it back to its pool.
+ */
+void YaRB2::freeArray(void) {
+    if (pool) pool->release(arraypointer);
+    else if (own) delete[] arraypointer;
 }
 
+/**
+ * @brief   Let go of the array (after it was moved), leaving an empty
+ *          ring buffer with a capacity of 0.
+ */
+void YaRB2::forgetArray(void) {
+    cap = 0;
+    readindex = 0;
+    writeindex = 0;
+    arraypointer = yarb_moved_from;
+    own = false;
+    pool = nullptr;
+}
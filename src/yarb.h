@@ -34,6 +34,9 @@
 #define yarb_h
 
 #include "yarb_interface.h"
+#include "yarb_index.h"
+#include "yarb_copy.h"
+#include "yarb_pool.h"
 
 /**
  * @class   YaRB
@@ -45,21 +48,25 @@
  *          This is due to the fact that the assignment operation for data
  *          type size_t is not atomic on some platforms.
  */
-class YaRB : public IYaRB {
+class YaRB final : public IYaRB {
     public:
-        // constructor
-        YaRB(size_t capacity=63);
+        // constructors
+        YaRB(size_t capacity=63, bool overwrite=false);
+        YaRB(uint8_t *storage, size_t storage_size, bool overwrite=false); // caller-owned storage
+        YaRB(YaRBPool &pool, bool overwrite=false);                        // storage from a pool
         
-        // copy constructor
+        // copy and move constructors
         YaRB(const YaRB &rb);
+        YaRB(YaRB &&rb);
         
         // destructor
         virtual ~YaRB(void);
         
-        // Genrally do not allow assignments:
-        // It is unclear how to handle assignment of ring buffers with
-        // different capacities.
-        YaRB& operator= (const YaRB &rb) = delete;
+        // Assignment makes this ring buffer an exact copy of rb, including
+        // its capacity. Moving transfers the array and leaves rb with a
+        // capacity of 0.
+        YaRB& operator= (const YaRB &rb);
+        YaRB& operator= (YaRB &&rb);
 
         // put element(s) into ring buffer
         size_t put(uint8_t new_element) override;
@@ -69,14 +76,21 @@ class YaRB : public IYaRB {
         size_t get(uint8_t *returned_element) override;
         size_t get(uint8_t *returned_elements, size_t nbr_elements) override;
         
-        // look at next element in ring buffer
-        // note: there is no multi-byte-version!
+        // look at element(s) in ring buffer without removing them
         size_t peek(uint8_t *peeked_element) const override; 
+        size_t peek(uint8_t *peeked_element, size_t offset) const override;
+        size_t peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const override;
         
         // discard some elements from ring buffer, 
         // return number of discarded elements
         size_t discard(size_t nbr_elements) override;
 
+        // zero-copy access to the internal array
+        size_t writeReserve(uint8_t **region) override;
+        size_t commit(size_t nbr_elements) override;
+        size_t readSpan(const uint8_t **region) const override;
+        size_t consume(size_t nbr_elements) override;
+
         size_t size(void) const override;     // return number of slots in use
         size_t free(void) const override;     // return number of free slots
         size_t capacity(void) const override; // return total number of slots
@@ -87,29 +101,118 @@ class YaRB : public IYaRB {
         
         // no override for static functions...
         static size_t limit(void);   // return maximum possible number of elements on a given platform
+        static size_t storageSize(size_t capacity); // return storage size in bytes needed for capacity
 
     private:
-        const size_t  cap;     ///< store size of internaly array
+        size_t  cap;           ///< store size of internaly array
+        bool    ovw;           ///< overwrite oldest elements when full
         size_t  readindex;     ///< index for get()
         size_t  writeindex;    ///< index for put()
         uint8_t *arraypointer; ///< pointer to array which holds the elements
+        bool    own;           ///< array was allocated by this instance
+        YaRBPool *pool;        ///< pool the array belongs to, may be nullptr
+
+        // helper functions for copying and moving
+        void   copyElements(const YaRB &rb);
+        void   freeArray(void);
+        void   forgetArray(void);
 };
 
+// inline definitions of the functions on the hot path
+
+inline size_t YaRB::put(uint8_t new_element) {
+    if (this->isFull()) {
+        if (!ovw) return 0;
+        // with capacity 0, the new element is dropped right away
+        // (the array may be shared, see yarb_moved_from)
+        if (this->isEmpty()) return 1;
+        // overwrite mode: drop oldest element
+        readindex = (readindex + 1 == cap) ? 0 : (readindex + 1);
+    }
+    arraypointer[writeindex] = new_element;
+    // no division, even on CPUs without hardware divider
+    writeindex = (writeindex + 1 == cap) ? 0 : (writeindex + 1);
+    return 1;
+}
+
+inline size_t YaRB::peek(uint8_t *peeked_element) const {
+    // check for emptyness and validity of output pointer (may be nullptr)
+    if (this->isEmpty() || !peeked_element) {
+        return 0;
+    }
+    else {
+        *peeked_element = arraypointer[readindex];
+        return 1;
+    }
+}
+
+inline size_t YaRB::get(uint8_t *returned_element) {
+    // check for emptyness and validity of output pointer (may  be nullptr)
+    if (this->isEmpty() || !returned_element) {
+        return 0;
+    }
+    else {
+        *returned_element = arraypointer[readindex];
+        readindex = (readindex + 1 == cap) ? 0 : (readindex + 1);
+        return 1;
+    }
+}
+
+inline size_t YaRB::size(void) const {
+    if (writeindex >= readindex) {
+        return writeindex - readindex;
+    }
+    else {
+        return cap - (readindex - writeindex);
+    }
+}
+
+inline size_t YaRB::free(void) const {
+    return this->capacity() - this->size();
+}
+
+inline size_t YaRB::capacity(void) const {
+    return cap-1;
+}
+
+inline bool YaRB::isFull(void) const {
+    return readindex == ((writeindex + 1 == cap) ? 0 : (writeindex + 1));
+}
+
+inline bool YaRB::isEmpty(void) const {
+    return readindex == writeindex;
+}
+
 
 /**
  * @class   YaRBt
  * @brief   Classic ring buffer implementation using a template and two indices.
  * @note    The template parameter specifies the @b effective, i.e. usable 
  *          capacity of the ring buffer. Internally, one additional byte is
- *          allocated.
+ *          allocated, unless CAPACITY is a power of two. For power-of-two
+ *          capacities, free-running indices with a bit mask are used
+ *          instead (see yarb_index.h).
+ * @note    The second template parameter T is the element type (default:
+ *          uint8_t, i.e. a byte buffer implementing IYaRB). Any default
+ *          constructible, copy assignable type can be used. Blocks of
+ *          trivially copyable types are copied with memcpy(), other types
+ *          are copied element by element, and moved out by get().
+ * @note    If the third template parameter OVERWRITE is true, put() never
+ *          fails: when the ring buffer is full, the oldest elements are
+ *          dropped to make room for the new ones.
+ * @note    The fourth template parameter INDEX is the type of the indices,
+ *          by default the smallest unsigned type which can hold them (e.g.
+ *          uint8_t for CAPACITY up to 128, see yarb_index.h). limit() 
+ *          depends on it.
  * @warning This class is @b not interrupt-safe, even with only a single
  *          interrupt priority (as on AVR Arduinos) and when only adding 
  *          to it in an ISR and removing from it in loop() (or vice versa).
  *          This is due to the fact that the assignment operation for data
  *          type size_t is not atomic on some platforms.
  */
-template <size_t CAPACITY = 63> 
-class YaRBt : public IYaRB {
+template <size_t CAPACITY = 63, typename T = uint8_t, bool OVERWRITE = false,
+          typename INDEX = typename YaRBIndexType<yarb_index_maxval(CAPACITY)>::type>
+class YaRBt final : public IYaRBt<T> {
     public:
         // sanity checking
         static_assert(CAPACITY > 0, "not allowed to instantiate template with CAPACITY=0");
@@ -124,24 +227,31 @@ class YaRBt : public IYaRB {
         virtual ~YaRBt(void) = default;
         
         // allow assignments for templated version, as CAPACITY is constant
-        YaRBt<CAPACITY>& operator= (const YaRBt<CAPACITY> &rb);
+        YaRBt<CAPACITY, T, OVERWRITE, INDEX>& operator= (const YaRBt<CAPACITY, T, OVERWRITE, INDEX> &rb);
 
         // put element(s) into ring buffer
-        size_t put(uint8_t new_element) override;
-        size_t put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) override;
+        size_t put(T new_element) override;
+        size_t put(const T *new_elements, size_t nbr_elements, bool only_complete) override;
 
         // get/remove element(s) from ring buffer
-        size_t get(uint8_t *returned_element) override;
-        size_t get(uint8_t *returned_elements, size_t nbr_elements) override;
+        size_t get(T *returned_element) override;
+        size_t get(T *returned_elements, size_t nbr_elements) override;
         
-        // look at next element in ring buffer
-        // note: there is no multi-byte-version!
-        size_t peek(uint8_t *peeked_element) const override; 
+        // look at element(s) in ring buffer without removing them
+        size_t peek(T *peeked_element) const override; 
+        size_t peek(T *peeked_element, size_t offset) const override;
+        size_t peek(T *peeked_elements, size_t nbr_elements, size_t offset) const override;
         
         // discard some elements from ring buffer, 
         // return number of discarded elements
         size_t discard(size_t nbr_elements) override;
 
+        // zero-copy access to the internal array
+        size_t writeReserve(T **region) override;
+        size_t commit(size_t nbr_elements) override;
+        size_t readSpan(const T **region) const override;
+        size_t consume(size_t nbr_elements) override;
+
         size_t size(void) const override;     // return number of slots in use
         size_t free(void) const override;     // return number of free slots
         size_t capacity(void) const override; // return total number of slots
@@ -154,9 +264,11 @@ class YaRBt : public IYaRB {
         static size_t limit(void);   // return maximum possible number of elements on a given platform
 
     private:
-        size_t  readindex;           ///< index for get()
-        size_t  writeindex;          ///< index for put()
-        uint8_t arr[CAPACITY+1];       ///< array which holds the elements
+        typedef YaRBIndex<CAPACITY, yarb_is_pow2(CAPACITY), INDEX> idx; ///< index arithmetic, selected by CAPACITY
+        
+        INDEX   readindex;           ///< index for get()
+        INDEX   writeindex;          ///< index for put()
+        T       arr[idx::slots];     ///< array which holds the elements
 };
 
 // include imlementation file for template here
@@ -177,19 +289,23 @@ class YaRBt : public IYaRB {
  *          This is due to the fact that the assignment operation for data
  *          type size_t is not atomic on some platforms.
  */
-class YaRB2 : public IYaRB {
+class YaRB2 final : public IYaRB {
     public:
-        // constructor
+        // constructors
         YaRB2(size_t capacity=63);
+        YaRB2(uint8_t *storage, size_t storage_size); // caller-owned storage
+        YaRB2(YaRBPool &pool);                        // storage from a pool
         
-        // copy constructor
+        // copy and move constructors
         YaRB2(const YaRB2 &rb);
+        YaRB2(YaRB2 &&rb);
         
         // destructor
         virtual ~YaRB2(void);
         
-        // do not allow assignments
-        YaRB2& operator= (const YaRB2 &rb) = delete;
+        // assignment and move assignment, see YaRB
+        YaRB2& operator= (const YaRB2 &rb);
+        YaRB2& operator= (YaRB2 &&rb);
 
         // put element(s) into ring buffer
         size_t put(uint8_t new_element) override;
@@ -199,14 +315,21 @@ class YaRB2 : public IYaRB {
         size_t get(uint8_t *returned_element) override;
         size_t get(uint8_t *returned_elements, size_t nbr_elements) override;
         
-        // look at next element in ring buffer
-        // note: there is no multi-byte-version!
+        // look at element(s) in ring buffer without removing them
         size_t peek(uint8_t *peeked_element) const override; 
+        size_t peek(uint8_t *peeked_element, size_t offset) const override;
+        size_t peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const override;
         
         // discard some elements from ring buffer, 
         // return number of discarded elements
         size_t discard(size_t nbr_elements) override;
 
+        // zero-copy access to the internal array
+        size_t writeReserve(uint8_t **region) override;
+        size_t commit(size_t nbr_elements) override;
+        size_t readSpan(const uint8_t **region) const override;
+        size_t consume(size_t nbr_elements) override;
+
         size_t size(void) const override;     // return number of slots in use
         size_t free(void) const override;     // return number of free slots
         size_t capacity(void) const override; // return total number of slots
@@ -217,17 +340,117 @@ class YaRB2 : public IYaRB {
         
         // no override for static functions...
         static size_t limit(void);   // return maximum possible number of elements on a given platform
+        static size_t storageSize(size_t capacity); // return storage size in bytes needed for capacity
 
     private:
-        const size_t  cap;     ///< store capacity of ring buffer
+        size_t  cap;           ///< store capacity of ring buffer
         size_t  readindex;     ///< index for get()
         size_t  writeindex;    ///< index for put()
         uint8_t *arraypointer; ///< pointer to array which holds the elements
+        bool    own;           ///< array was allocated by this instance
+        YaRBPool *pool;        ///< pool the array belongs to, may be nullptr
+
+        // helper functions for copying and moving
+        void   copyElements(const YaRB2 &rb);
+        void   freeArray(void);
+        void   forgetArray(void);
         
         size_t  modcap(size_t val) const;
-        size_t  modcap2(size_t val) const;
+        size_t  advance(size_t val, size_t nbr_elements) const;
 };
 
+// inline definitions of the functions on the hot path
+
+inline size_t YaRB2::modcap(size_t val) const {
+    // val is an index, i.e. smaller than 2*cap: no division needed
+    return (val >= cap) ? (val - cap) : val;
+}
+
+/**
+ * @brief   Advance an index by a number of elements.
+ * @details Due to danger of integer overflow, we cannot just do
+ *          (val + nbr_elements) % (2*cap): val + nbr_elements *might* be
+ *          larger than SIZE_MAX, which would then overflow, giving wrong
+ *          results. --> Do modulus calculation "manually".
+ * @param   val
+ *          Index to advance, must be smaller than 2*cap.
+ * @param   nbr_elements
+ *          Number of elements to advance the index by, must not be larger
+ *          than cap.
+ * @return  New value of the index.
+ */
+inline size_t YaRB2::advance(size_t val, size_t nbr_elements) const {
+    // The difference between val and 2*cap is always > 0 (i.e. at least 1)
+    const size_t diff_to_max = 2*cap - val;
+    if (diff_to_max <= nbr_elements) { // val+nbr_elements >= 2*cap --> wrap
+        return nbr_elements - diff_to_max;
+    }
+    else { // adding nbr_elements to val stays in correct range
+        return val + nbr_elements;
+    }
+}
+
+inline size_t YaRB2::put(uint8_t new_element) {
+    if (this->isFull()) {
+        return 0;
+    }
+    else {
+        arraypointer[modcap(writeindex)] = new_element;
+        writeindex = advance(writeindex, 1);
+        return 1;
+    }
+}
+
+inline size_t YaRB2::peek(uint8_t *peeked_element) const {
+    // check for emptyness and validity of output pointer (may be nullptr)
+    if (this->isEmpty() || !peeked_element) {
+        return 0;
+    }
+    else {
+        *peeked_element = arraypointer[modcap(readindex)];
+        return 1;
+    }
+}
+
+inline size_t YaRB2::get(uint8_t *returned_element) {
+    // check for emptyness and validity of output pointer (may  be nullptr)
+    if (this->isEmpty() || !returned_element) {
+        return 0;
+    }
+    else {
+        *returned_element = arraypointer[modcap(readindex)];
+        readindex = advance(readindex, 1);
+        return 1;
+    }
+}
+
+inline size_t YaRB2::size(void) const {
+    // Note: (writeindex-readindex) % (2*cap) would only give correct results
+    // when 2*cap is a power of two.
+    if (writeindex >= readindex) {
+        return writeindex - readindex;
+    }
+    else {
+        return 2*cap - (readindex - writeindex);
+    }
+}
+
+inline size_t YaRB2::free(void) const {
+    return cap - this->size();
+}
+
+inline size_t YaRB2::capacity(void) const {
+    return cap;
+}
+
+inline bool YaRB2::isFull(void) const {
+    return this->size() == cap;
+}
+
+inline bool YaRB2::isEmpty(void) const {
+    return readindex == writeindex;
+}
+
 /**
  * @class   YaRB2t
  * @brief   Alternative ring buffer implementation using a template and two indices.
@@ -237,15 +460,27 @@ class YaRB2 : public IYaRB {
  *          inspired by this article and the discussion in the comments:
  *          https://www.snellman.net/blog/archive/2016-12-13-ring-buffers/
  * @note    The template parameter specifies the @b effective, i.e. usable 
- *          capacity of the ring buffer.
+ *          capacity of the ring buffer. For power-of-two capacities, 
+ *          free-running indices with a bit mask are used instead of
+ *          calculating modulo 2*CAPACITY (see yarb_index.h).
+ * @note    The second template parameter T is the element type (default:
+ *          uint8_t, i.e. a byte buffer implementing IYaRB). Any default
+ *          constructible, copy assignable type can be used. Blocks of
+ *          trivially copyable types are copied with memcpy(), other types
+ *          are copied element by element, and moved out by get().
+ * @note    The third template parameter INDEX is the type of the indices,
+ *          by default the smallest unsigned type which can hold them (e.g.
+ *          uint8_t for CAPACITY up to 128, see yarb_index.h). limit() 
+ *          depends on it.
  * @warning This class is @b not interrupt-safe, even with only a single
  *          interrupt priority (as on AVR Arduinos) and when only adding 
  *          to it in an ISR and removing from it in loop() (or vice versa).
  *          This is due to the fact that the assignment operation for data
  *          type size_t is not atomic on some platforms.
  */
-template <size_t CAPACITY = 64>
-class YaRB2t : public IYaRB {
+template <size_t CAPACITY = 64, typename T = uint8_t,
+          typename INDEX = typename YaRBIndexType<yarb2_index_maxval(CAPACITY)>::type>
+class YaRB2t final : public IYaRBt<T> {
     public:
         // sanity checking
         static_assert(CAPACITY > 0, "not allowed to instantiate template with CAPACITY=0");
@@ -260,24 +495,31 @@ class YaRB2t : public IYaRB {
         virtual ~YaRB2t(void) = default;
         
         // allow assignments for templated version, as CAPACITY is constant
-        YaRB2t& operator= (const YaRB2t<CAPACITY> &rb);
+        YaRB2t& operator= (const YaRB2t<CAPACITY, T, INDEX> &rb);
 
         // put element(s) into ring buffer
-        size_t put(uint8_t new_element) override;
-        size_t put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) override;
+        size_t put(T new_element) override;
+        size_t put(const T *new_elements, size_t nbr_elements, bool only_complete) override;
 
         // get/remove element(s) from ring buffer
-        size_t get(uint8_t *returned_element) override;
-        size_t get(uint8_t *returned_elements, size_t nbr_elements) override;
+        size_t get(T *returned_element) override;
+        size_t get(T *returned_elements, size_t nbr_elements) override;
         
-        // look at next element in ring buffer
-        // note: there is no multi-byte-version!
-        size_t peek(uint8_t *peeked_element) const override; 
+        // look at element(s) in ring buffer without removing them
+        size_t peek(T *peeked_element) const override; 
+        size_t peek(T *peeked_element, size_t offset) const override;
+        size_t peek(T *peeked_elements, size_t nbr_elements, size_t offset) const override;
         
         // discard some elements from ring buffer, 
         // return number of discarded elements
         size_t discard(size_t nbr_elements) override;
 
+        // zero-copy access to the internal array
+        size_t writeReserve(T **region) override;
+        size_t commit(size_t nbr_elements) override;
+        size_t readSpan(const T **region) const override;
+        size_t consume(size_t nbr_elements) override;
+
         size_t size(void) const override;     // return number of slots in use
         size_t free(void) const override;     // return number of free slots
         size_t capacity(void) const override; // return total number of slots
@@ -290,12 +532,11 @@ class YaRB2t : public IYaRB {
         static size_t limit(void);   // return maximum possible number of elements on a given platform
 
     private:
-        size_t  readindex;           ///< index for get()
-        size_t  writeindex;          ///< index for put()
-        uint8_t arr[CAPACITY];       ///< array which holds the elements
+        typedef YaRB2Index<CAPACITY, yarb_is_pow2(CAPACITY), INDEX> idx; ///< index arithmetic, selected by CAPACITY
         
-        size_t  modcap(size_t val) const;
-        size_t  modcap2(size_t val) const;
+        INDEX   readindex;           ///< index for get()
+        INDEX   writeindex;          ///< index for put()
+        T       arr[idx::slots];     ///< array which holds the elements
 };
 
 // include imlementation file for template here
@@ -29,27 +29,34 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  * SOFTWARE.
  */
- 
-#include <string.h>  // memcpy(), for copy constructor
+
+
+/*
+ * Note:
+ * All index calculations are done by the helper class idx (see yarb_index.h).
+ * For power-of-two capacities, the indices are free-running and the array
+ * position is calculated with a bit mask. Otherwise, the indices are
+ * calculated modulo 2*CAPACITY.
+ */
 
 /**
  * @brief   The constructor.
  * @details There is only a parameterless constructor. Size is given as
  *          template parameter.
  */
-template <size_t CAPACITY>
-YaRB2t<CAPACITY>::YaRB2t(void) 
-    : readindex{0}, writeindex{0}, arr{0} {}
+template <size_t CAPACITY, typename T, typename INDEX>
+YaRB2t<CAPACITY, T, INDEX>::YaRB2t(void) 
+    : readindex{0}, writeindex{0} {}
 
 /**
  * @brief   The copy constructor.
  * @param   rb
  *          Reference to class instance to copy.
  */
-template <size_t CAPACITY>
-YaRB2t<CAPACITY>::YaRB2t(const YaRB2t<CAPACITY> &rb)
-    : readindex{rb.readindex}, writeindex{rb.writeindex}, arr{0} {
-    memcpy(arr, &(rb.arr), (CAPACITY * sizeof(uint8_t)) );        
+template <size_t CAPACITY, typename T, typename INDEX>
+YaRB2t<CAPACITY, T, INDEX>::YaRB2t(const YaRB2t<CAPACITY, T, INDEX> &rb)
+    : readindex{rb.readindex}, writeindex{rb.writeindex} {
+    YaRBCopy<T>::copy(arr, rb.arr, idx::slots);        
 }
 
 /**
@@ -59,45 +66,46 @@ YaRB2t<CAPACITY>::YaRB2t(const YaRB2t<CAPACITY> &rb)
  * @note    This works because both operands are guaranteed to be of 
  *          same capacity when using a template.
  */
-template <size_t CAPACITY>
-YaRB2t<CAPACITY>& YaRB2t<CAPACITY>::operator=(const YaRB2t<CAPACITY> &rb) {
+template <size_t CAPACITY, typename T, typename INDEX>
+YaRB2t<CAPACITY, T, INDEX>& YaRB2t<CAPACITY, T, INDEX>::operator=(const YaRB2t<CAPACITY, T, INDEX> &rb) {
     // protect against self-assignment
     if (this == &rb) return *this;
     // copy indices verbatim
     readindex = rb.readindex;
     writeindex = rb.writeindex;
-    const size_t r = modcap(readindex);
-    const size_t w = modcap(writeindex);
-    // Copy content depending of relative position of indices.
-    // case 1: writeindex has not yet wrapped
-    // --> copy size() bytes of data, starting from readindex
-    if (r <= w) { 
-        memcpy(arr+r, rb.arr+r, rb.size());
-    }
+    // Copy size() bytes of content, starting from readindex.
+    // case 1: data does not wrap around
+    // --> copy in one go
     // case 2: writeindex has already wrapped around, readindex not yet
     // --> copy from readindex to end of array
     // --> copy from start of array to writeindex-1
+    const size_t r = idx::pos(readindex);
+    const size_t n = rb.size();
+    const size_t diff_to_end = idx::slots - r;
+    if (n <= diff_to_end) { 
+        YaRBCopy<T>::copy(arr+r, rb.arr+r, n);
+    }
     else {
-        memcpy(arr+r, rb.arr+r, CAPACITY-r);
-        memcpy(arr, rb.arr, w);
+        YaRBCopy<T>::copy(arr+r, rb.arr+r, diff_to_end);
+        YaRBCopy<T>::copy(arr, rb.arr, n-diff_to_end);
     }
     return *this;        
 }
 
-template <size_t CAPACITY>
-size_t YaRB2t<CAPACITY>::put(uint8_t new_element) {
+template <size_t CAPACITY, typename T, typename INDEX>
+size_t YaRB2t<CAPACITY, T, INDEX>::put(T new_element) {
     if (this->isFull()) {
         return 0;
     }
     else {
-        arr[modcap(writeindex)] = new_element;
-        writeindex = modcap2(writeindex+1);
+        arr[idx::pos(writeindex)] = static_cast<T&&>(new_element);
+        writeindex = idx::next(writeindex);
         return 1;
     }
 }
 
-template <size_t CAPACITY>
-size_t YaRB2t<CAPACITY>::put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) {
+template <size_t CAPACITY, typename T, typename INDEX>
+size_t YaRB2t<CAPACITY, T, INDEX>::put(const T *new_elements, size_t nbr_elements, bool only_complete) {
     // check validity of input pointer (may be nullptr)
     if (!new_elements ) {
         return 0;
@@ -107,48 +115,84 @@ size_t YaRB2t<CAPACITY>::put(const uint8_t *new_elements, size_t nbr_elements, b
         if (only_complete) return 0;
         nbr_elements = this->free();
     }
-    for (size_t i=0; i<nbr_elements; i++) {
-          // re-implementation is about 3-4 times faster than calling
-          // single-element put()
-          arr[modcap(writeindex)] = *new_elements;
-          writeindex = modcap2(writeindex+1);
-          new_elements++;
+    // copy in at most two segments: 
+    // from writeindex to end of array, then from start of array
+    const size_t w = idx::pos(writeindex);
+    const size_t diff_to_end = idx::slots - w;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        YaRBCopy<T>::copy(arr+w, new_elements, nbr_elements);
+    }
+    else {
+        YaRBCopy<T>::copy(arr+w, new_elements, diff_to_end);
+        YaRBCopy<T>::copy(arr, new_elements+diff_to_end, nbr_elements-diff_to_end);
     }
+    writeindex = idx::advance(writeindex, nbr_elements);
     return nbr_elements;
-
 }
 
-template <size_t CAPACITY>
-size_t YaRB2t<CAPACITY>::peek(uint8_t *peeked_element) const {
+template <size_t CAPACITY, typename T, typename INDEX>
+size_t YaRB2t<CAPACITY, T, INDEX>::peek(T *peeked_element) const {
     // check for emptyness and validity of output pointer (may be nullptr)
     if (this->isEmpty() || !peeked_element) {
         return 0;
     }
     else {
-        *peeked_element = arr[modcap(readindex)];
+        *peeked_element = arr[idx::pos(readindex)];
+        return 1;
+    }
+}
+
+template <size_t CAPACITY, typename T, typename INDEX>
+size_t YaRB2t<CAPACITY, T, INDEX>::peek(T *peeked_element, size_t offset) const {
+    // check for enough elements and validity of output pointer (may be nullptr)
+    if (offset >= this->size() || !peeked_element) {
+        return 0;
+    }
+    else {
+        // do modulus calculation "manually" (see discard())
+        const size_t r = idx::pos(readindex);
+        const size_t diff_to_end = idx::slots - r;
+        *peeked_element = arr[(offset < diff_to_end) ? (r + offset) : (offset - diff_to_end)];
         return 1;
     }
 }
 
-template <size_t CAPACITY>
-size_t YaRB2t<CAPACITY>::discard(size_t nbr_elements) {
+template <size_t CAPACITY, typename T, typename INDEX>
+size_t YaRB2t<CAPACITY, T, INDEX>::peek(T *peeked_elements, size_t nbr_elements, size_t offset) const {
+    // check for nullptr
+    if (!peeked_elements) {
+        return 0;
+    }
+    // only peek at most the size()-offset elements after offset
+    const size_t used = this->size();
+    if (offset >= used) {
+        return 0;
+    }
+    if (nbr_elements > used - offset) {
+        nbr_elements = used - offset;
+    }
+    // first element to peek at, see peek(peeked_element, offset)
+    const size_t r = idx::pos(readindex);
+    const size_t diff = idx::slots - r;
+    const size_t start = (offset < diff) ? (r + offset) : (offset - diff);
+    // copy out in at most two segments, exactly like get(), but leave
+    // readindex unchanged
+    const size_t diff_to_end = idx::slots - start;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        YaRBCopy<T>::copy(peeked_elements, arr+start, nbr_elements);
+    }
+    else {
+        YaRBCopy<T>::copy(peeked_elements, arr+start, diff_to_end);
+        YaRBCopy<T>::copy(peeked_elements+diff_to_end, arr, nbr_elements-diff_to_end);
+    }
+    return nbr_elements;
+}
+
+template <size_t CAPACITY, typename T, typename INDEX>
+size_t YaRB2t<CAPACITY, T, INDEX>::discard(size_t nbr_elements) {
     if (this->size() > nbr_elements) { // there will be remaining elements in buffer
-        // Due to danger of integer overflow, we cannot just do
-        // readindex = modcap2(readindex + nbr_elements):
-        // readindex + nbr_elements *might* be larger than SIZE_MAX, which
-        // would then overflow, giving wrong results after modcap2.
-        // --> Do modulus calculation "manually".
-        //
-        // The difference between current readindex is always > 0 (i.e. at least 1)
-        size_t diff_to_max = 2*CAPACITY - readindex;
-        if (diff_to_max <= nbr_elements) { // readindex+nbr_elements > 2*cap --> danger of overflow
-            readindex = nbr_elements - diff_to_max;
-        }
-        else { // adding nbr_elements to readindex stays in correct range
-            // no need for modcap2(), adding nbr_elements keeps readindex
-            // below 2*cap
-            readindex = readindex + nbr_elements;
-        }
+        // idx::advance() takes care of integer overflow
+        readindex = idx::advance(readindex, nbr_elements);
         // return nbr_elements, no matter if we had to wrap around or not
         return nbr_elements;
     }
@@ -161,22 +205,67 @@ size_t YaRB2t<CAPACITY>::discard(size_t nbr_elements) {
     }
 }
 
-template <size_t CAPACITY>
-size_t YaRB2t<CAPACITY>::get(uint8_t *returned_element) {
+template <size_t CAPACITY, typename T, typename INDEX>
+size_t YaRB2t<CAPACITY, T, INDEX>::writeReserve(T **region) {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
+        return 0;
+    }
+    const size_t w = idx::pos(writeindex);
+    *region = arr+w;
+    // the free region ends at the end of the array at the latest
+    const size_t diff_to_end = idx::slots - w;
+    const size_t free_slots = this->free();
+    return (free_slots < diff_to_end) ? free_slots : diff_to_end;
+}
+
+template <size_t CAPACITY, typename T, typename INDEX>
+size_t YaRB2t<CAPACITY, T, INDEX>::commit(size_t nbr_elements) {
+    // only commit at most the region writeReserve() reports
+    T *region;
+    const size_t reserved = this->writeReserve(&region);
+    if (nbr_elements > reserved) {
+        nbr_elements = reserved;
+    }
+    writeindex = idx::advance(writeindex, nbr_elements);
+    return nbr_elements;
+}
+
+template <size_t CAPACITY, typename T, typename INDEX>
+size_t YaRB2t<CAPACITY, T, INDEX>::readSpan(const T **region) const {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
+        return 0;
+    }
+    const size_t r = idx::pos(readindex);
+    *region = arr+r;
+    // the stored region ends at the end of the array at the latest
+    const size_t diff_to_end = idx::slots - r;
+    const size_t used = this->size();
+    return (used < diff_to_end) ? used : diff_to_end;
+}
+
+template <size_t CAPACITY, typename T, typename INDEX>
+size_t YaRB2t<CAPACITY, T, INDEX>::consume(size_t nbr_elements) {
+    return this->discard(nbr_elements);
+}
+
+template <size_t CAPACITY, typename T, typename INDEX>
+size_t YaRB2t<CAPACITY, T, INDEX>::get(T *returned_element) {
     // check for emptyness and validity of output pointer (may  be nullptr)
     if (this->isEmpty() || !returned_element) {
         return 0;
     }
     else {
-        *returned_element = arr[modcap(readindex)];
-        readindex = modcap2(readindex+1);
+        *returned_element = static_cast<T&&>(arr[idx::pos(readindex)]);
+        readindex = idx::next(readindex);
         return 1;
     }
 }
 
-template <size_t CAPACITY>
-size_t YaRB2t<CAPACITY>::get(uint8_t *returned_elements, size_t nbr_elements) {
-    // check nullptr
+template <size_t CAPACITY, typename T, typename INDEX>
+size_t YaRB2t<CAPACITY, T, INDEX>::get(T *returned_elements, size_t nbr_elements) {
+    // check for nullptr
     if (!returned_elements) {
         return 0;
     }
@@ -185,59 +274,54 @@ size_t YaRB2t<CAPACITY>::get(uint8_t *returned_elements, size_t nbr_elements) {
         if (nbr_elements > this->size()) {
             nbr_elements = this->size();
         }
-        for (size_t i=0; i<nbr_elements; i++) {
-            // re-implementation is about 2 times faster than calling
-            // single-element get()        
-            *returned_elements = arr[modcap(readindex)];
-            readindex = modcap2(readindex+1);
-            returned_elements++;
+        // copy out in at most two segments:
+        // from readindex to end of array, then from start of array
+        const size_t r = idx::pos(readindex);
+        const size_t diff_to_end = idx::slots - r;
+        if (nbr_elements <= diff_to_end) { // does not wrap
+            YaRBCopy<T>::move(returned_elements, arr+r, nbr_elements);
         }
+        else {
+            YaRBCopy<T>::move(returned_elements, arr+r, diff_to_end);
+            YaRBCopy<T>::move(returned_elements+diff_to_end, arr, nbr_elements-diff_to_end);
+        }
+        readindex = idx::advance(readindex, nbr_elements);
         return nbr_elements;
     }
 }
-
-template <size_t CAPACITY>
-size_t YaRB2t<CAPACITY>::size(void) const {
-    return modcap2(writeindex-readindex);
+        
+template <size_t CAPACITY, typename T, typename INDEX>
+size_t YaRB2t<CAPACITY, T, INDEX>::size(void) const {
+    return idx::used(readindex, writeindex);
 }
 
-template <size_t CAPACITY>
-size_t YaRB2t<CAPACITY>::free(void) const {
-    return CAPACITY - this->size();
+template <size_t CAPACITY, typename T, typename INDEX>
+size_t YaRB2t<CAPACITY, T, INDEX>::free(void) const {
+    return this->capacity() - this->size();
 }
 
-template <size_t CAPACITY>
-size_t YaRB2t<CAPACITY>::capacity(void) const {
+template <size_t CAPACITY, typename T, typename INDEX>
+size_t YaRB2t<CAPACITY, T, INDEX>::capacity(void) const {
     return CAPACITY;
 }
 
-template <size_t CAPACITY>
-bool YaRB2t<CAPACITY>::isFull(void) const {
-    return this->size() == CAPACITY;
+template <size_t CAPACITY, typename T, typename INDEX>
+bool YaRB2t<CAPACITY, T, INDEX>::isFull(void) const {
+    return idx::full(readindex, writeindex);
 }
 
-template <size_t CAPACITY>
-bool YaRB2t<CAPACITY>::isEmpty(void) const {
+template <size_t CAPACITY, typename T, typename INDEX>
+bool YaRB2t<CAPACITY, T, INDEX>::isEmpty(void) const {
     return readindex == writeindex;
 }
 
-template <size_t CAPACITY>
-void YaRB2t<CAPACITY>::flush(void) {
+template <size_t CAPACITY, typename T, typename INDEX>
+void YaRB2t<CAPACITY, T, INDEX>::flush(void) {
     // fast-forward readindex to position of writeindex
     readindex = writeindex;
 }
 
-template <size_t CAPACITY>
-size_t YaRB2t<CAPACITY>::limit(void) {
-    return SIZE_MAX / 2;
-}
-
-template <size_t CAPACITY>
-inline size_t YaRB2t<CAPACITY>::modcap(size_t val) const {
-    return (val % CAPACITY);
-}
-
-template <size_t CAPACITY>
-inline size_t YaRB2t<CAPACITY>::modcap2(size_t val) const {
-    return (val % (2 * CAPACITY));
+template <size_t CAPACITY, typename T, typename INDEX>
+size_t YaRB2t<CAPACITY, T, INDEX>::limit(void) {
+    return idx::max_capacity;
 }
@@ -0,0 +1,183 @@
+/**
+ * @file    yarb_atomic.h
+ * @brief   Helper functions for atomic index access in interrupt-safe ring buffers
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarb_atomic_h License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef yarb_atomic_h
+#define yarb_atomic_h
+
+#include <stddef.h> // needed for size_t data type
+#include <stdint.h> // needed for uint8_t data type
+
+#if defined(__AVR__)
+#include <avr/io.h>        // SREG
+#include <avr/interrupt.h> // cli()
+#endif
+
+/*
+ * Note:
+ * The interrupt-safe ring buffers need exactly two primitives: reading
+ * the index owned by the other side with acquire semantics and publishing
+ * the own index with release semantics. Both are provided here for any
+ * integral index type. The DMA-fed ring buffer (YaRBdt) only needs a 
+ * fence after reading the hardware's position.
+ *
+ * The multi-producer/multi-consumer ring buffer (YaRBmt) additionally 
+ * needs compare-and-swap and a hint for busy-waiting loops. These are not
+ * available on AVR: it is single-core, use YaRBlt there. ARMv6-M 
+ * (Cortex-M0/M0+) has no exclusive load/store either: the compiler calls
+ * library functions for compare-and-swap, which only some cores or SDKs
+ * provide (e.g. the RP2040 SDK, using a hardware spinlock). Define
+ * YARB_ARMV6M_ATOMICS before including the library to use YaRBmt there.
+ *
+ * On ARM and on hosts, the GCC/Clang __atomic builtins are used. They
+ * compile to a plain load/store plus the necessary memory barrier.
+ *
+ * AVR does not have any atomic multi-byte load or store instructions and
+ * avr-gcc does not support the __atomic builtins for them. For index
+ * types wider than a single byte, the load/store itself (and nothing more)
+ * is executed with interrupts disabled. This is a window of only a few
+ * CPU cycles. Single-byte index types need no such protection.
+ */
+
+/**
+ * @brief   Read an index written by the other side of a ring buffer.
+ * @details All writes to the ring buffer's array made by the other side
+ *          before publishing the index are visible after this call.
+ * @param   index
+ *          Pointer to the index to read.
+ * @return  Current value of the index.
+ */
+template <typename T>
+inline T yarb_load_acquire(const T *index) {
+#if defined(__AVR__)
+    if (sizeof(T) == 1) {
+        T val = *static_cast<const volatile T*>(index);
+        __asm__ __volatile__ ("" ::: "memory");
+        return val;
+    }
+    const uint8_t sreg = SREG;
+    cli();
+    T val = *static_cast<const volatile T*>(index);
+    SREG = sreg;
+    __asm__ __volatile__ ("" ::: "memory");
+    return val;
+#else
+    return __atomic_load_n(index, __ATOMIC_ACQUIRE);
+#endif
+}
+
+/**
+ * @brief   Publish an index to the other side of a ring buffer.
+ * @details All writes to the ring buffer's array made before this call
+ *          are visible to the other side once it reads the new index.
+ * @param   index
+ *          Pointer to the index to write.
+ * @param   val
+ *          New value of the index.
+ */
+template <typename T>
+inline void yarb_store_release(T *index, T val) {
+#if defined(__AVR__)
+    __asm__ __volatile__ ("" ::: "memory");
+    if (sizeof(T) == 1) {
+        *static_cast<volatile T*>(index) = val;
+        return;
+    }
+    const uint8_t sreg = SREG;
+    cli();
+    *static_cast<volatile T*>(index) = val;
+    SREG = sreg;
+#else
+    __atomic_store_n(index, val, __ATOMIC_RELEASE);
+#endif
+}
+
+/**
+ * @brief   Make memory written by hardware (DMA) visible.
+ * @details Reads of the array after this call see all data the hardware
+ *          wrote before the position register was read. The compiler
+ *          must not use any values of the array read earlier.
+ */
+inline void yarb_fence_acquire(void) {
+#if defined(__AVR__)
+    __asm__ __volatile__ ("" ::: "memory");
+#else
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+#endif
+}
+
+#if !defined(__AVR__) && (!defined(__ARM_ARCH_6M__) || defined(YARB_ARMV6M_ATOMICS))
+#define YARB_HAS_CAS 1
+
+/**
+ * @brief   Read an index without any ordering guarantees.
+ * @param   index
+ *          Pointer to the index to read.
+ * @return  Current value of the index.
+ */
+template <typename T>
+inline T yarb_load_relaxed(const T *index) {
+    return __atomic_load_n(index, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief   Compare-and-swap an index.
+ * @details If *index equals *expected, desired is stored. Otherwise, the
+ *          current value is stored in *expected. May fail spuriously, so
+ *          call it in a loop.
+ * @param   index
+ *          Pointer to the index.
+ * @param   expected
+ *          Pointer to the value the index is expected to have.
+ * @param   desired
+ *          New value of the index.
+ * @return  @em true if the index was changed.
+ */
+template <typename T>
+inline bool yarb_compare_exchange(T *index, T *expected, T desired) {
+    return __atomic_compare_exchange_n(index, expected, desired, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief   Tell the CPU that we are waiting in a busy loop.
+ */
+inline void yarb_cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || (defined(__ARM_ARCH) && __ARM_ARCH >= 7)
+    __asm__ __volatile__ ("yield" ::: "memory");
+#else
+    __asm__ __volatile__ ("" ::: "memory");
+#endif
+}
+#endif // YARB_HAS_CAS
+
+#endif // yarb_atomic_h
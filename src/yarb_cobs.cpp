@@ -0,0 +1,159 @@
+/**
+ * @file    yarb_cobs.cpp
+ * @brief   COBS encoding and decoding directly in the array of a ring buffer
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarb_cobs_cpp License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "yarb_cobs.h"
+#include <string.h>  // memcpy(), memchr()
+
+/*
+ * Note:
+ * The groups of a message are copied with memcpy() (delimiter zero) or
+ * with a loop XORing every byte (other delimiters), in at most two 
+ * segments at the end and at the start of the array. Only the code bytes
+ * are handled one at a time.
+ */
+
+// position n bytes after pos, wrapping around the end of the array
+static size_t ring_advance(size_t pos, size_t n, size_t slots) {
+    const size_t diff_to_end = slots - pos;
+    return (n >= diff_to_end) ? (n - diff_to_end) : (pos + n);
+}
+
+// copy n bytes into the array, XORed with x
+static void ring_write(uint8_t *arr, size_t slots, size_t pos, const uint8_t *src, size_t n, uint8_t x) {
+    const size_t diff_to_end = slots - pos;
+    const size_t first = (n <= diff_to_end) ? n : diff_to_end;
+    if (x == 0) {
+        memcpy(arr+pos, src, first);
+        memcpy(arr, src+first, n-first);
+    }
+    else {
+        for (size_t i=0; i<first; i++) arr[pos+i] = src[i] ^ x;
+        for (size_t i=first; i<n; i++) arr[i-first] = src[i] ^ x;
+    }
+}
+
+// copy n bytes out of the array, XORed with x
+static void ring_read(const uint8_t *arr, size_t slots, size_t pos, uint8_t *dst, size_t n, uint8_t x) {
+    const size_t diff_to_end = slots - pos;
+    const size_t first = (n <= diff_to_end) ? n : diff_to_end;
+    if (x == 0) {
+        memcpy(dst, arr+pos, first);
+        memcpy(dst+first, arr, n-first);
+    }
+    else {
+        for (size_t i=0; i<first; i++) dst[i] = arr[pos+i] ^ x;
+        for (size_t i=first; i<n; i++) dst[i] = arr[i-first] ^ x;
+    }
+}
+
+size_t yarb_cobs_encoded_size(const uint8_t *raw, size_t nbr_elements) {
+    // one code byte per group, plus the delimiter
+    size_t len = nbr_elements + 1;
+    size_t i = 0;
+    for (;;) {
+        const size_t rem = nbr_elements - i;
+        const size_t lim = (rem < 254) ? rem : 254;
+        const uint8_t *zero = lim ? static_cast<const uint8_t*>(memchr(raw+i, 0, lim)) : nullptr;
+        const size_t k = zero ? static_cast<size_t>(zero - (raw+i)) : lim;
+        len++;
+        i += k;
+        if (zero) {
+            i++;       // the zero is replaced by the code byte of the next group
+            len--;
+            continue;
+        }
+        if (k == 254 && i < nbr_elements) {
+            continue;  // full group, more bytes follow
+        }
+        return len;
+    }
+}
+
+void yarb_cobs_encode_ring(const uint8_t *raw, size_t nbr_elements, 
+                           uint8_t *arr, size_t slots, size_t pos, uint8_t delimiter) {
+    size_t i = 0;
+    for (;;) {
+        // group: up to 254 bytes before the next zero
+        const size_t rem = nbr_elements - i;
+        const size_t lim = (rem < 254) ? rem : 254;
+        const uint8_t *zero = lim ? static_cast<const uint8_t*>(memchr(raw+i, 0, lim)) : nullptr;
+        const size_t k = zero ? static_cast<size_t>(zero - (raw+i)) : lim;
+        arr[pos] = static_cast<uint8_t>(k + 1) ^ delimiter;
+        pos = ring_advance(pos, 1, slots);
+        ring_write(arr, slots, pos, raw+i, k, delimiter);
+        pos = ring_advance(pos, k, slots);
+        i += k;
+        if (zero) {
+            i++;       // a zero is always followed by another (maybe empty) group
+            continue;
+        }
+        if (k == 254 && i < nbr_elements) {
+            continue;  // full group, more bytes follow
+        }
+        break;
+    }
+    arr[pos] = delimiter;
+}
+
+bool yarb_cobs_decode_ring(const uint8_t *arr, size_t slots, size_t pos, size_t len, uint8_t delimiter,
+                           uint8_t *decoded, size_t nbr_elements, size_t *decoded_length) {
+    // first pass: length of the decoded message, only the code bytes are read
+    size_t out = 0;
+    size_t p = pos;
+    for (size_t i=0; i<len; ) {
+        const uint8_t code = arr[p] ^ delimiter;
+        size_t k = static_cast<size_t>(code) - 1;
+        if (k > len - i - 1) k = len - i - 1; // malformed, decode as far as it goes
+        i += 1 + k;
+        out += k;
+        if (code != 0xFF && i < len) out++;   // the group was followed by a zero
+        p = ring_advance(p, 1 + k, slots);
+    }
+    *decoded_length = out;
+    if (out > nbr_elements) {
+        return false;
+    }
+    // second pass: copy the groups
+    out = 0;
+    p = pos;
+    for (size_t i=0; i<len; ) {
+        const uint8_t code = arr[p] ^ delimiter;
+        size_t k = static_cast<size_t>(code) - 1;
+        if (k > len - i - 1) k = len - i - 1;
+        ring_read(arr, slots, ring_advance(p, 1, slots), decoded+out, k, delimiter);
+        i += 1 + k;
+        out += k;
+        if (code != 0xFF && i < len) decoded[out++] = 0;
+        p = ring_advance(p, 1 + k, slots);
+    }
+    return true;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file    yarb_cobs.h
+ * @brief   COBS encoding and decoding directly in the array of a ring buffer
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarb_cobs_h License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef yarb_cobs_h
+#define yarb_cobs_h
+
+#include <stddef.h> // needed for size_t data type
+#include <stdint.h> // needed for uint8_t data type
+
+/*
+ * Note:
+ * COBS (Consistent Overhead Byte Stuffing) removes all zero bytes from a
+ * message, so a zero byte can be used as delimiter. The message is split
+ * at its zeros into groups of at most 254 bytes, each group is preceded by
+ * a "code" byte: the group's length plus one. 0xFF means "254 bytes, no 
+ * zero follows". See https://github.com/agrommek/cobs/ for details.
+ *
+ * For a delimiter other than zero, every encoded byte is additionally 
+ * XORed with the delimiter. So the encoded message never contains the
+ * delimiter, and for the usual delimiter zero nothing changes.
+ *
+ * The ring versions are used by YaRBc and YaRBct to encode into and
+ * decode from their array without an intermediate buffer. A position
+ * (pos) is an index into an array of slots bytes, a range starting at 
+ * pos may wrap around the end of the array.
+ */
+
+/**
+ * @brief   Calculate the length of a COBS-encoded message.
+ * @param   raw
+ *          Pointer to the message.
+ * @param   nbr_elements
+ *          Length of the message.
+ * @return  Length of the encoded message, including the delimiter.
+ */
+size_t yarb_cobs_encoded_size(const uint8_t *raw, size_t nbr_elements);
+
+/**
+ * @brief   COBS-encode a message into the array of a ring buffer.
+ * @details Exactly yarb_cobs_encoded_size() bytes are written, the last
+ *          one is the delimiter. 
+ * @param   raw
+ *          Pointer to the message.
+ * @param   nbr_elements
+ *          Length of the message.
+ * @param   arr
+ *          Array of the ring buffer.
+ * @param   slots
+ *          Size of the array.
+ * @param   pos
+ *          Position of the first encoded byte.
+ * @param   delimiter
+ *          Delimiter of the ring buffer.
+ */
+void yarb_cobs_encode_ring(const uint8_t *raw, size_t nbr_elements, 
+                           uint8_t *arr, size_t slots, size_t pos, uint8_t delimiter);
+
+/**
+ * @brief   Decode a COBS-encoded message from the array of a ring buffer.
+ * @details The last group of a malformed message (its code points past the
+ *          end) is decoded as far as it goes. Check the integrity of
+ *          messages by other means, e.g. a CRC.
+ * @param   arr
+ *          Array of the ring buffer.
+ * @param   slots
+ *          Size of the array.
+ * @param   pos
+ *          Position of the first encoded byte.
+ * @param   len
+ *          Length of the encoded message, @b without the delimiter.
+ * @param   delimiter
+ *          Delimiter of the ring buffer.
+ * @param   decoded
+ *          Pointer to an array for the decoded message.
+ * @param   nbr_elements
+ *          Size of the array decoded points to.
+ * @param[out] decoded_length
+ *          Pointer to a size_t. The length of the decoded message is
+ *          stored there, even if it does not fit.
+ * @return  @em true if the decoded message fit into decoded, @em false
+ *          otherwise (nothing is written then).
+ */
+bool yarb_cobs_decode_ring(const uint8_t *arr, size_t slots, size_t pos, size_t len, uint8_t delimiter,
+                           uint8_t *decoded, size_t nbr_elements, size_t *decoded_length);
+
+#endif // yarb_cobs_h
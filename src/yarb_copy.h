@@ -0,0 +1,105 @@
+/**
+ * @file    yarb_copy.h
+ * @brief   Helper classes for copying and moving ring buffer elements
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarb_copy_h License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef yarb_copy_h
+#define yarb_copy_h
+
+#include <stddef.h>  // needed for size_t data type
+#include <string.h>  // memcpy()
+
+/*
+ * Note:
+ * Ring buffers of arbitrary element types copy blocks of elements with
+ * these helpers. For trivially copyable types (integers, plain structs),
+ * a block is copied with memcpy(). All other types are copied element by 
+ * element with their copy assignment operator or, when removing elements
+ * from the ring buffer, with their move assignment operator.
+ *
+ * The selection is done at compile time by the template parameter 
+ * TRIVIAL. The compiler builtin __is_trivially_copyable() is used, as
+ * <type_traits> is not available on all Arduino platforms.
+ */
+
+/**
+ * @brief   Copy and move elements of non-trivially copyable types.
+ * @tparam  T
+ *          Element type.
+ * @tparam  TRIVIAL
+ *          Selects the implementation, do not set explicitly.
+ */
+template <typename T, bool TRIVIAL = __is_trivially_copyable(T)>
+struct YaRBCopy {
+    /**
+     * @brief   Copy elements with the copy assignment operator.
+     * @param   dst
+     *          Pointer to the first destination element.
+     * @param   src
+     *          Pointer to the first source element.
+     * @param   nbr_elements
+     *          Number of elements to copy.
+     */
+    static void copy(T *dst, const T *src, size_t nbr_elements) {
+        for (size_t i=0; i<nbr_elements; i++) {
+            dst[i] = src[i];
+        }
+    }
+    /**
+     * @brief   Move elements with the move assignment operator.
+     * @param   dst
+     *          Pointer to the first destination element.
+     * @param   src
+     *          Pointer to the first source element, left in a moved-from
+     *          state.
+     * @param   nbr_elements
+     *          Number of elements to move.
+     */
+    static void move(T *dst, T *src, size_t nbr_elements) {
+        for (size_t i=0; i<nbr_elements; i++) {
+            dst[i] = static_cast<T&&>(src[i]);
+        }
+    }
+};
+
+/**
+ * @brief   Copy and move elements of trivially copyable types with memcpy().
+ */
+template <typename T>
+struct YaRBCopy<T, true> {
+    static void copy(T *dst, const T *src, size_t nbr_elements) {
+        memcpy(dst, src, nbr_elements * sizeof(T));
+    }
+    static void move(T *dst, const T *src, size_t nbr_elements) {
+        memcpy(dst, src, nbr_elements * sizeof(T));
+    }
+};
+
+#endif // yarb_copy_h
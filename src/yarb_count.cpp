@@ -0,0 +1,340 @@
+/**
+ * @file    yarb_count.cpp
+ * @brief   Implementation file for the delimiter counting kernels used by YaRBc, YaRBct and YaRBpt
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarb_count_cpp License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "yarb_count.h"
+
+#if !defined(YARB_COUNT_NO_SIMD) && defined(__SSE2__)
+#define YARB_COUNT_SSE2
+#include <emmintrin.h>
+#elif !defined(YARB_COUNT_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define YARB_COUNT_NEON
+#include <arm_neon.h>
+#elif !defined(__AVR__)
+#define YARB_COUNT_SWAR
+#endif
+
+/*
+ * Note:
+ * The vector versions compare 16 bytes at once. A byte lane of the 
+ * comparison result is 0xFF (i.e. -1) for every match, so subtracting it
+ * from an accumulator adds one per match and lane. To avoid overflow of 
+ * the 8-bit lanes, the accumulator is summed up horizontally after at 
+ * most 255 blocks.
+ *
+ * The word-at-a-time ("SIMD within a register", SWAR) version works on 
+ * size_t words, i.e. 4 bytes on 32-bit ARM (Cortex-M0/M4) and 8 bytes on
+ * 64-bit hosts. Each word is XORed with the value repeated in every byte,
+ * so matching bytes become zero. The exact zero-byte test
+ *     t = ~(((x & 0x7F..7F) + 0x7F..7F) | x) & 0x80..80
+ * sets the high bit of exactly those bytes which are zero (no false 
+ * positives from carries, unlike the shorter (x - 0x01..01) & ~x trick).
+ * The high bits are summed up with a single multiplication.
+ * Reads are done on aligned words only. The unaligned head and the tail 
+ * of the array are handled byte by byte.
+ *
+ * yarb_count_values() is the same, but with one accumulator (or one XOR
+ * pattern) per value: each block is loaded once and compared with every 
+ * value.
+ */
+
+#if defined(YARB_COUNT_SWAR)
+// size_t, but allowed to alias the uint8_t array
+typedef size_t __attribute__((__may_alias__)) yarb_word_t;
+
+static const size_t ones = static_cast<size_t>(-1) / 0xFF;  // 0x01..01
+static const size_t low7 = ones * 0x7F;                       // 0x7F..7F
+static const size_t high = ones * 0x80;                       // 0x80..80
+#endif
+
+/**
+ * @brief   Count bytes with a given value, one byte at a time.
+ * @param   data
+ *          Pointer to the first byte of the (contiguous) array.
+ * @param   nbr_elements
+ *          Number of bytes to examine.
+ * @param   value
+ *          The byte value to count.
+ * @return  Number of bytes in data[0..nbr_elements-1] equal to value.
+ */
+static inline size_t count_bytes(const uint8_t *data, size_t nbr_elements, uint8_t value) {
+    size_t n = 0;
+    for (size_t i=0; i<nbr_elements; i++) {
+        n += (data[i] == value);
+    }
+    return n;
+}
+
+size_t yarb_count(const uint8_t *data, size_t nbr_elements, uint8_t value) {
+#if defined(YARB_COUNT_SSE2)
+    size_t n = 0;
+    const __m128i v = _mm_set1_epi8(static_cast<char>(value));
+    const __m128i zero = _mm_setzero_si128();
+    while (nbr_elements >= 16) {
+        // at most 255 blocks per round, so that 8-bit lanes cannot overflow
+        size_t blocks = nbr_elements / 16;
+        if (blocks > 255) blocks = 255;
+        nbr_elements -= blocks * 16;
+        __m128i acc = zero;
+        for (size_t i=0; i<blocks; i++) {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+            acc = _mm_sub_epi8(acc, _mm_cmpeq_epi8(x, v));
+            data += 16;
+        }
+        // horizontal sum: two 64-bit partial sums
+        const __m128i sums = _mm_sad_epu8(acc, zero);
+        n += static_cast<size_t>(_mm_cvtsi128_si32(sums));
+        n += static_cast<size_t>(_mm_cvtsi128_si32(_mm_unpackhi_epi64(sums, sums)));
+    }
+    return n + count_bytes(data, nbr_elements, value);
+#elif defined(YARB_COUNT_NEON)
+    size_t n = 0;
+    const uint8x16_t v = vdupq_n_u8(value);
+    while (nbr_elements >= 16) {
+        // at most 255 blocks per round, so that 8-bit lanes cannot overflow
+        size_t blocks = nbr_elements / 16;
+        if (blocks > 255) blocks = 255;
+        nbr_elements -= blocks * 16;
+        uint8x16_t acc = vdupq_n_u8(0);
+        for (size_t i=0; i<blocks; i++) {
+            acc = vsubq_u8(acc, vceqq_u8(vld1q_u8(data), v));
+            data += 16;
+        }
+        // horizontal sum by pairwise widening additions
+        const uint64x2_t sums = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(acc)));
+        n += static_cast<size_t>(vgetq_lane_u64(sums, 0) + vgetq_lane_u64(sums, 1));
+    }
+    return n + count_bytes(data, nbr_elements, value);
+#elif defined(YARB_COUNT_SWAR)
+    // handle unaligned head byte by byte
+    size_t head = (sizeof(size_t) - (reinterpret_cast<uintptr_t>(data) % sizeof(size_t))) % sizeof(size_t);
+    if (head > nbr_elements) head = nbr_elements;
+    size_t n = count_bytes(data, head, value);
+    data += head;
+    nbr_elements -= head;
+    // aligned words
+    const size_t pattern = ones * value;
+    const yarb_word_t *words = reinterpret_cast<const yarb_word_t*>(data);
+    const size_t nbr_words = nbr_elements / sizeof(size_t);
+    for (size_t i=0; i<nbr_words; i++) {
+        const size_t x = words[i] ^ pattern;
+        const size_t t = ~(((x & low7) + low7) | x) & high;
+        // (t >> 7) has 0 or 1 in every byte, the multiplication sums up
+        // all bytes into the most significant byte
+        n += ((t >> 7) * ones) >> (8 * (sizeof(size_t) - 1));
+    }
+    data += nbr_words * sizeof(size_t);
+    nbr_elements -= nbr_words * sizeof(size_t);
+    // handle tail byte by byte
+    return n + count_bytes(data, nbr_elements, value);
+#else
+    // 8-bit platforms: nothing to gain from wider operations
+    return count_bytes(data, nbr_elements, value);
+#endif
+}
+
+/**
+ * @brief   Count bytes with several values, one byte at a time.
+ * @param   data
+ *          Pointer to the first byte of the (contiguous) array.
+ * @param   nbr_elements
+ *          Number of bytes to examine.
+ * @param   values
+ *          The byte values to count.
+ * @param   nbr_values
+ *          Number of values.
+ * @param[in,out] counts
+ *          The number of bytes equal to values[j] is added to counts[j].
+ */
+static inline void count_values_bytes(const uint8_t *data, size_t nbr_elements, const uint8_t *values, size_t nbr_values, size_t *counts) {
+    for (size_t i=0; i<nbr_elements; i++) {
+        for (size_t j=0; j<nbr_values; j++) {
+            counts[j] += (data[i] == values[j]);
+        }
+    }
+}
+
+void yarb_count_values(const uint8_t *data, size_t nbr_elements, const uint8_t *values, size_t nbr_values, size_t *counts) {
+    if (nbr_values > YaRBClassSet::max_values) nbr_values = YaRBClassSet::max_values;
+#if defined(YARB_COUNT_SSE2)
+    __m128i v[YaRBClassSet::max_values];
+    __m128i acc[YaRBClassSet::max_values];
+    const __m128i zero = _mm_setzero_si128();
+    for (size_t j=0; j<nbr_values; j++) {
+        v[j] = _mm_set1_epi8(static_cast<char>(values[j]));
+    }
+    while (nbr_elements >= 16) {
+        // at most 255 blocks per round, so that 8-bit lanes cannot overflow
+        size_t blocks = nbr_elements / 16;
+        if (blocks > 255) blocks = 255;
+        nbr_elements -= blocks * 16;
+        for (size_t j=0; j<nbr_values; j++) {
+            acc[j] = zero;
+        }
+        for (size_t i=0; i<blocks; i++) {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+            for (size_t j=0; j<nbr_values; j++) {
+                acc[j] = _mm_sub_epi8(acc[j], _mm_cmpeq_epi8(x, v[j]));
+            }
+            data += 16;
+        }
+        // horizontal sums, see yarb_count()
+        for (size_t j=0; j<nbr_values; j++) {
+            const __m128i sums = _mm_sad_epu8(acc[j], zero);
+            counts[j] += static_cast<size_t>(_mm_cvtsi128_si32(sums));
+            counts[j] += static_cast<size_t>(_mm_cvtsi128_si32(_mm_unpackhi_epi64(sums, sums)));
+        }
+    }
+    count_values_bytes(data, nbr_elements, values, nbr_values, counts);
+#elif defined(YARB_COUNT_NEON)
+    uint8x16_t v[YaRBClassSet::max_values];
+    uint8x16_t acc[YaRBClassSet::max_values];
+    for (size_t j=0; j<nbr_values; j++) {
+        v[j] = vdupq_n_u8(values[j]);
+    }
+    while (nbr_elements >= 16) {
+        // at most 255 blocks per round, so that 8-bit lanes cannot overflow
+        size_t blocks = nbr_elements / 16;
+        if (blocks > 255) blocks = 255;
+        nbr_elements -= blocks * 16;
+        for (size_t j=0; j<nbr_values; j++) {
+            acc[j] = vdupq_n_u8(0);
+        }
+        for (size_t i=0; i<blocks; i++) {
+            const uint8x16_t x = vld1q_u8(data);
+            for (size_t j=0; j<nbr_values; j++) {
+                acc[j] = vsubq_u8(acc[j], vceqq_u8(x, v[j]));
+            }
+            data += 16;
+        }
+        // horizontal sums, see yarb_count()
+        for (size_t j=0; j<nbr_values; j++) {
+            const uint64x2_t sums = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(acc[j])));
+            counts[j] += static_cast<size_t>(vgetq_lane_u64(sums, 0) + vgetq_lane_u64(sums, 1));
+        }
+    }
+    count_values_bytes(data, nbr_elements, values, nbr_values, counts);
+#elif defined(YARB_COUNT_SWAR)
+    // handle unaligned head byte by byte
+    size_t head = (sizeof(size_t) - (reinterpret_cast<uintptr_t>(data) % sizeof(size_t))) % sizeof(size_t);
+    if (head > nbr_elements) head = nbr_elements;
+    count_values_bytes(data, head, values, nbr_values, counts);
+    data += head;
+    nbr_elements -= head;
+    // aligned words, see yarb_count()
+    size_t pattern[YaRBClassSet::max_values];
+    for (size_t j=0; j<nbr_values; j++) {
+        pattern[j] = ones * values[j];
+    }
+    const yarb_word_t *words = reinterpret_cast<const yarb_word_t*>(data);
+    const size_t nbr_words = nbr_elements / sizeof(size_t);
+    for (size_t i=0; i<nbr_words; i++) {
+        const size_t w = words[i];
+        for (size_t j=0; j<nbr_values; j++) {
+            const size_t x = w ^ pattern[j];
+            const size_t t = ~(((x & low7) + low7) | x) & high;
+            counts[j] += ((t >> 7) * ones) >> (8 * (sizeof(size_t) - 1));
+        }
+    }
+    data += nbr_words * sizeof(size_t);
+    nbr_elements -= nbr_words * sizeof(size_t);
+    // handle tail byte by byte
+    count_values_bytes(data, nbr_elements, values, nbr_values, counts);
+#else
+    // 8-bit platforms: nothing to gain from wider operations
+    count_values_bytes(data, nbr_elements, values, nbr_values, counts);
+#endif
+}
+
+/* YaRBClassSet */
+
+/**
+ * @brief   The constructor.
+ * @details The member values of all classes are collected here, once, to
+ *          decide between the vector kernel and the table lookup.
+ * @param   classes
+ *          Pointer to an array of nbr_classes byte classes. The array is
+ *          only read here and may be a temporary.
+ * @param   nbr_classes
+ *          Number of classes. At most max_classes are used.
+ */
+YaRBClassSet::YaRBClassSet(const YaRBByteClass *classes, size_t nbr_classes)
+    : masks{0}, ncls{classes ? nbr_classes : 0}, values{0}, owner{0}, nvals{0}, lookup{false} {
+    if (ncls > max_classes) ncls = max_classes;
+    for (size_t k=0; k<ncls; k++) {
+        for (unsigned int v=0; v<256; v++) {
+            if (!classes[k].contains(static_cast<uint8_t>(v))) continue;
+            masks[v] = static_cast<uint8_t>(masks[v] | (1u << k));
+            if (nvals < max_values) {
+                values[nvals] = static_cast<uint8_t>(v);
+                owner[nvals] = static_cast<uint8_t>(k);
+                nvals++;
+            }
+            else {
+                lookup = true;
+            }
+        }
+    }
+}
+
+/**
+ * @brief   Count the bytes of every class in an array, in one pass.
+ * @param   data
+ *          Pointer to the first byte of the (contiguous) array.
+ * @param   nbr_elements
+ *          Number of bytes to examine.
+ * @param[in,out] counts
+ *          The number of bytes in class k is @b added to counts[k].
+ */
+void YaRBClassSet::count(const uint8_t *data, size_t nbr_elements, size_t *counts) const {
+    if (!lookup) {
+        if (nvals == 1) {
+            counts[owner[0]] += yarb_count(data, nbr_elements, values[0]);
+        }
+        else if (nvals) {
+            size_t c[max_values] = {0};
+            yarb_count_values(data, nbr_elements, values, nvals, c);
+            for (size_t j=0; j<nvals; j++) {
+                counts[owner[j]] += c[j];
+            }
+        }
+    }
+    else {
+        // large classes: one table lookup per byte
+        for (size_t i=0; i<nbr_elements; i++) {
+            const uint8_t m = masks[data[i]];
+            if (!m) continue;
+            for (size_t k=0; k<ncls; k++) {
+                counts[k] += (m >> k) & 1;
+            }
+        }
+    }
+}
@@ -0,0 +1,193 @@
+/**
+ * @file    yarb_count.h
+ * @brief   Header file for the delimiter counting kernels used by YaRBc, YaRBct and YaRBpt
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarb_count_h License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef yarb_count_h
+#define yarb_count_h
+
+#include <stddef.h> // needed for size_t data type
+#include <stdint.h> // needed for uint8_t data type
+
+/**
+ * @brief   Count the number of bytes with a given value in an array.
+ * @details Used by the bulk operations of YaRBc and YaRBct to keep the
+ *          delimiter count exact without looping over the ring buffer
+ *          indices byte by byte. 
+ *          The array is examined 16 bytes at a time with SSE2 or NEON 
+ *          where available, otherwise one machine word (size_t) at a 
+ *          time. On 8-bit platforms (AVR), a simple loop is used.
+ *          Define YARB_COUNT_NO_SIMD to always use the word-at-a-time
+ *          version on platforms with SSE2 or NEON.
+ * @param   data
+ *          Pointer to the first byte of the (contiguous) array.
+ * @param   nbr_elements
+ *          Number of bytes to examine.
+ * @param   value
+ *          The byte value to count.
+ * @return  Number of bytes in data[0..nbr_elements-1] equal to value.
+ */
+size_t yarb_count(const uint8_t *data, size_t nbr_elements, uint8_t value);
+
+/**
+ * @brief   A set of byte values (a "byte class"), as a table of 256 bits.
+ * @details Bit (value & 7) of bits[value >> 3] is set if value belongs to
+ *          the class. Use yarb_byte_class() to define a class at compile 
+ *          time, or add() to build one at run time.
+ */
+struct YaRBByteClass {
+    uint8_t bits[32];   ///< one bit per byte value
+
+    /**
+     * @brief   Check if a byte value belongs to the class.
+     * @param   value
+     *          The byte value to check.
+     * @return  true if value belongs to the class.
+     */
+    constexpr bool contains(uint8_t value) const {
+        return (bits[value >> 3] >> (value & 7)) & 1;
+    }
+
+    /**
+     * @brief   Add a range of byte values to the class.
+     * @param   first
+     *          First byte value to add.
+     * @param   last
+     *          Last byte value to add (inclusive).
+     */
+    void add(uint8_t first, uint8_t last) {
+        for (unsigned int v=first; v<=last; v++) {
+            bits[v >> 3] = static_cast<uint8_t>(bits[v >> 3] | (1u << (v & 7)));
+        }
+    }
+    void add(uint8_t value) { add(value, value); }
+};
+
+/**
+ * @brief   Helper for yarb_byte_class(): the bits of one byte of the table.
+ */
+constexpr uint8_t yarb_byte_class_bits(size_t) {
+    return 0;
+}
+
+template <typename... VALUES>
+constexpr uint8_t yarb_byte_class_bits(size_t i, uint8_t value, VALUES... values) {
+    return static_cast<uint8_t>((((value >> 3) == i) ? (1u << (value & 7)) : 0u) | yarb_byte_class_bits(i, values...));
+}
+
+/**
+ * @brief   Define a byte class at compile time.
+ * @details Example: constexpr YaRBByteClass hdlc = yarb_byte_class(0x7E, 0x7D);
+ * @param   values
+ *          The byte values belonging to the class.
+ * @return  The byte class.
+ */
+template <typename... VALUES>
+constexpr YaRBByteClass yarb_byte_class(VALUES... values) {
+    return YaRBByteClass{{
+        yarb_byte_class_bits( 0, values...), yarb_byte_class_bits( 1, values...),
+        yarb_byte_class_bits( 2, values...), yarb_byte_class_bits( 3, values...),
+        yarb_byte_class_bits( 4, values...), yarb_byte_class_bits( 5, values...),
+        yarb_byte_class_bits( 6, values...), yarb_byte_class_bits( 7, values...),
+        yarb_byte_class_bits( 8, values...), yarb_byte_class_bits( 9, values...),
+        yarb_byte_class_bits(10, values...), yarb_byte_class_bits(11, values...),
+        yarb_byte_class_bits(12, values...), yarb_byte_class_bits(13, values...),
+        yarb_byte_class_bits(14, values...), yarb_byte_class_bits(15, values...),
+        yarb_byte_class_bits(16, values...), yarb_byte_class_bits(17, values...),
+        yarb_byte_class_bits(18, values...), yarb_byte_class_bits(19, values...),
+        yarb_byte_class_bits(20, values...), yarb_byte_class_bits(21, values...),
+        yarb_byte_class_bits(22, values...), yarb_byte_class_bits(23, values...),
+        yarb_byte_class_bits(24, values...), yarb_byte_class_bits(25, values...),
+        yarb_byte_class_bits(26, values...), yarb_byte_class_bits(27, values...),
+        yarb_byte_class_bits(28, values...), yarb_byte_class_bits(29, values...),
+        yarb_byte_class_bits(30, values...), yarb_byte_class_bits(31, values...)
+    }};
+}
+
+/**
+ * @class   YaRBClassSet
+ * @brief   Several byte classes, prepared for counting all of them in one
+ *          pass over the data.
+ * @details If the classes together have at most max_values members (e.g.
+ *          '\n' and 0x00, or 0x7E and 0x7D), each member value gets a lane
+ *          in the same SSE2/NEON/word-at-a-time kernel as yarb_count(), 
+ *          and every block of data is loaded only once for all of them. 
+ *          Larger classes (e.g. "all control characters") are counted with
+ *          a table lookup per byte, still in a single pass.
+ *          A byte value may belong to several classes and is then counted
+ *          in each of them.
+ * @note    The classes are merged into one table of 256 class masks (bit k
+ *          set for class k), so the set does not refer to the YaRBByteClass
+ *          tables given to the constructor afterwards. Single bytes are
+ *          looked up in this table.
+ */
+class YaRBClassSet {
+    public:
+        static constexpr size_t max_classes = 8;  ///< largest number of classes
+        static constexpr size_t max_values  = 8;  ///< largest number of members for the vector kernel
+
+        // constructor, the tables are merged into masks[]
+        YaRBClassSet(const YaRBByteClass *classes, size_t nbr_classes);
+
+        size_t  classes(void) const { return ncls; }        // return number of classes
+        uint8_t mask(uint8_t value) const { return masks[value]; } // return bit k set if value is in class k
+        bool    contains(size_t cls, uint8_t value) const { return (masks[value] >> cls) & 1; }
+
+        // add the number of bytes of each class in data[0..nbr_elements-1] to counts[]
+        void    count(const uint8_t *data, size_t nbr_elements, size_t *counts) const;
+
+    private:
+        uint8_t masks[256];           ///< classes of each byte value, bit k for class k
+        size_t  ncls;                 ///< number of classes
+        uint8_t values[max_values];   ///< member values, if there are at most max_values
+        uint8_t owner[max_values];    ///< class of each member value
+        size_t  nvals;                ///< number of member values
+        bool    lookup;               ///< too many member values: use masks[]
+};
+
+/**
+ * @brief   Count the number of bytes with any of several values in an 
+ *          array, in one pass.
+ * @details Same kernels as yarb_count(), but every block of data is 
+ *          compared with all values before the next one is loaded.
+ * @param   data
+ *          Pointer to the first byte of the (contiguous) array.
+ * @param   nbr_elements
+ *          Number of bytes to examine.
+ * @param   values
+ *          The byte values to count.
+ * @param   nbr_values
+ *          Number of values, at most YaRBClassSet::max_values.
+ * @param[in,out] counts
+ *          The number of bytes equal to values[j] is @b added to counts[j].
+ */
+void yarb_count_values(const uint8_t *data, size_t nbr_elements, const uint8_t *values, size_t nbr_values, size_t *counts);
+
+#endif // yarb_count_h
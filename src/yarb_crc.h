@@ -0,0 +1,236 @@
+/**
+ * @file    yarb_crc.h
+ * @brief   Per-message checksums for YaRBc and YaRBct
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarb_crc_h License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef yarb_crc_h
+#define yarb_crc_h
+
+#include <stddef.h> // needed for size_t data type
+#include <stdint.h> // needed for uint8_t data type
+#include <string.h> // memchr()
+
+/*
+ * Note:
+ * The CRC of a message covers all bytes put into the ring buffer since the
+ * previous delimiter, @b excluding the delimiter itself. It is calculated
+ * while the bytes are added: the tracker keeps the running CRC of the
+ * incomplete message and, at each delimiter, stores the finished CRC
+ * (snapshot) in a small ring. Like the delimiter positions, only the 
+ * snapshots of the oldest N messages are stored. For the others, the CRC 
+ * is calculated from the stored bytes when it is requested. The same 
+ * holds for a message which was already partly stored when the tracker
+ * was attached (or reset): its running CRC would miss the first bytes.
+ * 
+ * A snapshot always covers the whole message as it was put. When bytes 
+ * of the oldest message are removed without its delimiter (by get(), 
+ * discard() or when dropped in overwrite mode), the ring buffer calls 
+ * truncated() and the snapshot of that message is dropped: its CRC is
+ * then calculated from the bytes still stored, like for messages without
+ * snapshot.
+ *
+ * A CRC algorithm is a class with three static functions:
+ *
+ *     static uint32_t init(void);
+ *     static uint32_t update(uint32_t crc, const uint8_t *data, size_t nbr_elements);
+ *     static uint32_t final(uint32_t crc);
+ *
+ * YaRBCrc16 and YaRBCrc32 are table-driven software implementations. A 
+ * class using a hardware CRC unit can be used in the same way.
+ */
+
+/**
+ * @brief   CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF,
+ *          not reflected, no final XOR).
+ * @details Check value for "123456789": 0x29B1.
+ */
+struct YaRBCrc16 {
+    static constexpr uint32_t init(void) { return 0xFFFF; }
+    static uint32_t update(uint32_t crc, const uint8_t *data, size_t nbr_elements);
+    static constexpr uint32_t final(uint32_t crc) { return crc; }
+};
+
+/**
+ * @brief   CRC-32 as used by Ethernet and zlib (reflected polynomial
+ *          0xEDB88320, initial value and final XOR 0xFFFFFFFF).
+ * @details Check value for "123456789": 0xCBF43926.
+ */
+struct YaRBCrc32 {
+    static constexpr uint32_t init(void) { return 0xFFFFFFFF; }
+    static uint32_t update(uint32_t crc, const uint8_t *data, size_t nbr_elements);
+    static constexpr uint32_t final(uint32_t crc) { return crc ^ 0xFFFFFFFF; }
+};
+
+/**
+ * @class   IYaRBCrc
+ * @brief   Interface of a per-message CRC tracker, as used by YaRBc.
+ */
+class IYaRBCrc {
+    public:
+        // bytes were added to the ring buffer
+        virtual void     added(const uint8_t *data, size_t nbr_elements, uint8_t delimiter) = 0;
+        // the oldest delimiters were removed from the ring buffer
+        virtual void     removed(size_t nbr_delims) = 0;
+        // bytes of the oldest message were removed, but not its delimiter
+        virtual void     truncated(void) = 0;
+        // start over, the ring buffer holds nbr_delims delimiters without snapshot
+        // and, if partial, the first bytes of an incomplete message
+        virtual void     reset(size_t nbr_delims, bool partial) = 0;
+        // get snapshot of the oldest message, false if there is none
+        virtual bool     first(uint32_t *crc) const = 0;
+        // calculate the CRC of the bytes in two segments
+        virtual uint32_t calculate(const uint8_t *data1, size_t nbr1, const uint8_t *data2, size_t nbr2) const = 0;
+        virtual ~IYaRBCrc() = default;
+};
+
+/**
+ * @class   YaRBCrcTracker
+ * @brief   Per-message CRC tracker.
+ * @details Use it as CRC policy of YaRBct or attach it to a YaRBc with
+ *          attachCrc().
+ * @tparam  ALGO
+ *          The CRC algorithm, e.g. YaRBCrc16 or YaRBCrc32.
+ * @tparam  N
+ *          Number of snapshots to store.
+ */
+template <class ALGO, size_t N = 8>
+class YaRBCrcTracker : public IYaRBCrc {
+    public:
+        static_assert(N > 0, "not allowed to instantiate template with N=0");
+
+        YaRBCrcTracker(void) : running{ALGO::init()}, snapshots{}, first_snapshot{0}, known{0}, unknown{0}, partial{false}, stale{false} {}
+
+        void     added(const uint8_t *data, size_t nbr_elements, uint8_t delimiter) override;
+        void     removed(size_t nbr_delims) override;
+        void     truncated(void) override;
+        void     reset(size_t nbr_delims, bool partial) override;
+        bool     first(uint32_t *crc) const override;
+        uint32_t calculate(const uint8_t *data1, size_t nbr1, const uint8_t *data2, size_t nbr2) const override;
+
+    private:
+        uint32_t running;               ///< CRC of the incomplete message (before final())
+        uint32_t snapshots[N];          ///< CRCs of the oldest complete messages
+        size_t   first_snapshot;        ///< index of oldest snapshot
+        size_t   known;                 ///< number of stored snapshots
+        size_t   unknown;               ///< number of newer messages without snapshot
+        bool     partial;               ///< running misses the first bytes of the incomplete message
+        bool     stale;                 ///< oldest snapshot does not match the stored bytes anymore
+};
+
+/**
+ * @brief   No CRC at all, the default policy of YaRBct. Costs nothing.
+ */
+struct YaRBNoCrc {
+    void added(const uint8_t *, size_t, uint8_t) {}
+    void removed(size_t) {}
+    void truncated(void) {}
+    void reset(size_t, bool) {}
+};
+
+template <class ALGO, size_t N>
+void YaRBCrcTracker<ALGO, N>::added(const uint8_t *data, size_t nbr_elements, uint8_t delimiter) {
+    while (nbr_elements) {
+        const uint8_t *d = static_cast<const uint8_t*>(memchr(data, delimiter, nbr_elements));
+        const size_t k = d ? static_cast<size_t>(d - data) : nbr_elements;
+        running = ALGO::update(running, data, k);
+        if (!d) {
+            return;
+        }
+        // message complete: store snapshot, if all older ones are stored
+        // and running covers the whole message
+        if (!partial && unknown == 0 && known < N) {
+            size_t slot = first_snapshot + known;
+            if (slot >= N) slot -= N;
+            snapshots[slot] = ALGO::final(running);
+            known++;
+        }
+        else {
+            unknown++;
+        }
+        partial = false;
+        running = ALGO::init();
+        data += k + 1;
+        nbr_elements -= k + 1;
+    }
+}
+
+template <class ALGO, size_t N>
+void YaRBCrcTracker<ALGO, N>::removed(size_t nbr_delims) {
+    // the stale snapshot (if any) belonged to a removed message
+    if (nbr_delims) stale = false;
+    if (nbr_delims < known) {
+        known -= nbr_delims;
+        first_snapshot += nbr_delims;
+        if (first_snapshot >= N) first_snapshot -= N;
+        return;
+    }
+    nbr_delims -= known;
+    known = 0;
+    first_snapshot = 0;
+    unknown = (nbr_delims < unknown) ? (unknown - nbr_delims) : 0;
+}
+
+template <class ALGO, size_t N>
+void YaRBCrcTracker<ALGO, N>::truncated(void) {
+    if (known) {
+        // the oldest message has a snapshot
+        stale = true;
+    }
+    else if (unknown == 0) {
+        // the oldest message is the incomplete one
+        partial = true;
+    }
+}
+
+template <class ALGO, size_t N>
+void YaRBCrcTracker<ALGO, N>::reset(size_t nbr_delims, bool partial_message) {
+    running = ALGO::init();
+    first_snapshot = 0;
+    known = 0;
+    unknown = nbr_delims;
+    partial = partial_message;
+    stale = false;
+}
+
+template <class ALGO, size_t N>
+bool YaRBCrcTracker<ALGO, N>::first(uint32_t *crc) const {
+    if (known == 0 || stale) {
+        return false;
+    }
+    *crc = snapshots[first_snapshot];
+    return true;
+}
+
+template <class ALGO, size_t N>
+uint32_t YaRBCrcTracker<ALGO, N>::calculate(const uint8_t *data1, size_t nbr1, const uint8_t *data2, size_t nbr2) const {
+    return ALGO::final(ALGO::update(ALGO::update(ALGO::init(), data1, nbr1), data2, nbr2));
+}
+
+#endif // yarb_crc_h
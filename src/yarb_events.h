@@ -0,0 +1,168 @@
+/**
+ * @file    yarb_events.h
+ * @brief   Watermark and message callbacks, blocking get on hosted platforms
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarb_events_h License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef yarb_events_h
+#define yarb_events_h
+
+#include <stddef.h>  // needed for size_t data type
+#include <stdint.h>  // needed for uint8_t data type
+#include "yarb_interface.h" // IYaRB, YARB_HOSTED
+#include "yarbc.h"          // YaRBc, YaRBct
+
+#if defined(YARB_HOSTED)
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#endif
+
+/*
+ * Note:
+ * All calls through a YaRBEvents compare size() (and count() of a YaRBc
+ * or YaRBct) before and after the call to the ring buffer. A callback is
+ * called only on a transition, never again while the state stays the 
+ * same:
+ *
+ * - high watermark: size() was below the level and is now at or above it
+ * - low watermark:  size() was above the level and is now at or below it
+ * - message:        count() was 0 and is now at least 1
+ *
+ * The callbacks are called in the context of the call causing the 
+ * transition, e.g. in an ISR which calls put(). Keep them short: set a 
+ * flag, release a task, stop a sender. 
+ *
+ * On hosted platforms, all calls through the wrapper hold a mutex, so
+ * any ring buffer (also a YaRBc) can be shared by several threads this 
+ * way. get() and getMessage() with a timeout sleep on a condition 
+ * variable until there is data (a complete message) instead of polling.
+ * The producer only notifies when a consumer is waiting and its call 
+ * made data (a message) available. The callbacks are called after the
+ * mutex is released, so they may call the wrapper again.
+ */
+
+typedef void (*YaRBEventCallback)(void *context); ///< callback for YaRBEvents
+
+/**
+ * @class   YaRBEvents
+ * @brief   Ring buffer wrapper which calls back on watermark crossings and
+ *          when the first complete message arrives.
+ * @details Implements IYaRB by forwarding all calls to the ring buffer, 
+ *          so it can be used instead of the ring buffer anywhere. Data
+ *          added or removed directly (not through the wrapper) does not
+ *          cause callbacks.
+ * @tparam  RB
+ *          Type of the ring buffer: any implementation of IYaRB. The 
+ *          message functions need a YaRBc or YaRBct.
+ */
+template <class RB>
+class YaRBEvents final : public IYaRB {
+    public:
+        // constructor
+        YaRBEvents(RB &ringbuffer);
+
+        // do not allow copies or assignments
+        YaRBEvents(const YaRBEvents &ev) = delete;
+        YaRBEvents<RB>& operator= (const YaRBEvents<RB> &ev) = delete;
+
+        // register callbacks, nullptr to unregister
+        void onHigh(size_t level, YaRBEventCallback callback, void *context=nullptr); // size() rises to level
+        void onLow(size_t level, YaRBEventCallback callback, void *context=nullptr);  // size() falls to level
+        void onMessage(YaRBEventCallback callback, void *context=nullptr);            // first complete message
+
+        // IYaRB interface, forwarded to the ring buffer
+        virtual size_t put(uint8_t new_element) override;
+        virtual size_t put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) override;
+        virtual size_t get(uint8_t *returned_element) override;
+        virtual size_t get(uint8_t *returned_elements, size_t nbr_elements) override;
+        virtual size_t peek(uint8_t *peeked_element) const override; 
+        virtual size_t peek(uint8_t *peeked_element, size_t offset) const override;
+        virtual size_t peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const override;
+        virtual size_t discard(size_t nbr_elements) override;
+        virtual size_t writeReserve(uint8_t **region) override;
+        virtual size_t commit(size_t nbr_elements) override;
+        virtual size_t readSpan(const uint8_t **region) const override;
+        virtual size_t consume(size_t nbr_elements) override;
+        virtual size_t size(void) const override;
+        virtual size_t free(void) const override;
+        virtual size_t capacity(void) const override;
+        virtual bool   isFull(void) const override;
+        virtual bool   isEmpty(void) const override;
+        virtual void   flush(void) override;
+
+        // message functions, only for YaRBc and YaRBct
+        size_t count(void) const;
+        size_t messageLength(void);
+        size_t getMessage(uint8_t *returned_elements, size_t nbr_elements);
+        size_t discardMessage(void);
+
+#if defined(YARB_HOSTED)
+        // block until there is data (a complete message), at most timeout_ms milliseconds
+        size_t get(uint8_t *returned_elements, size_t nbr_elements, uint32_t timeout_ms);
+        size_t getMessage(uint8_t *returned_elements, size_t nbr_elements, uint32_t timeout_ms);
+#endif
+
+        RB&    buffer(void);  // return the ring buffer
+
+    private:
+        RB &rb;                         ///< ring buffer all calls are forwarded to
+
+        size_t            high;         ///< high watermark
+        YaRBEventCallback high_cb;      ///< callback for high watermark, may be nullptr
+        void              *high_ctx;    ///< context for high_cb
+        size_t            low;          ///< low watermark
+        YaRBEventCallback low_cb;       ///< callback for low watermark, may be nullptr
+        void              *low_ctx;     ///< context for low_cb
+        YaRBEventCallback msg_cb;       ///< callback for first message, may be nullptr
+        void              *msg_ctx;     ///< context for msg_cb
+
+#if defined(YARB_HOSTED)
+        mutable std::mutex      m;       ///< protects the ring buffer and waiters
+        std::condition_variable cv;      ///< waiting consumers
+        unsigned                waiters; ///< number of waiting consumers
+#endif
+
+        // holds the mutex (on hosted platforms) during a read-only call
+        class Guard;
+        // holds the mutex during a modifying call, checks for transitions
+        // afterwards, calls back and wakes consumers
+        class Transition;
+
+        // number of complete messages, 0 for ring buffers without count()
+        static size_t messages(const IYaRB &r);
+        static size_t messages(const YaRBc &r);
+        template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+        static size_t messages(const YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX> &r);
+};
+
+// include imlementation file for template here
+#include "yarb_events.hpp"
+
+#endif // yarb_events_h
@@ -0,0 +1,378 @@
+/**
+ * @file    yarb_events.hpp
+ * @brief   Implementation file for watermark and message callbacks
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarb_events_hpp License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Note:
+ * A modifying call creates a Transition: its constructor locks the mutex
+ * and takes size() and count() before the call, its destructor takes
+ * them again after the call (the return value is already determined),
+ * unlocks the mutex and then calls back and notifies.
+ */
+
+template <class RB>
+class YaRBEvents<RB>::Guard {
+    public:
+#if defined(YARB_HOSTED)
+        Guard(const YaRBEvents<RB> &ev) : lock(ev.m) {}
+    private:
+        std::lock_guard<std::mutex> lock;
+#else
+        Guard(const YaRBEvents<RB> &) {}
+#endif
+};
+
+template <class RB>
+class YaRBEvents<RB>::Transition {
+    public:
+        Transition(YaRBEvents<RB> &ev);
+        ~Transition();
+    private:
+        YaRBEvents<RB> &e;
+#if defined(YARB_HOSTED)
+        std::unique_lock<std::mutex> lock;
+#endif
+        size_t size_before;
+        size_t count_before;
+};
+
+/**
+ * @brief   Lock the mutex and take the state before a call.
+ */
+template <class RB>
+YaRBEvents<RB>::Transition::Transition(YaRBEvents<RB> &ev)
+    : e(ev),
+#if defined(YARB_HOSTED)
+      lock(ev.m),
+#endif
+      size_before{ev.rb.size()}, count_before{messages(ev.rb)} {
+}
+
+/**
+ * @brief   Take the state after a call, unlock the mutex, then call back 
+ *          and wake waiting consumers on transitions.
+ */
+template <class RB>
+YaRBEvents<RB>::Transition::~Transition() {
+    const size_t size_after = e.rb.size();
+    const size_t count_after = messages(e.rb);
+    // copy the callbacks, they may be changed as soon as the mutex is released
+    const YaRBEventCallback high_cb = e.high_cb, low_cb = e.low_cb, msg_cb = e.msg_cb;
+    void * const high_ctx = e.high_ctx, * const low_ctx = e.low_ctx, * const msg_ctx = e.msg_ctx;
+    const bool high = high_cb && size_before < e.high && size_after >= e.high;
+    const bool low = low_cb && size_before > e.low && size_after <= e.low;
+    const bool msg = count_before == 0 && count_after != 0;
+#if defined(YARB_HOSTED)
+    const bool wake = e.waiters && ((size_before == 0 && size_after != 0) || msg);
+    lock.unlock();
+    if (wake) e.cv.notify_all();
+#endif
+    if (high) high_cb(high_ctx);
+    if (low) low_cb(low_ctx);
+    if (msg && msg_cb) msg_cb(msg_ctx);
+}
+
+/**
+ * @brief   The constructor.
+ * @details No callbacks are registered.
+ * @param   ringbuffer
+ *          The ring buffer. It must outlive the wrapper.
+ */
+template <class RB>
+YaRBEvents<RB>::YaRBEvents(RB &ringbuffer)
+    : rb(ringbuffer), high{0}, high_cb{nullptr}, high_ctx{nullptr}, 
+      low{0}, low_cb{nullptr}, low_ctx{nullptr}, msg_cb{nullptr}, msg_ctx{nullptr}
+#if defined(YARB_HOSTED)
+      , waiters{0}
+#endif
+{
+}
+
+/**
+ * @brief   Register a callback for the high watermark.
+ * @param   level
+ *          The callback is called when size() rises from below level to
+ *          level or above.
+ * @param   callback
+ *          Function to call, nullptr to unregister.
+ * @param   context
+ *          Pointer passed to the callback.
+ */
+template <class RB>
+void YaRBEvents<RB>::onHigh(size_t level, YaRBEventCallback callback, void *context) {
+    Guard guard(*this);
+    high = level;
+    high_ctx = context;
+    high_cb = callback;
+}
+
+/**
+ * @brief   Register a callback for the low watermark.
+ * @param   level
+ *          The callback is called when size() falls from above level to
+ *          level or below. Use 0 to be called when the buffer runs empty.
+ * @param   callback
+ *          Function to call, nullptr to unregister.
+ * @param   context
+ *          Pointer passed to the callback.
+ */
+template <class RB>
+void YaRBEvents<RB>::onLow(size_t level, YaRBEventCallback callback, void *context) {
+    Guard guard(*this);
+    low = level;
+    low_ctx = context;
+    low_cb = callback;
+}
+
+/**
+ * @brief   Register a callback for the first complete message.
+ * @details The callback is called when count() rises from 0. Only for 
+ *          YaRBc and YaRBct.
+ * @param   callback
+ *          Function to call, nullptr to unregister.
+ * @param   context
+ *          Pointer passed to the callback.
+ */
+template <class RB>
+void YaRBEvents<RB>::onMessage(YaRBEventCallback callback, void *context) {
+    Guard guard(*this);
+    msg_ctx = context;
+    msg_cb = callback;
+}
+
+template <class RB>
+size_t YaRBEvents<RB>::put(uint8_t new_element) {
+    Transition t(*this);
+    return rb.put(new_element);
+}
+
+template <class RB>
+size_t YaRBEvents<RB>::put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) {
+    Transition t(*this);
+    return rb.put(new_elements, nbr_elements, only_complete);
+}
+
+template <class RB>
+size_t YaRBEvents<RB>::get(uint8_t *returned_element) {
+    Transition t(*this);
+    return rb.get(returned_element);
+}
+
+template <class RB>
+size_t YaRBEvents<RB>::get(uint8_t *returned_elements, size_t nbr_elements) {
+    Transition t(*this);
+    return rb.get(returned_elements, nbr_elements);
+}
+
+template <class RB>
+size_t YaRBEvents<RB>::peek(uint8_t *peeked_element) const {
+    Guard guard(*this);
+    return rb.peek(peeked_element);
+}
+
+template <class RB>
+size_t YaRBEvents<RB>::peek(uint8_t *peeked_element, size_t offset) const {
+    Guard guard(*this);
+    return rb.peek(peeked_element, offset);
+}
+
+template <class RB>
+size_t YaRBEvents<RB>::peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const {
+    Guard guard(*this);
+    return rb.peek(peeked_elements, nbr_elements, offset);
+}
+
+template <class RB>
+size_t YaRBEvents<RB>::discard(size_t nbr_elements) {
+    Transition t(*this);
+    return rb.discard(nbr_elements);
+}
+
+template <class RB>
+size_t YaRBEvents<RB>::writeReserve(uint8_t **region) {
+    Guard guard(*this);
+    return rb.writeReserve(region);
+}
+
+template <class RB>
+size_t YaRBEvents<RB>::commit(size_t nbr_elements) {
+    Transition t(*this);
+    return rb.commit(nbr_elements);
+}
+
+template <class RB>
+size_t YaRBEvents<RB>::readSpan(const uint8_t **region) const {
+    Guard guard(*this);
+    return rb.readSpan(region);
+}
+
+template <class RB>
+size_t YaRBEvents<RB>::consume(size_t nbr_elements) {
+    Transition t(*this);
+    return rb.consume(nbr_elements);
+}
+
+template <class RB>
+size_t YaRBEvents<RB>::size(void) const {
+    Guard guard(*this);
+    return rb.size();
+}
+
+template <class RB>
+size_t YaRBEvents<RB>::free(void) const {
+    Guard guard(*this);
+    return rb.free();
+}
+
+template <class RB>
+size_t YaRBEvents<RB>::capacity(void) const {
+    Guard guard(*this);
+    return rb.capacity();
+}
+
+template <class RB>
+bool YaRBEvents<RB>::isFull(void) const {
+    Guard guard(*this);
+    return rb.isFull();
+}
+
+template <class RB>
+bool YaRBEvents<RB>::isEmpty(void) const {
+    Guard guard(*this);
+    return rb.isEmpty();
+}
+
+template <class RB>
+void YaRBEvents<RB>::flush(void) {
+    Transition t(*this);
+    rb.flush();
+}
+
+template <class RB>
+size_t YaRBEvents<RB>::count(void) const {
+    Guard guard(*this);
+    return rb.count();
+}
+
+template <class RB>
+size_t YaRBEvents<RB>::messageLength(void) {
+    Guard guard(*this);
+    return rb.messageLength();
+}
+
+template <class RB>
+size_t YaRBEvents<RB>::getMessage(uint8_t *returned_elements, size_t nbr_elements) {
+    Transition t(*this);
+    return rb.getMessage(returned_elements, nbr_elements);
+}
+
+template <class RB>
+size_t YaRBEvents<RB>::discardMessage(void) {
+    Transition t(*this);
+    return rb.discardMessage();
+}
+
+#if defined(YARB_HOSTED)
+/**
+ * @brief      Get element(s) from the ring buffer, waiting for data if it
+ *             is empty.
+ * @details    Returns as soon as there is at least one element, it does 
+ *             not wait until nbr_elements are available.
+ * @param[out] returned_elements
+ *             Pointer to a uint8_t array for the elements.
+ * @param      nbr_elements
+ *             Maximum number of elements to get.
+ * @param      timeout_ms
+ *             Maximum time to wait in milliseconds.
+ * @return     Number of elements got, 0 after a timeout.
+ */
+template <class RB>
+size_t YaRBEvents<RB>::get(uint8_t *returned_elements, size_t nbr_elements, uint32_t timeout_ms) {
+    if (nbr_elements) {
+        std::unique_lock<std::mutex> lock(m);
+        waiters++;
+        cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this]() { return !rb.isEmpty(); });
+        waiters--;
+    }
+    // another consumer may have been faster, then this returns 0
+    return this->get(returned_elements, nbr_elements);
+}
+
+/**
+ * @brief      Get exactly one complete message, waiting for one if there
+ *             is none.
+ * @param[out] returned_elements
+ *             Pointer to a uint8_t array for the message.
+ * @param      nbr_elements
+ *             Size of the array.
+ * @param      timeout_ms
+ *             Maximum time to wait in milliseconds.
+ * @return     Number of bytes copied, including the delimiter. 0 after a
+ *             timeout or if the message does not fit (see 
+ *             YaRBc::getMessage()).
+ */
+template <class RB>
+size_t YaRBEvents<RB>::getMessage(uint8_t *returned_elements, size_t nbr_elements, uint32_t timeout_ms) {
+    {
+        std::unique_lock<std::mutex> lock(m);
+        waiters++;
+        cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this]() { return messages(rb) != 0; });
+        waiters--;
+    }
+    return this->getMessage(returned_elements, nbr_elements);
+}
+#endif
+
+/**
+ * @brief   Get the ring buffer.
+ * @return  Reference to the ring buffer given to the constructor.
+ */
+template <class RB>
+RB& YaRBEvents<RB>::buffer(void) {
+    return rb;
+}
+
+// ring buffers without messages
+template <class RB>
+size_t YaRBEvents<RB>::messages(const IYaRB &) {
+    return 0;
+}
+
+template <class RB>
+size_t YaRBEvents<RB>::messages(const YaRBc &r) {
+    return r.count();
+}
+
+template <class RB>
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBEvents<RB>::messages(const YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX> &r) {
+    return r.count();
+}
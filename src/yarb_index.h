@@ -0,0 +1,215 @@
+/**
+ * @file    yarb_index.h
+ * @brief   Compile-time index arithmetic for the templated ring buffers
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarb_index_h License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef yarb_index_h
+#define yarb_index_h
+
+#include <stddef.h> // needed for size_t data type
+#include <stdint.h> // needed for SIZE_MAX
+
+/*
+ * Note:
+ * The templated ring buffers do not calculate their indices themselves,
+ * but delegate this to one of the helper classes in this file. The helper
+ * class is selected at compile time by the CAPACITY template parameter:
+ *
+ * - If CAPACITY is a power of two, YaRBFreeIndex is used: both indices
+ *   are "free-running", i.e. they are only ever incremented and are
+ *   allowed to overflow. The position within the array is calculated
+ *   with a bit mask. All CAPACITY slots of the array can be used and no
+ *   division is needed at all.
+ * - Otherwise, the "generic" versions YaRBIndex (classic ring buffer with
+ *   one unused slot) and YaRB2Index (indices modulo 2*CAPACITY) are used.
+ *
+ * All functions take and return "raw" index values. Use pos() to get the
+ * position in the array.
+ *
+ * The ring buffers store their indices in the index type I (template
+ * parameter INDEX), by default the smallest unsigned type which can hold
+ * all raw index values (see YaRBIndexType). The functions calculate with
+ * size_t; the results always fit into I, except for the free-running 
+ * indices, which are meant to wrap around when stored. max_capacity 
+ * depends on I.
+ */
+
+/**
+ * @brief   Determine if a number is a power of two.
+ * @param   n
+ *          The number to check.
+ * @return  @em true if n is a power of two, @em false otherwise (also for 0).
+ */
+constexpr bool yarb_is_pow2(size_t n) {
+    return (n != 0) && ((n & (n - 1)) == 0);
+}
+
+/**
+ * @brief   Get the largest value of an unsigned index type.
+ * @return  Largest value of I, as size_t.
+ */
+template <typename I>
+constexpr size_t yarb_index_max(void) {
+    return static_cast<size_t>(static_cast<I>(~static_cast<I>(0)));
+}
+
+/**
+ * @brief   Helper for YaRBIndexType.
+ */
+template <bool FITS8, bool FITS16>
+struct YaRBIndexSelect {
+    typedef size_t type;
+};
+
+template <bool FITS16>
+struct YaRBIndexSelect<true, FITS16> {
+    typedef uint8_t type;
+};
+
+template <>
+struct YaRBIndexSelect<false, true> {
+    typedef uint16_t type;
+};
+
+/**
+ * @brief   Smallest unsigned type (uint8_t, uint16_t or size_t) which can
+ *          hold all values from 0 to MAXVAL.
+ * @details On AVR, uint8_t indices are updated with single instructions
+ *          and are thus atomic.
+ */
+template <size_t MAXVAL>
+struct YaRBIndexType {
+    typedef typename YaRBIndexSelect<(MAXVAL <= 0xFF), (MAXVAL <= 0xFFFF)>::type type;
+};
+
+/**
+ * @brief   Largest raw index value of YaRBIndex (free-running for 
+ *          power-of-two capacities).
+ */
+constexpr size_t yarb_index_maxval(size_t capacity) {
+    return yarb_is_pow2(capacity) ? (2*capacity - 1) : capacity;
+}
+
+/**
+ * @brief   Largest raw index value of YaRB2Index.
+ */
+constexpr size_t yarb2_index_maxval(size_t capacity) {
+    return 2*capacity - 1;
+}
+
+/**
+ * @brief   Index arithmetic with free-running indices for power-of-two
+ *          capacities.
+ * @details The number of used slots is simply writeindex - readindex, even
+ *          after one or both indices have overflowed. This works because
+ *          CAPACITY divides the number of values of I.
+ */
+template <size_t CAPACITY, typename I = size_t>
+struct YaRBFreeIndex {
+    static_assert(yarb_is_pow2(CAPACITY), "CAPACITY must be a power of two");
+
+    static constexpr size_t slots = CAPACITY;          ///< size of the array
+    static constexpr size_t mask  = CAPACITY - 1;      ///< mask for array position
+    static constexpr size_t max_capacity = yarb_index_max<I>() / 2 + 1; ///< largest possible CAPACITY
+
+    static_assert(CAPACITY <= max_capacity, "index type too small for CAPACITY");
+
+    static size_t pos(size_t val) { return val & mask; }
+    static size_t next(size_t val) { return val + 1; }
+    static size_t advance(size_t val, size_t nbr_elements) { return val + nbr_elements; }
+    // the indices wrap around in I, so the difference must, too
+    static size_t used(size_t r, size_t w) { return static_cast<I>(w - r); }
+    static bool   full(size_t r, size_t w) { return used(r, w) == CAPACITY; }
+};
+
+/**
+ * @brief   Index arithmetic of the classic ring buffer (YaRBt, YaRBct, YaRBst).
+ * @details Both indices stay within [0, CAPACITY], one slot of the array
+ *          always stays unused. The helper for power-of-two capacities
+ *          is selected automatically.
+ */
+template <size_t CAPACITY, bool POW2 = yarb_is_pow2(CAPACITY), typename I = size_t>
+struct YaRBIndex {
+    static constexpr size_t slots = CAPACITY + 1;   ///< size of the array
+    static constexpr size_t max_capacity = (yarb_index_max<I>() < SIZE_MAX) ? yarb_index_max<I>() : (SIZE_MAX - 1); ///< largest possible CAPACITY
+
+    static_assert(CAPACITY <= max_capacity, "index type too small for CAPACITY");
+
+    static size_t pos(size_t val) { return val; }
+    // comparison instead of modulus: no division needed
+    static size_t next(size_t val) { return (val == CAPACITY) ? 0 : val + 1; }
+    static size_t advance(size_t val, size_t nbr_elements) {
+        // Due to danger of integer overflow, we cannot just do
+        // (val + nbr_elements) % slots --> do modulus calculation "manually".
+        // The difference between val and slots is always >= 1.
+        const size_t diff_to_max = slots - val;
+        return (nbr_elements >= diff_to_max) ? (nbr_elements - diff_to_max) : (val + nbr_elements);
+    }
+    static size_t used(size_t r, size_t w) { return (w >= r) ? (w - r) : (slots - (r - w)); }
+    static bool   full(size_t r, size_t w) { return r == next(w); }
+};
+
+/**
+ * @brief   Classic index arithmetic, specialized for power-of-two capacities.
+ */
+template <size_t CAPACITY, typename I>
+struct YaRBIndex<CAPACITY, true, I> : public YaRBFreeIndex<CAPACITY, I> {};
+
+/**
+ * @brief   Index arithmetic of the full-array ring buffer (YaRB2t).
+ * @details Both indices stay within [0, 2*CAPACITY). The helper for power-of-two
+ *          capacities is selected automatically.
+ */
+template <size_t CAPACITY, bool POW2 = yarb_is_pow2(CAPACITY), typename I = size_t>
+struct YaRB2Index {
+    static constexpr size_t slots = CAPACITY;       ///< size of the array
+    static constexpr size_t max_capacity = yarb_index_max<I>() / 2; ///< largest possible CAPACITY
+
+    static_assert(CAPACITY <= max_capacity, "index type too small for CAPACITY");
+
+    // val is always < 2*CAPACITY --> comparison instead of modulus
+    static size_t pos(size_t val) { return (val >= CAPACITY) ? (val - CAPACITY) : val; }
+    static size_t next(size_t val) { return (val == 2*CAPACITY - 1) ? 0 : val + 1; }
+    static size_t advance(size_t val, size_t nbr_elements) {
+        // The difference between val and 2*CAPACITY is always >= 1.
+        const size_t diff_to_max = 2*CAPACITY - val;
+        return (nbr_elements >= diff_to_max) ? (nbr_elements - diff_to_max) : (val + nbr_elements);
+    }
+    static size_t used(size_t r, size_t w) { return (w >= r) ? (w - r) : (2*CAPACITY - (r - w)); }
+    static bool   full(size_t r, size_t w) { return used(r, w) == CAPACITY; }
+};
+
+/**
+ * @brief   Full-array index arithmetic, specialized for power-of-two capacities.
+ */
+template <size_t CAPACITY, typename I>
+struct YaRB2Index<CAPACITY, true, I> : public YaRBFreeIndex<CAPACITY, I> {};
+
+#endif // yarb_index_h
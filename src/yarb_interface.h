@@ -89,7 +89,13 @@
  * | `size_t get(uint_8 * returned_element)` | Get a single byte back out from the Ring Buffer. |
  * | `size_t get(uint_8 * returned_elements, size_t nbr_elements)` | Get several bytes back out from the Ring Buffer and write them to an array. |
  * | `size_t peek(uint_8 * returned_element)` | Get next element from the ring buffer while *not* removing it from the buffer. |
+ * | `size_t peek(uint_8 * returned_element, size_t offset)` | Get element at position `offset` (0 is the next element) while *not* removing it from the buffer. |
+ * | `size_t peek(uint_8 * returned_elements, size_t nbr_elements, size_t offset)` | Copy up to `nbr_elements` elements, starting at position `offset`, while *not* removing them from the buffer. |
  * | `size_t discard(size_t nbr_elements)`| Discard one or more bytes from the Ring Buffer. |
+ * | `size_t writeReserve(uint8_t ** region)` | Get the largest contiguous free region of the Ring Buffer to write to directly. |
+ * | `size_t commit(size_t nbr_elements)` | Add bytes written to the region from `writeReserve()` to the Ring Buffer. |
+ * | `size_t readSpan(const uint8_t ** region)` | Get the largest contiguous region of stored bytes to read directly. |
+ * | `size_t consume(size_t nbr_elements)` | Remove bytes processed via `readSpan()` from the Ring Buffer. |
  * | `size_t size(void)` | Return the number of stored bytes. |
  * | `size_t free(void)` | Return the nuber of free slots. |
  * | `size_t capacity(void)` | Return the total capacity of the Ring Buffer. |
@@ -144,8 +150,9 @@
  * Therefore, I say it right up front: **Do not use my Ring Buffer
  * implementation within ISRs.**
  * 
- * Maybe I will try to implement an interrupt-safe version later. The
- * abstact base class is now there, after all. ;-)
+ * The only exception are the implementations YaRBs and YaRBst in yarbs.h.
+ * They are made for exactly one producer and one consumer, e.g. put() in
+ * an ISR and get() in loop().
  * 
  * @section author Author
  *
@@ -185,23 +192,48 @@
 #include <stddef.h> // needed for size_t data type
 #include <stdint.h> // needed for uint8_t data type
 
+/**
+ * @def     YARB_HOSTED
+ * @brief   Defined when building for a hosted platform with an operating
+ *          system (Linux, macOS). 
+ * @details Implementations which need virtual memory, files or threads
+ *          are only available when this macro is defined. Arduino builds
+ *          (AVR, ARM, ...) are not affected.
+ */
+#if !defined(YARB_HOSTED) && (defined(__linux__) || defined(__APPLE__))
+#define YARB_HOSTED 1
+#endif
+
 /**
  * @brief   Abstract base class for ring buffers.
  * @details This class defines the interface for ring buffers. There are
  *          several possible implementations with differing properties 
  *          for ring buffers. To be able to use these differing implementations
  *          interchangibly, a common interface is hereby defined.
+ * @tparam  T
+ *          Type of the elements stored in the ring buffer. Most 
+ *          implementations store bytes and use the IYaRB interface, which
+ *          is IYaRBt<uint8_t>.
  */
-class IYaRB {
+template <typename T>
+class IYaRBt {
     public:
-        virtual size_t put(uint8_t new_element) = 0;
-        virtual size_t put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) = 0;
+        virtual size_t put(T new_element) = 0;
+        virtual size_t put(const T *new_elements, size_t nbr_elements, bool only_complete) = 0;
 
-        virtual size_t get(uint8_t *returned_element) = 0;
-        virtual size_t get(uint8_t *returned_elements, size_t nbr_elements) = 0;
+        virtual size_t get(T *returned_element) = 0;
+        virtual size_t get(T *returned_elements, size_t nbr_elements) = 0;
         
-        virtual size_t peek(uint8_t *peeked_element) const = 0;
+        virtual size_t peek(T *peeked_element) const = 0;
+        virtual size_t peek(T *peeked_element, size_t offset) const = 0;
+        virtual size_t peek(T *peeked_elements, size_t nbr_elements, size_t offset) const = 0;
         virtual size_t discard(size_t nbr_elements) = 0;
+
+        virtual size_t writeReserve(T **region) = 0;
+        virtual size_t commit(size_t nbr_elements) = 0;
+        virtual size_t readSpan(const T **region) const = 0;
+        virtual size_t consume(size_t nbr_elements) = 0;
+
         virtual size_t size(void) const = 0;
         virtual size_t free(void) const = 0;
         virtual size_t capacity(void) const = 0;
@@ -213,14 +245,21 @@ class IYaRB {
         
         // Virtual destructor to make sure, that derived objects are
         // destroyed properly, even when called via pointer to base class.
-        virtual ~IYaRB() = default;
+        virtual ~IYaRBt() = default;
         
-        IYaRB& operator= (const IYaRB &yarb) = delete; ///< Do not allow implicit creation of assignment operator in derived classes.
+        IYaRBt& operator= (const IYaRBt &yarb) = delete; ///< Do not allow implicit creation of assignment operator in derived classes.
 };
 
+/**
+ * @brief   Interface for ring buffers of bytes.
+ * @details This is the interface implemented by all byte ring buffers
+ *          (YaRB, YaRBt, YaRB2, YaRB2t, YaRBc, YaRBct, ...).
+ */
+typedef IYaRBt<uint8_t> IYaRB;
+
 // put() single
 /**
- * @fn         virutal bool IYaRB::put(uint8_t new_element)
+ * @fn         virutal bool IYaRBt::put(T new_element)
  * @brief      Add a single element to ring buffer.
  * @param      new_element
  *             The new element to add to the ring buffer.
@@ -229,7 +268,7 @@ class IYaRB {
 
 // put() multiple
 /**
- * @fn         virtual bool IYaRB::put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete)
+ * @fn         virtual bool IYaRBt::put(const T *new_elements, size_t nbr_elements, bool only_complete)
  * @brief      Add several new elements to ring buffer.
  * @details    This functions adds several elements to the ring buffer in
  *             an "all or nothing" manner. If the ring buffer is big enough
@@ -255,14 +294,14 @@ class IYaRB {
 
 // get() single
 /**
- * @fn         virtual bool IYaRB::get(uint8_t *returned_element)
+ * @fn         virtual bool IYaRBt::get(T *returned_element)
  * @brief      Get a single element from the ring buffer, thereby removing
  *             it from the buffer.
  * @details    If the ring buffer does not hold any elements (i.e. it is
  *             empty), nothing is written to the memory address of
  *             returned_element.
  * @param[out] returned_element
- *             Pointer to a uint8_t. The returned element is stored in the
+ *             Pointer to a T. The returned element is stored in the
  *             memory address this pointer points to.
  * @return     number of elements removed from ring buffer and copied to
  *             returned_elements (either 0 or 1)
@@ -270,14 +309,14 @@ class IYaRB {
 
 // get() multiple
 /**
- * @fn         virtual bool IYaRB::get(uint8_t *returned_elements, size_t nbr_elements)
+ * @fn         virtual bool IYaRBt::get(T *returned_elements, size_t nbr_elements)
  * @brief      Get several elements from the ring buffer, thereby removing
  *             them from the buffer.
  * @details    At most nbr_elements are written to buffer returned_elements.
  *             If nbr_elements > size(), only size() elements are retrieved
  *             from ring buffer, which is empty after the operation.
  * @param[out] returned_elements
- *             Pointer to a uint8_t. The returend elements are stored  in
+ *             Pointer to a T. The returend elements are stored  in
  *             an array starting at the memory address this pointer points to.
  * @param      nbr_elements
  *             Number of elements to get out of the ring buffer and write
@@ -290,19 +329,55 @@ class IYaRB {
 
 // peek()
 /**
- * @fn         virtual bool IYaRB::peek(uint8_t *peeked_element) const
+ * @fn         virtual bool IYaRBt::peek(T *peeked_element) const
  * @brief      Return next element from the ring buffer while @b not removing it
  *             from the buffer.
  * @param[out] peeked_element
- *             Pointer to a uint8_t. The peeked element is stored 
+ *             Pointer to a T. The peeked element is stored 
  *             at the memory address this pointer points to.
  * @return     number of elements peeked, i.e. copied to peeked_element
  *             (either 0 or 1)
  */
 
+// peek() with offset
+/**
+ * @fn         virtual size_t IYaRBt::peek(T *peeked_element, size_t offset) const
+ * @brief      Return an element from the ring buffer while @b not removing it
+ *             from the buffer.
+ * @param[out] peeked_element
+ *             Pointer to a T. The peeked element is stored 
+ *             at the memory address this pointer points to.
+ * @param      offset
+ *             Position of the element, counted from the next element 
+ *             get() would return. peek(peeked_element, 0) is the same as 
+ *             peek(peeked_element).
+ * @return     number of elements peeked, i.e. copied to peeked_element
+ *             (either 0 or 1). 0 if offset >= size().
+ */
+
+// peek() multiple
+/**
+ * @fn         virtual size_t IYaRBt::peek(T *peeked_elements, size_t nbr_elements, size_t offset) const
+ * @brief      Copy several elements from the ring buffer while @b not 
+ *             removing them from the buffer.
+ * @details    This works exactly like get(peeked_elements, nbr_elements)
+ *             but does not change the contents of the ring buffer. 
+ *             At most size()-offset elements are copied.
+ * @param[out] peeked_elements
+ *             Pointer to a T. The peeked elements are stored in an array
+ *             starting at the memory address this pointer points to.
+ * @param      nbr_elements
+ *             Number of elements to copy to peeked_elements.
+ * @param      offset
+ *             Position of the first element to copy, counted from the next
+ *             element get() would return.
+ * @return     number of elements copied to peeked_elements. 0 if 
+ *             offset >= size().
+ */
+
 // discard()
 /**
- * @fn         virtual size_t IYaRB::discard(size_t nbr_elements)
+ * @fn         virtual size_t IYaRBt::discard(size_t nbr_elements)
  * @brief      Discard (i.e. remove) some elements from ring buffer without
  *             writing them to some output buffer.
  * @param      nbr_elements
@@ -310,10 +385,70 @@ class IYaRB {
  * @return     Number of elements removed from ring buffer. This is
  *             nbr_elements if nbr_elements >= size(), otherwise size().
  */
+
+// writeReserve()
+/**
+ * @fn         virtual size_t IYaRBt::writeReserve(T **region)
+ * @brief      Get direct access to the largest contiguous free region of
+ *             the ring buffer's array, starting at the current write position.
+ * @details    Elements can be written directly to this region (e.g. by a
+ *             decoder or a DMA controller), without an intermediate buffer.
+ *             They become part of the ring buffer contents only after a
+ *             call to commit(). Any other call which adds elements to the 
+ *             ring buffer in the meantime invalidates the region.
+ * @param[out] region
+ *             Pointer to a pointer to T. The start address of the free
+ *             region is stored in the memory address this pointer points to.
+ * @return     Number of elements which can be written to the region. This
+ *             can be smaller than free() when the free space wraps around
+ *             the end of the array. 0 if the ring buffer is full.
+ */
+
+// commit()
+/**
+ * @fn         virtual size_t IYaRBt::commit(size_t nbr_elements)
+ * @brief      Add elements previously written to the region returned by
+ *             writeReserve() to the ring buffer.
+ * @param      nbr_elements
+ *             Number of elements written to the region.
+ * @return     Number of elements added to the ring buffer. This is 
+ *             nbr_elements, or the size of the region returned by
+ *             writeReserve() if nbr_elements is larger.
+ */
+
+// readSpan()
+/**
+ * @fn         virtual size_t IYaRBt::readSpan(const T **region) const
+ * @brief      Get direct access to the largest contiguous region of stored
+ *             elements in the ring buffer's array, starting at the next
+ *             element get() would return.
+ * @details    The elements in this region can be processed in place (e.g.
+ *             by a parser or handed to write()), without copying them out.
+ *             Remove them with consume() afterwards.
+ * @param[out] region
+ *             Pointer to a pointer to const T. The start address of
+ *             the region is stored in the memory address this pointer 
+ *             points to.
+ * @return     Number of elements in the region. This can be smaller than
+ *             size() when the stored elements wrap around the end of the
+ *             array. 0 if the ring buffer is empty.
+ */
+
+// consume()
+/**
+ * @fn         virtual size_t IYaRBt::consume(size_t nbr_elements)
+ * @brief      Remove elements from the ring buffer after they were 
+ *             processed via readSpan().
+ * @details    This is the counterpart to commit() and behaves exactly like
+ *             discard().
+ * @param      nbr_elements
+ *             Number of elements to remove from ring buffer.
+ * @return     Number of elements removed from ring buffer.
+ */
  
 // size()
 /**
- * @fn         virtual bool IYaRB::size(void) const
+ * @fn         virtual bool IYaRBt::size(void) const
  * @brief      Get number of currently used slots in ring buffer.
  * @return     Number of elements which can be gotten out of the to ring
  *             buffer (using get()) before it is empty.
@@ -321,7 +456,7 @@ class IYaRB {
 
 // free()
 /**
- * @fn         virtual bool IYaRB::free(void) const
+ * @fn         virtual bool IYaRBt::free(void) const
  * @brief      Get number of currently free slots in ring buffer.
  * @return     Number of elements which can be added to ring buffer (using
  *             put()) before it is full.
@@ -329,7 +464,7 @@ class IYaRB {
 
 // capacity()
 /**
- * @fn         virtual bool IYaRB::capacity(void) const
+ * @fn         virtual bool IYaRBt::capacity(void) const
  * @brief      Get the total size of this ring buffer instance, i.e. the
  *             maximum number of elements this instance can store.
  * @return     Number of elements which can be stored in this ring buffer
@@ -338,7 +473,7 @@ class IYaRB {
 
 // isFull()
 /**
- * @fn         virtual bool IYaRB::isFull(void) const
+ * @fn         virtual bool IYaRBt::isFull(void) const
  * @brief      Determine if ring buffer is full.
  * @details    put() will return @em false if called on a full ring buffer.
  * @note       Calling isFull() is semantically identical to <em>size() ==
@@ -350,7 +485,7 @@ class IYaRB {
 
 // isEmpty()
 /**
- * @fn         virtual bool IYaRB::isEmpty(void) const
+ * @fn         virtual bool IYaRBt::isEmpty(void) const
  * @brief      Determine if ring buffer is empty.
  * @details    get() will return @em false if called on an empty ring buffer.
  * @note       Calling isEmpty() is semantically identical to <em>size() ==
@@ -361,14 +496,14 @@ class IYaRB {
  */
 
 /**
- * @fn         virtual bool IYaRB::flush(void)
+ * @fn         virtual bool IYaRBt::flush(void)
  * @brief      Clear out all elements stored in the ring buffer.
  * @details    After a call to flush(), isEmpty() will return @em true.
  */
 
 // limit()
 /**
- * @fn         static size_t IYaRB::limit(void)
+ * @fn         static size_t IYaRBt::limit(void)
  * @brief      Show the (theoretical) limit of ring buffer size.
  * @details    The acutual maximum size will be most probably much lower
  *             than this.
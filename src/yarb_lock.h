@@ -0,0 +1,163 @@
+/**
+ * @file    yarb_lock.h
+ * @brief   Critical-section policies for ring buffers with several producers or consumers
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarb_lock_h License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef yarb_lock_h
+#define yarb_lock_h
+
+#include <stddef.h> // needed for size_t data type
+#include <stdint.h> // needed for uint8_t data type
+#include "yarb_interface.h" // YARB_HOSTED
+
+#if defined(__AVR__)
+#include <avr/io.h>        // SREG
+#include <avr/interrupt.h> // cli()
+#endif
+
+#if defined(YARB_HOSTED)
+#include <mutex>
+#endif
+
+/*
+ * Note:
+ * A lock policy protects the few instructions in which a ring buffer
+ * reserves a range of slots or publishes it. Every policy has the same
+ * two member functions:
+ *
+ *     state lock(void);        // enter critical section, return old state
+ *     void  unlock(state s);   // leave critical section, restore state
+ *
+ * Critical sections may be nested (e.g. an ISR which interrupts code 
+ * holding an interrupt lock cannot run, but code which only raised
+ * BASEPRI can be interrupted by higher priorities). Both functions act as
+ * compiler barriers, so no memory access is moved out of the section.
+ *
+ * Only the policies available on the target are defined. Use the macros
+ * YARB_HAS_LOCK_IRQ, YARB_HAS_LOCK_BASEPRI and YARB_HAS_LOCK_MUTEX to
+ * check for them.
+ */
+
+/**
+ * @brief   No protection at all.
+ * @details For a single producer and a single consumer in the same 
+ *          context. This policy costs nothing.
+ */
+struct YaRBLockNone {
+    typedef uint8_t state;                ///< nothing to save
+    state lock(void) { return 0; }
+    void  unlock(state) {}
+};
+
+#if defined(__AVR__) || defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_7M__) || \
+    defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_BASE__) || defined(__ARM_ARCH_8M_MAIN__)
+#define YARB_HAS_LOCK_IRQ 1
+
+/**
+ * @brief   Disable all interrupts (AVR: SREG I-bit, Cortex-M: PRIMASK).
+ * @details Safe for any number of producers and consumers in ISRs of any
+ *          priority and in loop() on a single core. The previous state is 
+ *          restored by unlock(), so it can be used with interrupts
+ *          disabled already.
+ */
+struct YaRBLockIrq {
+#if defined(__AVR__)
+    typedef uint8_t state;                ///< saved SREG
+    state lock(void) {
+        const state s = SREG;
+        cli();
+        __asm__ __volatile__ ("" ::: "memory");
+        return s;
+    }
+    void unlock(state s) {
+        __asm__ __volatile__ ("" ::: "memory");
+        SREG = s;
+    }
+#else
+    typedef uint32_t state;               ///< saved PRIMASK
+    state lock(void) {
+        state s;
+        __asm__ __volatile__ ("mrs %0, primask\n\tcpsid i" : "=r" (s) :: "memory");
+        return s;
+    }
+    void unlock(state s) {
+        __asm__ __volatile__ ("msr primask, %0" :: "r" (s) : "memory");
+    }
+#endif
+};
+#endif
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+#define YARB_HAS_LOCK_BASEPRI 1
+
+/**
+ * @brief   Mask interrupts up to a given priority (Cortex-M3/M4/M7/M33:
+ *          BASEPRI).
+ * @details Only interrupts with a priority value >= LEVEL (i.e. the same
+ *          or lower urgency) are masked, more urgent ones keep running 
+ *          with their normal latency. All ISRs which access the ring buffer
+ *          must have a priority value >= LEVEL. The previous BASEPRI is 
+ *          restored by unlock(), the mask is never lowered by lock().
+ * @tparam  LEVEL
+ *          BASEPRI register value, i.e. the priority already shifted to 
+ *          the implemented upper bits, e.g. (2 << (8 - __NVIC_PRIO_BITS)).
+ *          Must not be 0 (which would not mask anything).
+ */
+template <uint8_t LEVEL>
+struct YaRBLockBasepri {
+    static_assert(LEVEL > 0, "BASEPRI level 0 does not mask any interrupt");
+    typedef uint32_t state;               ///< saved BASEPRI
+    state lock(void) {
+        state s;
+        __asm__ __volatile__ ("mrs %0, basepri\n\tmsr basepri_max, %1" 
+                              : "=&r" (s) : "r" (static_cast<uint32_t>(LEVEL)) : "memory");
+        return s;
+    }
+    void unlock(state s) {
+        __asm__ __volatile__ ("msr basepri, %0" :: "r" (s) : "memory");
+    }
+};
+#endif
+
+#if defined(YARB_HOSTED)
+#define YARB_HAS_LOCK_MUTEX 1
+
+/**
+ * @brief   std::mutex, for several threads on hosted platforms.
+ */
+struct YaRBLockMutex {
+    typedef uint8_t state;                ///< nothing to save
+    state lock(void) { m.lock(); return 0; }
+    void  unlock(state) { m.unlock(); }
+    std::mutex m;                         ///< the mutex
+};
+#endif
+
+#endif // yarb_lock_h
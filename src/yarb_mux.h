@@ -0,0 +1,106 @@
+/**
+ * @file    yarb_mux.h
+ * @brief   Header file for a multiplexer over many message ring buffers
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarb_mux_h License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef yarb_mux_h
+#define yarb_mux_h
+
+#include <stddef.h>  // needed for size_t data type
+#include <stdint.h>  // needed for uint8_t data type
+
+/**
+ * @class   YaRBMux
+ * @brief   Group of message ring buffers (channels) with a bitmap of the
+ *          channels which hold at least one complete message.
+ * @details The group references up to N ring buffers of type RB, which 
+ *          must provide count(), e.g. YaRBc or YaRBct. The bit of a 
+ *          channel is updated whenever data is added or removed through
+ *          the group. nextReady() finds the next channel with a complete
+ *          message with find-first-set instructions, without looking at
+ *          idle channels. The channels are served round-robin.
+ *
+ *          After accessing a ring buffer directly (e.g. put() in an ISR),
+ *          call update() for its channel.
+ * @tparam  RB
+ *          Type of the ring buffers, e.g. YaRBc or YaRBct<64>.
+ * @tparam  N
+ *          Maximum number of channels.
+ * @warning This class is @b not interrupt-safe.
+ */
+template <class RB, size_t N = 16>
+class YaRBMux {
+    public:
+        // sanity checking
+        static_assert(N > 0, "not allowed to instantiate template with N=0");
+
+        // constructor
+        constexpr YaRBMux(void);
+
+        // do not allow copies or assignments
+        YaRBMux(const YaRBMux &mux) = delete;
+        YaRBMux<RB, N>& operator= (const YaRBMux<RB, N> &mux) = delete;
+
+        // attach (or detach with nullptr) a ring buffer to a channel
+        bool   attach(size_t channel, RB *rb);
+        RB*    buffer(size_t channel) const;  // return ring buffer of channel, nullptr if none
+
+        // put element(s) into the ring buffer of a channel
+        size_t put(size_t channel, uint8_t new_element);
+        size_t put(size_t channel, const uint8_t *new_elements, size_t nbr_elements, bool only_complete);
+
+        // remove element(s) or messages from the ring buffer of a channel
+        size_t get(size_t channel, uint8_t *returned_elements, size_t nbr_elements);
+        size_t discard(size_t channel, size_t nbr_elements);
+        size_t getMessage(size_t channel, uint8_t *returned_elements, size_t nbr_elements);
+        size_t discardMessage(size_t channel);
+
+        // readiness
+        void   update(size_t channel);        // update bit after direct access to the ring buffer
+        bool   nextReady(size_t *channel);    // find next channel with a complete message
+        bool   isReady(size_t channel) const; // return true if channel has a complete message
+        bool   anyReady(void) const;          // return true if any channel has a complete message
+
+        static size_t channels(void);         // return maximum number of channels (N)
+
+    private:
+        typedef unsigned long word;           ///< bitmap word, __builtin_ctzl() operates on it
+        static constexpr size_t wordbits = 8 * sizeof(word); ///< bits per bitmap word
+        static constexpr size_t nwords = (N + wordbits - 1) / wordbits; ///< number of bitmap words
+
+        RB     *rbs[N];                       ///< ring buffers of the channels
+        word   ready[nwords];                 ///< bit set: channel has a complete message
+        size_t last;                          ///< channel returned by nextReady() last
+};
+
+// include imlementation file for template here
+#include "yarb_mux.hpp"
+
+#endif // yarb_mux_h
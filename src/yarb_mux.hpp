@@ -0,0 +1,228 @@
+/**
+ * @file    yarb_mux.hpp
+ * @brief   Implementation file for a multiplexer over many message ring buffers
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarb_mux_hpp License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Note:
+ * Channel c is bit (c % wordbits) of ready[c / wordbits]. nextReady() 
+ * starts searching right after the channel it returned last: first the
+ * remaining bits of that word, then the following words, wrapping around.
+ * With up to 32 (or 64) channels, this is one or two find-first-set
+ * instructions, no matter how many channels are idle.
+ */
+
+/**
+ * @brief   The constructor.
+ * @details No ring buffers are attached.
+ */
+template <class RB, size_t N>
+constexpr YaRBMux<RB, N>::YaRBMux(void)
+    : rbs{}, ready{}, last{N - 1} {
+}
+
+/**
+ * @brief   Attach a ring buffer to a channel.
+ * @param   channel
+ *          Channel number, 0 <= channel < N.
+ * @param   rb
+ *          Pointer to the ring buffer, nullptr to detach the channel.
+ *          The ring buffer must outlive the group (or be detached).
+ * @return  @em true on success, @em false if channel is out of range.
+ */
+template <class RB, size_t N>
+bool YaRBMux<RB, N>::attach(size_t channel, RB *rb) {
+    if (channel >= N) {
+        return false;
+    }
+    rbs[channel] = rb;
+    this->update(channel);
+    return true;
+}
+
+/**
+ * @brief   Get the ring buffer of a channel.
+ * @param   channel
+ *          Channel number.
+ * @return  Pointer to the ring buffer, nullptr if none is attached or if
+ *          channel is out of range.
+ */
+template <class RB, size_t N>
+RB* YaRBMux<RB, N>::buffer(size_t channel) const {
+    return (channel < N) ? rbs[channel] : nullptr;
+}
+
+template <class RB, size_t N>
+size_t YaRBMux<RB, N>::put(size_t channel, uint8_t new_element) {
+    RB *rb = this->buffer(channel);
+    if (!rb) {
+        return 0;
+    }
+    const size_t retval = rb->put(new_element);
+    this->update(channel);
+    return retval;
+}
+
+template <class RB, size_t N>
+size_t YaRBMux<RB, N>::put(size_t channel, const uint8_t *new_elements, size_t nbr_elements, bool only_complete) {
+    RB *rb = this->buffer(channel);
+    if (!rb) {
+        return 0;
+    }
+    const size_t retval = rb->put(new_elements, nbr_elements, only_complete);
+    this->update(channel);
+    return retval;
+}
+
+template <class RB, size_t N>
+size_t YaRBMux<RB, N>::get(size_t channel, uint8_t *returned_elements, size_t nbr_elements) {
+    RB *rb = this->buffer(channel);
+    if (!rb) {
+        return 0;
+    }
+    const size_t retval = rb->get(returned_elements, nbr_elements);
+    this->update(channel);
+    return retval;
+}
+
+template <class RB, size_t N>
+size_t YaRBMux<RB, N>::discard(size_t channel, size_t nbr_elements) {
+    RB *rb = this->buffer(channel);
+    if (!rb) {
+        return 0;
+    }
+    const size_t retval = rb->discard(nbr_elements);
+    this->update(channel);
+    return retval;
+}
+
+template <class RB, size_t N>
+size_t YaRBMux<RB, N>::getMessage(size_t channel, uint8_t *returned_elements, size_t nbr_elements) {
+    RB *rb = this->buffer(channel);
+    if (!rb) {
+        return 0;
+    }
+    const size_t retval = rb->getMessage(returned_elements, nbr_elements);
+    this->update(channel);
+    return retval;
+}
+
+template <class RB, size_t N>
+size_t YaRBMux<RB, N>::discardMessage(size_t channel) {
+    RB *rb = this->buffer(channel);
+    if (!rb) {
+        return 0;
+    }
+    const size_t retval = rb->discardMessage();
+    this->update(channel);
+    return retval;
+}
+
+/**
+ * @brief   Update the bit of a channel from the count() of its ring buffer.
+ * @details Call this after accessing the ring buffer directly. O(1).
+ * @param   channel
+ *          Channel number. Channels out of range are ignored.
+ */
+template <class RB, size_t N>
+void YaRBMux<RB, N>::update(size_t channel) {
+    if (channel >= N) {
+        return;
+    }
+    const word mask = static_cast<word>(1) << (channel % wordbits);
+    if (rbs[channel] && rbs[channel]->count() > 0) {
+        ready[channel / wordbits] |= mask;
+    }
+    else {
+        ready[channel / wordbits] &= ~mask;
+    }
+}
+
+/**
+ * @brief   Find the next channel with at least one complete message.
+ * @details The search starts after the channel found last, so all ready
+ *          channels are served in turn.
+ * @param[out] channel
+ *          Pointer to a size_t. The channel number is stored there.
+ * @return  @em true if a channel was found, @em false if no channel has
+ *          a complete message (channel is not changed then).
+ */
+template <class RB, size_t N>
+bool YaRBMux<RB, N>::nextReady(size_t *channel) {
+    // check validity of output pointer (may be nullptr)
+    if (!channel) {
+        return false;
+    }
+    const size_t start = (last + 1 == N) ? 0 : (last + 1);
+    size_t w = start / wordbits;
+    // bits of the first word below start are only checked after wrapping
+    word bits = ready[w] & (~static_cast<word>(0) << (start % wordbits));
+    for (size_t i = 0; i <= nwords; i++) {
+        if (bits) {
+            last = w * wordbits + __builtin_ctzl(bits);
+            *channel = last;
+            return true;
+        }
+        w = (w + 1 == nwords) ? 0 : (w + 1);
+        bits = ready[w];
+    }
+    return false;
+}
+
+/**
+ * @brief   Check if a channel has at least one complete message.
+ * @param   channel
+ *          Channel number.
+ * @return  @em true if the channel has a complete message.
+ */
+template <class RB, size_t N>
+bool YaRBMux<RB, N>::isReady(size_t channel) const {
+    if (channel >= N) {
+        return false;
+    }
+    return (ready[channel / wordbits] >> (channel % wordbits)) & 1;
+}
+
+/**
+ * @brief   Check if any channel has at least one complete message.
+ * @return  @em true if at least one channel has a complete message.
+ */
+template <class RB, size_t N>
+bool YaRBMux<RB, N>::anyReady(void) const {
+    for (size_t w = 0; w < nwords; w++) {
+        if (ready[w]) return true;
+    }
+    return false;
+}
+
+template <class RB, size_t N>
+size_t YaRBMux<RB, N>::channels(void) {
+    return N;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file    yarb_pool.cpp
+ * @brief   Implementation file for a fixed-size block pool for ring buffer storage
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarb_pool_cpp License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "yarb_pool.h"
+
+#include <string.h>  // memcpy()
+
+/*
+ * Note:
+ * The link to the next free block is stored in the first bytes of each
+ * free block. It is read and written with memcpy(), so the blocks need 
+ * not be aligned for pointers.
+ */
+
+/**
+ * @brief   The constructor.
+ * @param   memory
+ *          Start of the memory region to manage. The region must outlive
+ *          the pool and all ring buffers using it.
+ * @param   memory_size
+ *          Size of the memory region in bytes. Bytes not making up a 
+ *          complete block remain unused.
+ * @param   block_size
+ *          Size of each block in bytes, see YaRB::storageSize(), 
+ *          YaRB2::storageSize() and YaRBc::storageSize(). Rounded up to 
+ *          the size of a pointer.
+ */
+YaRBPool::YaRBPool(uint8_t *memory, size_t memory_size, size_t block_size)
+    : mem{memory}, 
+      bsize{(block_size < sizeof(uint8_t*)) ? sizeof(uint8_t*) : block_size},
+      nblocks{memory ? memory_size / bsize : 0}, nfree{0}, head{nullptr} {
+    // link all blocks, the first block becomes the head of the list
+    for (size_t i = nblocks; i > 0; i--) {
+        this->release(mem + (i-1) * bsize);
+    }
+}
+
+/**
+ * @brief   Take a block from the pool.
+ * @return  Pointer to a block of blockSize() bytes, nullptr if all blocks
+ *          are in use.
+ */
+uint8_t* YaRBPool::acquire(void) {
+    uint8_t *block = head;
+    if (block) {
+        memcpy(&head, block, sizeof(uint8_t*));
+        nfree--;
+    }
+    return block;
+}
+
+/**
+ * @brief   Give a block back to the pool.
+ * @param   block
+ *          Pointer to (anywhere within) a block returned by acquire(). 
+ *          nullptr and pointers outside of the pool's memory region are
+ *          ignored.
+ */
+void YaRBPool::release(uint8_t *block) {
+    // check validity of input pointer (may be nullptr)
+    if (!block || block < mem || block >= mem + nblocks * bsize) {
+        return;
+    }
+    // round down to the start of the block
+    block -= (block - mem) % bsize;
+    memcpy(block, &head, sizeof(uint8_t*));
+    head = block;
+    nfree++;
+}
+
+size_t YaRBPool::blockSize(void) const {
+    return bsize;
+}
+
+size_t YaRBPool::blocks(void) const {
+    return nblocks;
+}
+
+size_t YaRBPool::available(void) const {
+    return nfree;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file    yarb_pool.h
+ * @brief   Header file for a fixed-size block pool for ring buffer storage
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarb_pool_h License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef yarb_pool_h
+#define yarb_pool_h
+
+#include <stddef.h>  // needed for size_t data type
+#include <stdint.h>  // needed for uint8_t data type
+
+/**
+ * @class   YaRBPool
+ * @brief   Pool of fixed-size memory blocks for the storage of the regular
+ *          ring buffers (YaRB, YaRB2, YaRBc).
+ * @details The pool manages a caller-owned memory region (e.g. a static
+ *          array), which is split into blocks of equal size. A ring buffer
+ *          constructed with a pool takes one block and gives it back in its
+ *          destructor. There is no heap allocation and no fragmentation, 
+ *          acquiring and releasing a block is O(1).
+ *
+ *          The free blocks are kept in a singly linked list, stored in the
+ *          free blocks themselves. No additional memory is needed.
+ * @note    The block size is at least the size of a pointer.
+ * @warning This class is @b not thread-safe (nor interrupt-safe). Use one 
+ *          pool per thread or protect the construction and destruction of
+ *          the ring buffers.
+ */
+class YaRBPool {
+    public:
+        // constructor
+        YaRBPool(uint8_t *memory, size_t memory_size, size_t block_size);
+
+        // do not allow copies or assignments:
+        // blocks are handed out by exactly one pool
+        YaRBPool(const YaRBPool &pool) = delete;
+        YaRBPool& operator= (const YaRBPool &pool) = delete;
+
+        uint8_t* acquire(void);               // take a block, nullptr if none is left
+        void     release(uint8_t *block);     // give a block back (pointer may point into it)
+
+        size_t blockSize(void) const;         // return size of each block in bytes
+        size_t blocks(void) const;            // return total number of blocks
+        size_t available(void) const;         // return number of free blocks
+
+    private:
+        uint8_t * const mem;   ///< start of the managed memory region
+        const size_t  bsize;   ///< size of each block
+        const size_t  nblocks; ///< total number of blocks
+        size_t  nfree;         ///< number of free blocks
+        uint8_t *head;         ///< first free block, nullptr if none
+};
+
+#endif // yarb_pool_h
@@ -0,0 +1,121 @@
+/**
+ * @file    yarb_stats.h
+ * @brief   Opt-in statistics (instrumentation) for ring buffers
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarb_stats_h License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef yarb_stats_h
+#define yarb_stats_h
+
+#include <stddef.h>  // needed for size_t data type
+#include <stdint.h>  // needed for uint32_t data type
+
+/*
+ * Note:
+ * The statistics help to choose the capacity of a ring buffer: peak
+ * shows how close to full the buffer got, rejected and refusals show
+ * whether (and how often) it overflowed.
+ *
+ * The templated ring buffers take a policy as template parameter:
+ * YaRBNoStats (default) has only empty inline functions, which are
+ * optimized away completely. YaRBWithStats holds a YaRBStats and adds
+ * the functions stats() and resetStats() to the ring buffer.
+ *
+ * The regular classes cannot be changed at compile time by the sketch.
+ * Instead, a YaRBStats is attached with attachStats(). Without one 
+ * attached, the cost is a single comparison per call.
+ *
+ * The totals are 32 bit wide even on AVR, as 16 bit overflow after 
+ * a few seconds on a fast serial line. total_in - total_out is always 
+ * the current size() (modulo 2^32), given counting started with an 
+ * empty ring buffer.
+ */
+
+/**
+ * @brief   Counters collected by a ring buffer.
+ */
+struct YaRBStats {
+    size_t   peak = 0;            ///< highest size() after adding elements (high-water mark)
+    size_t   rejected = 0;        ///< number of elements put() did not add, including refusals
+    size_t   refusals = 0;        ///< number of put() calls refused because of only_complete
+    size_t   overwritten = 0;     ///< number of elements lost in overwrite mode
+    size_t   empty_gets = 0;      ///< number of get() calls on an empty ring buffer
+    uint32_t total_in = 0;        ///< total number of elements added
+    uint32_t total_out = 0;       ///< total number of elements removed (including discarded ones)
+
+    // set all counters to zero
+    void reset(void) { *this = YaRBStats(); }
+
+    // called by the ring buffers
+    void added(size_t requested, size_t nbr_added, size_t used) {
+        total_in += nbr_added;
+        rejected += requested - nbr_added;
+        if (used > peak) peak = used;
+    }
+    void refused(size_t requested) { refusals++; rejected += requested; }
+    void removed(size_t nbr_removed) { total_out += nbr_removed; }
+    void dropped(size_t nbr_dropped) { overwritten += nbr_dropped; }
+    void emptyGet(void) { empty_gets++; }
+};
+
+/**
+ * @brief   Statistics policy for templated ring buffers: no statistics.
+ */
+class YaRBNoStats {
+    protected:
+        void statsAdded(size_t, size_t, size_t) {}
+        void statsRefused(size_t) {}
+        void statsRemoved(size_t) {}
+        void statsDropped(size_t) {}
+        void statsEmptyGet(void) {}
+};
+
+/**
+ * @brief   Statistics policy for templated ring buffers: collect 
+ *          statistics in a YaRBStats.
+ */
+class YaRBWithStats {
+    public:
+        constexpr YaRBWithStats(void) : st() {}
+
+        // access to the statistics
+        const YaRBStats& stats(void) const { return st; }
+        void resetStats(void) { st.reset(); }
+
+    protected:
+        YaRBStats st;      ///< the counters
+
+        void statsAdded(size_t requested, size_t nbr_added, size_t used) { st.added(requested, nbr_added, used); }
+        void statsRefused(size_t requested) { st.refused(requested); }
+        void statsRemoved(size_t nbr_removed) { st.removed(nbr_removed); }
+        void statsDropped(size_t nbr_dropped) { st.dropped(nbr_dropped); }
+        void statsEmptyGet(void) { st.emptyGet(); }
+};
+
+#endif // yarb_stats_h
@@ -0,0 +1,111 @@
+/**
+ * @file    yarb_stream.h
+ * @brief   Header file for an Arduino Stream backed by a ring buffer
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarb_stream_h License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef yarb_stream_h
+#define yarb_stream_h
+
+#if defined(ARDUINO)
+
+#include <Arduino.h> // Stream, millis()
+#include <string.h>  // memchr()
+#include "yarb_interface.h"
+#include "yarbc.h"
+
+/**
+ * @class   YaRBStream
+ * @brief   Arduino Stream which reads from and writes to a ring buffer.
+ * @details All data written to the stream (print(), write()) is added to
+ *          the ring buffer, all data read from the stream is removed from
+ *          it. This allows to pass a ring buffer to libraries which 
+ *          expect a Stream&.
+ *
+ *          Bulk write() and readBytes() are forwarded to the bulk put() and
+ *          get() of the ring buffer. readBytesUntil() with the delimiter of
+ *          a YaRBc or YaRBct uses its recorded message positions instead of
+ *          looking at each byte. As the type of the ring buffer is a template
+ *          parameter and all ring buffers are final, read(), peek() and 
+ *          available() are direct calls, not virtual ones.
+ * @tparam  RB
+ *          Type of the ring buffer: any implementation of IYaRB.
+ * @note    readBytes() and readBytesUntil() are not virtual in all Arduino
+ *          cores. Call them on the YaRBStream (not on a Stream&) to get 
+ *          the bulk versions.
+ * @note    flush() does nothing (as for Serial, it waits until all written
+ *          data is "sent"). Call flush() of the ring buffer to discard data.
+ */
+template <class RB>
+class YaRBStream final : public Stream {
+    public:
+        // constructor
+        YaRBStream(RB &ringbuffer);
+
+        // do not allow copies or assignments
+        YaRBStream(const YaRBStream &s) = delete;
+        YaRBStream<RB>& operator= (const YaRBStream<RB> &s) = delete;
+
+        // Stream interface
+        virtual int    available(void) override;
+        virtual int    read(void) override;
+        virtual int    peek(void) override;
+
+        // Print interface
+        virtual size_t write(uint8_t c) override;
+        virtual size_t write(const uint8_t *buffer, size_t size) override;
+        virtual int    availableForWrite(void);  // not virtual in older cores --> no override
+        virtual void   flush(void) override;
+        using Print::write; // write(const char*) etc.
+
+        // bulk versions of the Stream functions
+        size_t readBytes(char *buffer, size_t length);
+        size_t readBytes(uint8_t *buffer, size_t length);
+        size_t readBytesUntil(char terminator, char *buffer, size_t length);
+        size_t readBytesUntil(char terminator, uint8_t *buffer, size_t length);
+
+        RB&    buffer(void);  // return the ring buffer
+
+    private:
+        RB &rb;               ///< ring buffer all data is stored in
+
+        // find first terminator in the first n stored bytes, return the
+        // number of bytes up to and including it, 0 if none
+        static size_t findTerminator(const IYaRB &r, uint8_t terminator, size_t n);
+        static size_t findTerminator(YaRBc &r, uint8_t terminator, size_t n);
+        template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+        static size_t findTerminator(YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX> &r, uint8_t terminator, size_t n);
+};
+
+// include imlementation file for template here
+#include "yarb_stream.hpp"
+
+#endif // defined(ARDUINO)
+
+#endif // yarb_stream_h
@@ -0,0 +1,256 @@
+/**
+ * @file    yarb_stream.hpp
+ * @brief   Implementation file for an Arduino Stream backed by a ring buffer
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarb_stream_hpp License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Note:
+ * The ring buffer may be filled from an ISR while readBytes() or 
+ * readBytesUntil() wait for more data. readBytesUntil() therefore takes
+ * a snapshot of size() first and never removes more than these bytes
+ * unless it has found the terminator among them. As bytes are only 
+ * added, the terminator cannot be overtaken.
+ */
+
+/**
+ * @brief   The constructor.
+ * @param   ringbuffer
+ *          The ring buffer. It must outlive the stream.
+ */
+template <class RB>
+YaRBStream<RB>::YaRBStream(RB &ringbuffer)
+    : Stream(), rb(ringbuffer) {
+}
+
+/**
+ * @brief   Number of bytes available for reading.
+ * @return  size() of the ring buffer.
+ */
+template <class RB>
+int YaRBStream<RB>::available(void) {
+    return static_cast<int>(rb.size());
+}
+
+/**
+ * @brief   Read one byte.
+ * @return  The byte, -1 if the ring buffer is empty.
+ */
+template <class RB>
+int YaRBStream<RB>::read(void) {
+    uint8_t c;
+    return rb.get(&c) ? c : -1;
+}
+
+/**
+ * @brief   Look at the next byte without removing it.
+ * @return  The byte, -1 if the ring buffer is empty.
+ */
+template <class RB>
+int YaRBStream<RB>::peek(void) {
+    uint8_t c;
+    return rb.peek(&c) ? c : -1;
+}
+
+/**
+ * @brief   Write one byte.
+ * @return  1 on success, 0 if the ring buffer is full.
+ */
+template <class RB>
+size_t YaRBStream<RB>::write(uint8_t c) {
+    return rb.put(c);
+}
+
+/**
+ * @brief   Write several bytes with one bulk put().
+ * @return  Number of bytes written. This is less than size if the
+ *          ring buffer becomes full.
+ */
+template <class RB>
+size_t YaRBStream<RB>::write(const uint8_t *buffer, size_t size) {
+    return rb.put(buffer, size, false);
+}
+
+/**
+ * @brief   Number of bytes which can be written without blocking.
+ * @return  free() of the ring buffer.
+ */
+template <class RB>
+int YaRBStream<RB>::availableForWrite(void) {
+    return static_cast<int>(rb.free());
+}
+
+template <class RB>
+void YaRBStream<RB>::flush(void) {
+    // nothing to do, all written bytes are in the ring buffer already
+}
+
+/**
+ * @brief   Read bytes with bulk get() until length bytes are read or the
+ *          timeout (setTimeout()) has expired.
+ * @details As for Stream, the timeout applies to each wait for new bytes,
+ *          not to the whole call: it starts again whenever bytes are read.
+ * @param   buffer
+ *          Pointer to an array of at least length bytes.
+ * @param   length
+ *          Number of bytes to read.
+ * @return  Number of bytes read.
+ */
+template <class RB>
+size_t YaRBStream<RB>::readBytes(uint8_t *buffer, size_t length) {
+    if (!buffer) {
+        return 0;
+    }
+    size_t nbr_read = rb.get(buffer, length);
+    unsigned long start = millis();
+    while (nbr_read < length && millis() - start < _timeout) {
+        const size_t nbr_new = rb.get(buffer+nbr_read, length-nbr_read);
+        if (nbr_new) {
+            // as for Stream, wait up to the timeout for each new byte
+            nbr_read += nbr_new;
+            start = millis();
+        }
+    }
+    return nbr_read;
+}
+
+template <class RB>
+size_t YaRBStream<RB>::readBytes(char *buffer, size_t length) {
+    return this->readBytes(reinterpret_cast<uint8_t*>(buffer), length);
+}
+
+/**
+ * @brief   Read bytes until the terminator is found, length bytes are
+ *          read or the timeout (setTimeout()) has expired.
+ * @details As for Stream, the terminator is removed but not stored in
+ *          buffer. If length bytes are read before the terminator (also
+ *          when the terminator directly follows them), the terminator 
+ *          stays in the ring buffer. If the terminator is the delimiter of a YaRBc or 
+ *          YaRBct, its position is known without searching. The timeout
+ *          starts again whenever bytes are read, see readBytes().
+ * @param   terminator
+ *          Byte which ends reading.
+ * @param   buffer
+ *          Pointer to an array of at least length bytes.
+ * @param   length
+ *          Maximum number of bytes to read.
+ * @return  Number of bytes stored in buffer (without the terminator).
+ */
+template <class RB>
+size_t YaRBStream<RB>::readBytesUntil(char terminator, uint8_t *buffer, size_t length) {
+    if (!buffer || length == 0) {
+        return 0;
+    }
+    const uint8_t t = static_cast<uint8_t>(terminator);
+    size_t nbr_read = 0;
+    unsigned long start = millis();
+    do {
+        const size_t used = rb.size();
+        const size_t found = findTerminator(rb, t, used);
+        if (found) {
+            if (found - 1 >= length - nbr_read) {
+                // buffer too small or filled exactly: as for Stream, stop at
+                // length and leave rest (and terminator) in ring buffer
+                return nbr_read + rb.get(buffer+nbr_read, length-nbr_read);
+            }
+            nbr_read += rb.get(buffer+nbr_read, found - 1);
+            rb.discard(1);
+            return nbr_read;
+        }
+        // none of the used bytes is the terminator
+        if (used) {
+            nbr_read += rb.get(buffer+nbr_read, (used < length-nbr_read) ? used : (length-nbr_read));
+            start = millis();
+        }
+    } while (nbr_read < length && millis() - start < _timeout);
+    return nbr_read;
+}
+
+template <class RB>
+size_t YaRBStream<RB>::readBytesUntil(char terminator, char *buffer, size_t length) {
+    return this->readBytesUntil(terminator, reinterpret_cast<uint8_t*>(buffer), length);
+}
+
+template <class RB>
+RB& YaRBStream<RB>::buffer(void) {
+    return rb;
+}
+
+/**
+ * @brief   Find the terminator in any ring buffer.
+ * @details The bytes are copied out with bulk peek() in small chunks, 
+ *          which are searched with memchr().
+ * @param   r
+ *          The ring buffer.
+ * @param   terminator
+ *          Byte to search for.
+ * @param   n
+ *          Number of bytes to search, counted from the oldest byte.
+ * @return  Number of bytes up to and including the terminator, 0 if the
+ *          terminator is not within the first n bytes.
+ */
+template <class RB>
+size_t YaRBStream<RB>::findTerminator(const IYaRB &r, uint8_t terminator, size_t n) {
+    uint8_t chunk[16];
+    for (size_t offset = 0; offset < n; offset += sizeof(chunk)) {
+        const size_t len = r.peek(chunk, (n-offset < sizeof(chunk)) ? (n-offset) : sizeof(chunk), offset);
+        const void *p = memchr(chunk, terminator, len);
+        if (p) {
+            return offset + (static_cast<const uint8_t*>(p) - chunk) + 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief   Find the terminator in a YaRBc.
+ * @details If the terminator is the delimiter, messageLength() is used.
+ */
+template <class RB>
+size_t YaRBStream<RB>::findTerminator(YaRBc &r, uint8_t terminator, size_t n) {
+    if (terminator != r.delimiter()) {
+        return findTerminator(static_cast<const IYaRB&>(r), terminator, n);
+    }
+    const size_t len = r.messageLength();
+    return (len <= n) ? len : 0;
+}
+
+/**
+ * @brief   Find the terminator in a YaRBct.
+ * @details If the terminator is the delimiter, messageLength() is used.
+ */
+template <class RB>
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBStream<RB>::findTerminator(YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX> &r, uint8_t terminator, size_t n) {
+    if (terminator != r.delimiter()) {
+        return findTerminator(static_cast<const IYaRB&>(r), terminator, n);
+    }
+    const size_t len = r.messageLength();
+    return (len <= n) ? len : 0;
+}
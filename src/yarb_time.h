@@ -0,0 +1,219 @@
+/**
+ * @file    yarb_time.h
+ * @brief   Per-message arrival timestamps for YaRBc and YaRBct
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarb_time_h License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef yarb_time_h
+#define yarb_time_h
+
+#include <stddef.h> // needed for size_t data type
+#include <stdint.h> // needed for uint32_t data type
+
+#if defined(ARDUINO)
+#include <Arduino.h> // micros()
+#endif
+
+/*
+ * Note:
+ * A message gets its timestamp when its delimiter is put into the ring 
+ * buffer, i.e. when it is complete. The time a message spends in the 
+ * ring buffer (its residency) is the difference between the timestamp and
+ * the time it is removed.
+ *
+ * The clock is a class with one static function returning the current
+ * time as uint32_t in any unit, e.g. YaRBMicros (micros()) or a class
+ * reading a cycle counter:
+ *
+ *     static uint32_t now(void);
+ *
+ * Differences are calculated modulo 2^32, so a clock overflowing is not
+ * a problem, as long as no message stays longer than one period.
+ *
+ * Timestamps cannot be calculated afterwards. Only the timestamps of the
+ * oldest N messages are stored, a message completed while N older 
+ * messages are waiting has none.
+ *
+ * The templated ring buffers take the tracker as template parameter,
+ * YaRBNoTime (default) has only empty inline functions and is optimized
+ * away completely. A YaRBc gets a tracker attached with 
+ * attachTimestamps(), without one attached, the cost is a single 
+ * comparison per call.
+ */
+
+/**
+ * @class   IYaRBTime
+ * @brief   Interface of a per-message timestamp tracker, as used by YaRBc.
+ */
+class IYaRBTime {
+    public:
+        // delimiters were added to the ring buffer
+        virtual void added(size_t nbr_delims) = 0;
+        // the oldest delimiters were removed from the ring buffer
+        virtual void removed(size_t nbr_delims) = 0;
+        // start over, the ring buffer holds nbr_delims delimiters without timestamp
+        virtual void reset(size_t nbr_delims) = 0;
+        // get timestamp of the oldest message, false if there is none
+        virtual bool first(uint32_t *timestamp) const = 0;
+        virtual ~IYaRBTime() = default;
+};
+
+/**
+ * @class   YaRBTimestamps
+ * @brief   Per-message timestamp tracker with optional residency histogram.
+ * @details Use it as timestamp policy of YaRBct or attach it to a YaRBc 
+ *          with attachTimestamps().
+ * @tparam  CLOCK
+ *          The clock, e.g. YaRBMicros.
+ * @tparam  N
+ *          Number of timestamps to store.
+ * @tparam  BINS
+ *          Number of histogram bins, 0 for no histogram. Bin 0 counts 
+ *          residencies of 0 and 1, bin k residencies from 2^k to 
+ *          2^(k+1)-1, the last bin all longer ones.
+ */
+template <class CLOCK, size_t N = 8, size_t BINS = 0>
+class YaRBTimestamps : public IYaRBTime {
+    public:
+        static_assert(N > 0, "not allowed to instantiate template with N=0");
+        static_assert(BINS <= 32, "more than 32 bins are never used");
+
+        YaRBTimestamps(void) : stamps{}, first_stamp{0}, known{0}, unknown{0}, hist{}, longest{0} {}
+
+        void added(size_t nbr_delims) override;
+        void removed(size_t nbr_delims) override;
+        void reset(size_t nbr_delims) override;
+        bool first(uint32_t *timestamp) const override;
+
+        // residency histogram, only with BINS > 0
+        static size_t bins(void) { return BINS; }   // return number of bins
+        uint32_t histogram(size_t bin) const;       // return count of bin
+        uint32_t maxResidency(void) const { return longest; } // return longest residency seen
+        void     resetHistogram(void);              // set all bins to zero
+
+    private:
+        uint32_t stamps[N];                 ///< timestamps of the oldest complete messages
+        size_t   first_stamp;               ///< index of oldest timestamp
+        size_t   known;                     ///< number of stored timestamps
+        size_t   unknown;                   ///< number of newer messages without timestamp
+        uint32_t hist[BINS ? BINS : 1];     ///< residency histogram
+        uint32_t longest;                   ///< longest residency seen
+
+        static size_t bin(uint32_t residency);
+};
+
+/**
+ * @brief   No timestamps at all, the default policy of YaRBct. Costs nothing.
+ */
+struct YaRBNoTime {
+    void added(size_t) {}
+    void removed(size_t) {}
+    void reset(size_t) {}
+};
+
+#if defined(ARDUINO)
+/**
+ * @brief   Clock for YaRBTimestamps using micros().
+ */
+struct YaRBMicros {
+    static uint32_t now(void) { return micros(); }
+};
+#endif
+
+template <class CLOCK, size_t N, size_t BINS>
+void YaRBTimestamps<CLOCK, N, BINS>::added(size_t nbr_delims) {
+    if (unknown == 0 && known < N) {
+        // all messages of one call get the same timestamp
+        const uint32_t t = CLOCK::now();
+        while (nbr_delims && known < N) {
+            size_t slot = first_stamp + known;
+            if (slot >= N) slot -= N;
+            stamps[slot] = t;
+            known++;
+            nbr_delims--;
+        }
+    }
+    unknown += nbr_delims;
+}
+
+template <class CLOCK, size_t N, size_t BINS>
+void YaRBTimestamps<CLOCK, N, BINS>::removed(size_t nbr_delims) {
+    size_t k = (nbr_delims < known) ? nbr_delims : known;
+    if (BINS && k) {
+        const uint32_t t = CLOCK::now();
+        for (size_t i=0; i<k; i++) {
+            size_t slot = first_stamp + i;
+            if (slot >= N) slot -= N;
+            const uint32_t residency = t - stamps[slot];
+            hist[bin(residency)]++;
+            if (residency > longest) longest = residency;
+        }
+    }
+    known -= k;
+    first_stamp += k;
+    if (first_stamp >= N) first_stamp -= N;
+    nbr_delims -= k;
+    unknown = (nbr_delims < unknown) ? (unknown - nbr_delims) : 0;
+}
+
+template <class CLOCK, size_t N, size_t BINS>
+void YaRBTimestamps<CLOCK, N, BINS>::reset(size_t nbr_delims) {
+    first_stamp = 0;
+    known = 0;
+    unknown = nbr_delims;
+}
+
+template <class CLOCK, size_t N, size_t BINS>
+bool YaRBTimestamps<CLOCK, N, BINS>::first(uint32_t *timestamp) const {
+    if (known == 0) {
+        return false;
+    }
+    *timestamp = stamps[first_stamp];
+    return true;
+}
+
+template <class CLOCK, size_t N, size_t BINS>
+uint32_t YaRBTimestamps<CLOCK, N, BINS>::histogram(size_t bin) const {
+    return (bin < BINS) ? hist[bin] : 0;
+}
+
+template <class CLOCK, size_t N, size_t BINS>
+void YaRBTimestamps<CLOCK, N, BINS>::resetHistogram(void) {
+    for (size_t i=0; i<BINS; i++) hist[i] = 0;
+    longest = 0;
+}
+
+template <class CLOCK, size_t N, size_t BINS>
+size_t YaRBTimestamps<CLOCK, N, BINS>::bin(uint32_t residency) {
+    // floor(log2(residency)) with a single instruction on most CPUs
+    const size_t b = (residency > 1) ? (8*sizeof(unsigned long) - 1 - __builtin_clzl(residency)) : 0;
+    return (b < BINS) ? b : (BINS - 1);
+}
+
+#endif // yarb_time_h
@@ -32,10 +32,20 @@
 
 #include "yarbc.h"
 
-#include <string.h>  // memcpy(), for copy constructor
+#include <string.h>  // memcpy(), memchr()
 
 /* YaRBc */
 
+/*
+ * Note:
+ * A moved-from YaRBc has a capacity of 0, but it still needs its two 
+ * (minimal) arrays. All moved-from instances share them, so moving never
+ * allocates. The same holds for a YaRBc whose caller-owned storage or 
+ * pool block is missing or too small.
+ */
+static uint8_t yarbc_moved_from[1];
+static size_t  yarbc_moved_from_msg[1];
+
 /*
  * Note:
  * Some method implementations are exactly the same as for YaRB, namely
@@ -46,9 +56,22 @@
  * 
  * The following methods are modified to facilitate the counter:
  * 
- * put(), get(), discard(), flush()
+ * put(), get(), discard(), flush(), commit()
  * 
- * There is one new method not inherited from IYaRB: count()
+ * There are new methods not inherited from IYaRB: count(), messageLength(),
+ * getMessage(), discardMessage()
+ *
+ * To find messages without scanning the data, the positions of the first
+ * (oldest) msgcap delimiters in the buffer are kept in a small ring
+ * (msgarray) while they are added. When more delimiters arrive than fit
+ * into msgarray, their positions are not recorded. Once all recorded 
+ * messages are removed, the buffer is scanned (with memchr()) once from
+ * the current readindex to record the next delimiters. This way, every
+ * byte is examined at most once, even if the ring was too small.
+ *
+ * Invariant: msgarray holds the positions of the first msgct delimiters,
+ * msgct <= ct. If msgct < ct, the positions of the remaining delimiters
+ * are unknown.
  */
  
 /**
@@ -64,23 +87,119 @@
  *          the ring buffer will increase the value returned by count()
  *          by one. Removing a byte with this value (get(), discard(), 
  *          flush()) will decreases this value.
+ * @param   msgindex
+ *          Number of delimiter positions to record for messageLength(),
+ *          getMessage() and discardMessage(). If more messages are in the
+ *          buffer, the positions of the surplus delimiters are found by
+ *          scanning the buffer once when needed. At least one position
+ *          is always recorded.
+ * @param   overwrite
+ *          If true, put() never fails: when the ring buffer is full, the
+ *          oldest elements are dropped to make room for the new ones
+ *          (and count() is decreased for dropped delimiters).
+ *          If false (default), new elements are dropped instead.
  * @note    capacity is the effectively usable capacity of the ring buffer.
  *          This implementation allocates one additional byte internally.
  */
-YaRBc::YaRBc(size_t capacity, uint8_t delimiter) 
-    : cap{capacity+1}, delim{delimiter}, readindex{0}, writeindex{0}, arraypointer{nullptr}, ct{0} {
+YaRBc::YaRBc(size_t capacity, uint8_t delimiter, size_t msgindex, bool overwrite) 
+    : cap{capacity+1}, delim{delimiter}, ovw{overwrite}, readindex{0}, writeindex{0}, arraypointer{nullptr}, ct{0},
+      msgarray{nullptr}, msgcap{msgindex ? msgindex : 1}, msgfirst{0}, msgct{0}, 
+      own{true}, pool{nullptr}, st{nullptr}, crc{nullptr}, ts{nullptr} {
     arraypointer = new uint8_t[cap];
+    msgarray = new size_t[msgcap];
+}
+
+/**
+ * @brief   Constructor using caller-owned storage.
+ * @details No memory is allocated. The storage holds both the recorded
+ *          delimiter positions (at its aligned start) and the array. The 
+ *          storage must outlive the ring buffer.
+ * @param   storage
+ *          Start of the storage, e.g. a static array or a part of an arena.
+ * @param   storage_size
+ *          Size of the storage in bytes. Use storageSize() to get the
+ *          size for a given capacity. If storage is nullptr or too small,
+ *          the ring buffer has a capacity of 0 (nothing is allocated).
+ * @param   delimiter
+ *          Message delimiter, see YaRBc(size_t, uint8_t, size_t, bool).
+ * @param   msgindex
+ *          Number of delimiter positions to record, see 
+ *          YaRBc(size_t, uint8_t, size_t, bool).
+ * @param   overwrite
+ *          Overwrite mode, see YaRBc(size_t, uint8_t, size_t, bool).
+ */
+YaRBc::YaRBc(uint8_t *storage, size_t storage_size, uint8_t delimiter, size_t msgindex, bool overwrite) 
+    : cap{storageCap(storage, storage_size, msgindex)}, delim{delimiter}, ovw{overwrite}, 
+      readindex{0}, writeindex{0}, arraypointer{nullptr}, ct{0},
+      msgarray{nullptr}, msgcap{msgindex ? msgindex : 1}, msgfirst{0}, msgct{0}, 
+      own{false}, pool{nullptr}, st{nullptr}, crc{nullptr}, ts{nullptr} {
+    if (storage && storage_size >= storageSize(0, msgindex)) {
+        // delimiter positions first (aligned), then the array
+        const size_t pad = padding(storage);
+        msgarray = reinterpret_cast<size_t*>(storage + pad);
+        arraypointer = storage + pad + msgcap * sizeof(size_t);
+    }
+    else {
+        // storage is unusable: capacity 0, never allocate
+        // (see yarbc_moved_from)
+        arraypointer = yarbc_moved_from;
+        msgarray = yarbc_moved_from_msg;
+        msgcap = 1;
+    }
+}
+
+/**
+ * @brief   Constructor using a block from a pool as storage.
+ * @details The block is given back to the pool by the destructor. The
+ *          capacity is the capacity that fits into pool.blockSize() bytes
+ *          (see storageSize()), or 0 if there is no free block or the 
+ *          blocks are too small.
+ * @param   pool
+ *          The pool to take the block from. 
+ * @param   delimiter
+ *          Message delimiter, see YaRBc(size_t, uint8_t, size_t, bool).
+ * @param   msgindex
+ *          Number of delimiter positions to record, see 
+ *          YaRBc(size_t, uint8_t, size_t, bool).
+ * @param   overwrite
+ *          Overwrite mode, see YaRBc(size_t, uint8_t, size_t, bool).
+ */
+YaRBc::YaRBc(YaRBPool &pool, uint8_t delimiter, size_t msgindex, bool overwrite) 
+    : YaRBc((pool.blockSize() >= storageSize(0, msgindex)) ? pool.acquire() : nullptr, 
+            pool.blockSize(), delimiter, msgindex, overwrite) {
+    // never take a block which is too small, it could not be given back
+    if (arraypointer != yarbc_moved_from) this->pool = &pool;
 }
 
 /**
  * @brief   The copy constructor.
+ * @details The copy always allocates its own arrays. Attached statistics
+ *          and trackers are not shared with the copy.
  * @param   rb
  *          Reference to class instance to copy.
  */
 YaRBc::YaRBc(const YaRBc &rb)
-    : cap{rb.cap}, delim{rb.delim}, readindex{rb.readindex}, writeindex{rb.writeindex}, arraypointer{nullptr}, ct{rb.ct} {
+    : cap{rb.cap}, delim{rb.delim}, ovw{rb.ovw}, readindex{rb.readindex}, writeindex{rb.writeindex}, arraypointer{nullptr}, ct{rb.ct},
+      msgarray{nullptr}, msgcap{rb.msgcap}, msgfirst{rb.msgfirst}, msgct{rb.msgct}, 
+      own{true}, pool{nullptr}, st{nullptr}, crc{nullptr}, ts{nullptr} {
     arraypointer = new uint8_t[cap];
-    memcpy(arraypointer, &(rb.arraypointer), cap);        
+    msgarray = new size_t[msgcap];
+    copyElements(rb);
+}
+
+/**
+ * @brief   The move constructor.
+ * @details The arrays are taken over from rb, nothing is allocated or 
+ *          copied. rb is left with a capacity of 0. Attached statistics
+ *          and trackers move along.
+ * @param   rb
+ *          Reference to class instance to move from.
+ */
+YaRBc::YaRBc(YaRBc &&rb)
+    : cap{rb.cap}, delim{rb.delim}, ovw{rb.ovw}, readindex{rb.readindex}, writeindex{rb.writeindex}, arraypointer{rb.arraypointer}, ct{rb.ct},
+      msgarray{rb.msgarray}, msgcap{rb.msgcap}, msgfirst{rb.msgfirst}, msgct{rb.msgct}, 
+      own{rb.own}, pool{rb.pool}, st{rb.st}, crc{rb.crc}, ts{rb.ts} {
+    rb.forgetArrays();
 }
 
 /**
@@ -88,20 +207,78 @@ YaRBc::YaRBc(const YaRBc &rb)
  */
  // same as for YaRB
 YaRBc::~YaRBc() {
-    delete[] arraypointer;
+    freeArrays();
 }
 
-// modified compared to YaRB
-size_t YaRBc::put(uint8_t new_element) {
-    if (this->isFull()) {
-        return 0;
-    }
-    else {
-        if (new_element == delim) ct++;
-        arraypointer[writeindex] = new_element;
-        writeindex = (writeindex + 1) % cap;
-        return 1;
+/**
+ * @brief   The assignment operator.
+ * @details Afterwards, this ring buffer has the same capacity, delimiter,
+ *          mode and contents as rb. The existing arrays are reused if 
+ *          capacity and msgindex match, otherwise new ones are allocated.
+ *          Only the size() stored bytes are copied. Attached statistics
+ *          and trackers stay attached to this instance, the trackers 
+ *          start over (the CRCs of the copied messages are calculated
+ *          when requested, they have no timestamps).
+ * @param   rb
+ *          Reference to class instance to copy.
+ * @return  Reference to this instance.
+ */
+YaRBc& YaRBc::operator=(const YaRBc &rb) {
+    // protect against self-assignment
+    if (this == &rb) return *this;
+    if (cap != rb.cap || msgcap != rb.msgcap) {
+        freeArrays();
+        cap = rb.cap;
+        msgcap = rb.msgcap;
+        arraypointer = new uint8_t[cap];
+        msgarray = new size_t[msgcap];
+        own = true;
+        pool = nullptr;
     }
+    delim = rb.delim;
+    ovw = rb.ovw;
+    readindex = rb.readindex;
+    writeindex = rb.writeindex;
+    ct = rb.ct;
+    msgfirst = rb.msgfirst;
+    msgct = rb.msgct;
+    copyElements(rb);
+    if (crc) crc->reset(ct, unfinished());
+    if (ts) ts->reset(ct);
+    return *this;
+}
+
+/**
+ * @brief   The move assignment operator.
+ * @details The own arrays are freed (or given back to their pool) and the
+ *          arrays of rb are taken over. rb is left with a capacity of 0.
+ *          Attached statistics and trackers move along.
+ * @param   rb
+ *          Reference to class instance to move from.
+ * @return  Reference to this instance.
+ */
+YaRBc& YaRBc::operator=(YaRBc &&rb) {
+    // protect against self-assignment
+    if (this == &rb) return *this;
+    freeArrays();
+    cap = rb.cap;
+    delim = rb.delim;
+    ovw = rb.ovw;
+    readindex = rb.readindex;
+    writeindex = rb.writeindex;
+    arraypointer = rb.arraypointer;
+    ct = rb.ct;
+    msgarray = rb.msgarray;
+    msgcap = rb.msgcap;
+    msgfirst = rb.msgfirst;
+    msgct = rb.msgct;
+    own = rb.own;
+    pool = rb.pool;
+    st = rb.st;
+    crc = rb.crc;
+    ts = rb.ts;
+    rb.forgetArrays();
+    return *this;
 }
 
 // modified compared to YaRB
@@ -110,42 +287,120 @@ size_t YaRBc::put(const uint8_t *new_elements, size_t nbr_elements, bool only_co
     if (!new_elements ) {
         return 0;
     }
+    const size_t requested = nbr_elements;
+    if (ovw) {
+        // overwrite mode: all elements are accepted
+        if (nbr_elements >= this->capacity()) {
+            // only the newest capacity() elements survive
+            if (st) st->dropped(this->size() + nbr_elements - this->capacity());
+            new_elements += nbr_elements - this->capacity();
+            nbr_elements = this->capacity();
+            this->flush();
+        }
+        else if (nbr_elements > this->free()) {
+            // drop oldest elements in one go, discard() keeps count() 
+            // and the recorded delimiter positions exact
+            if (st) st->dropped(nbr_elements - this->free());
+            this->discard(nbr_elements - this->free());
+        }
+    }
     // only add at most free() elements to ring buffer
-    if (nbr_elements > this->free()) {
-        if (only_complete) return 0;
+    else if (nbr_elements > this->free()) {
+        if (only_complete) {
+            if (st) st->refused(nbr_elements);
+            return 0;
+        }
         nbr_elements = this->free();
     }
-    for (size_t i=0; i<nbr_elements; i++) {
-          // re-implementation is about 3-4 times faster than calling
-          // single-element put()
-          if (*new_elements == delim) ct++;
-          arraypointer[writeindex] = *new_elements;
-          writeindex = (writeindex + 1) % cap;
-          new_elements++;
+    const size_t new_delims = yarb_count(new_elements, nbr_elements, delim);
+    if (new_delims) {
+        // record positions if all older delimiters are recorded
+        if (msgct == ct) indexBlock(new_elements, nbr_elements, writeindex);
+        ct += new_delims;
+        if (ts) ts->added(new_delims);
     }
-    return nbr_elements;
+    // copy in at most two segments: 
+    // from writeindex to end of array, then from start of array
+    const size_t diff_to_max = cap - writeindex;
+    if (nbr_elements < diff_to_max) { // does not wrap
+        memcpy(arraypointer+writeindex, new_elements, nbr_elements);
+        writeindex += nbr_elements;
+    }
+    else {
+        memcpy(arraypointer+writeindex, new_elements, diff_to_max);
+        memcpy(arraypointer, new_elements+diff_to_max, nbr_elements-diff_to_max);
+        writeindex = nbr_elements - diff_to_max;
+    }
+    if (crc) crc->added(new_elements, nbr_elements, delim);
+    if (st) st->added(ovw ? nbr_elements : requested, nbr_elements, this->size());
+    return ovw ? requested : nbr_elements;
 }
 
 // same as for YaRB
-size_t YaRBc::peek(uint8_t *peeked_element) const {
-    // check for emptyness and validity of output pointer (may be nullptr)
-    if (this->isEmpty() || !peeked_element) {
+size_t YaRBc::peek(uint8_t *peeked_element, size_t offset) const {
+    // check for enough elements and validity of output pointer (may be nullptr)
+    if (offset >= this->size() || !peeked_element) {
         return 0;
     }
     else {
-        *peeked_element = arraypointer[readindex];
+        // do modulus calculation "manually" (see discard())
+        const size_t r = readindex;
+        const size_t diff_to_end = cap - r;
+        *peeked_element = arraypointer[(offset < diff_to_end) ? (r + offset) : (offset - diff_to_end)];
         return 1;
     }
 }
 
-// modified compared to YaRB
+size_t YaRBc::peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const {
+    // check for nullptr
+    if (!peeked_elements) {
+        return 0;
+    }
+    // only peek at most the size()-offset elements after offset
+    const size_t used = this->size();
+    if (offset >= used) {
+        return 0;
+    }
+    if (nbr_elements > used - offset) {
+        nbr_elements = used - offset;
+    }
+    // first element to peek at, see peek(peeked_element, offset)
+    const size_t r = readindex;
+    const size_t diff = cap - r;
+    const size_t start = (offset < diff) ? (r + offset) : (offset - diff);
+    // copy out in at most two segments, exactly like get(), but leave
+    // readindex unchanged
+    const size_t diff_to_end = cap - start;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        memcpy(peeked_elements, arraypointer+start, nbr_elements);
+    }
+    else {
+        memcpy(peeked_elements, arraypointer+start, diff_to_end);
+        memcpy(peeked_elements+diff_to_end, arraypointer, nbr_elements-diff_to_end);
+    }
+    return nbr_elements;
+}
+
 size_t YaRBc::discard(size_t nbr_elements) {
     if (this->size() > nbr_elements) { // there will be remaining elements in buffer
-        // use loop instead just index shifting
-        for (size_t i=0; i<nbr_elements; i++) {    
-            if (arraypointer[readindex] == delim) ct--;
-            readindex = (readindex + 1 ) % cap;
+        // count removed delimiters in at most two segments, 
+        // then shift readindex (see YaRB::discard())
+        size_t removed_delims;
+        const size_t diff_to_max = cap - readindex;
+        if (nbr_elements < diff_to_max) { // does not wrap
+            removed_delims = yarb_count(arraypointer+readindex, nbr_elements, delim);
+            readindex += nbr_elements;
+        }
+        else {
+            removed_delims  = yarb_count(arraypointer+readindex, diff_to_max, delim);
+            removed_delims += yarb_count(arraypointer, nbr_elements-diff_to_max, delim);
+            readindex = nbr_elements - diff_to_max;
         }
+        ct -= removed_delims;
+        indexPop(removed_delims);
+        // the last removed byte was not a delimiter: the head message lost bytes
+        if (crc && nbr_elements && arraypointer[(readindex == 0) ? (cap - 1) : (readindex - 1)] != delim) crc->truncated();
+        if (st) st->removed(nbr_elements);
         return nbr_elements;
     }
     else { // discard *all* elements --> flush()
@@ -157,18 +412,57 @@ size_t YaRBc::discard(size_t nbr_elements) {
     }
 }
 
-// modified compared to YaRB
-size_t YaRBc::get(uint8_t *returned_element) {
-    // check for emptyness and validity of output pointer (may  be nullptr)
-    if (this->isEmpty() || !returned_element) {
+size_t YaRBc::writeReserve(uint8_t **region) {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
         return 0;
     }
-    else {
-        if (arraypointer[readindex] == delim) ct--;
-        *returned_element = arraypointer[readindex];
-        readindex = (readindex + 1) % cap;
-        return 1;
+    const size_t w = writeindex;
+    *region = arraypointer+w;
+    // the free region ends at the end of the array at the latest
+    const size_t diff_to_end = cap - w;
+    const size_t free_slots = this->free();
+    return (free_slots < diff_to_end) ? free_slots : diff_to_end;
+}
+
+size_t YaRBc::commit(size_t nbr_elements) {
+    // only commit at most the region writeReserve() reports
+    const size_t requested = nbr_elements;
+    uint8_t *region;
+    const size_t reserved = this->writeReserve(&region);
+    if (nbr_elements > reserved) {
+        nbr_elements = reserved;
     }
+    // count (and record) new delimiters
+    const size_t new_delims = yarb_count(region, nbr_elements, delim);
+    if (new_delims) {
+        if (msgct == ct) indexBlock(region, nbr_elements, writeindex);
+        ct += new_delims;
+        if (ts) ts->added(new_delims);
+    }
+    // the region never wraps, but it may end exactly at the end of the array
+    writeindex += nbr_elements;
+    if (writeindex == cap) writeindex = 0;
+    if (crc) crc->added(region, nbr_elements, delim);
+    if (st) st->added(requested, nbr_elements, this->size());
+    return nbr_elements;
+}
+
+size_t YaRBc::readSpan(const uint8_t **region) const {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
+        return 0;
+    }
+    const size_t r = readindex;
+    *region = arraypointer+r;
+    // the stored region ends at the end of the array at the latest
+    const size_t diff_to_end = cap - r;
+    const size_t used = this->size();
+    return (used < diff_to_end) ? used : diff_to_end;
+}
+
+size_t YaRBc::consume(size_t nbr_elements) {
+    return this->discard(nbr_elements);
 }
 
 // modified compared to YaRB
@@ -180,58 +474,138 @@ size_t YaRBc::get(uint8_t *returned_elements, size_t nbr_elements) {
     else {
         // only get at most size() elements from buffer
         if (nbr_elements > this->size()) {
+            if (st && this->isEmpty() && nbr_elements) st->emptyGet();
             nbr_elements = this->size();
         }
-        for (size_t i=0; i<nbr_elements; i++) {    
-            if (arraypointer[readindex] == delim) ct--;
-            *returned_elements = arraypointer[readindex];
-            readindex = (readindex + 1 ) % cap;
-            returned_elements++;
+        // copy out in at most two segments:
+        // from readindex to end of array, then from start of array
+        const size_t diff_to_max = cap - readindex;
+        if (nbr_elements < diff_to_max) { // does not wrap
+            memcpy(returned_elements, arraypointer+readindex, nbr_elements);
+            readindex += nbr_elements;
         }
+        else {
+            memcpy(returned_elements, arraypointer+readindex, diff_to_max);
+            memcpy(returned_elements+diff_to_max, arraypointer, nbr_elements-diff_to_max);
+            readindex = nbr_elements - diff_to_max;
+        }
+        // count removed delimiters in the (contiguous) output array
+        const size_t removed_delims = yarb_count(returned_elements, nbr_elements, delim);
+        ct -= removed_delims;
+        indexPop(removed_delims);
+        if (crc && nbr_elements && returned_elements[nbr_elements-1] != delim) crc->truncated();
+        if (st) st->removed(nbr_elements);
         return nbr_elements;
     }
 }
         
-// same as for YaRB
-size_t YaRBc::size(void) const {
-    if (writeindex >= readindex) {
-        return writeindex - readindex;
-    }
-    else {
-        return cap - (readindex - writeindex);
-    }
+// modified compared to YaRB
+void YaRBc::flush(void) {
+    if (st) st->removed(this->size());
+    // fast-forward readindex to position of writeindex
+    readindex = writeindex;
+    ct = 0;
+    msgct = 0;
+    if (crc) crc->reset(0, false);
+    if (ts) ts->reset(0);
 }
 
 // same as for YaRB
-size_t YaRBc::free(void) const {
-    return this->capacity() - this->size();
+size_t YaRBc::limit(void) {
+    return SIZE_MAX - 1;
 }
 
-// same as for YaRB
-size_t YaRBc::capacity(void) const {
-    return cap-1;
+/**
+ * @brief   Get the size of the storage needed for a given capacity.
+ * @details The storage holds msgindex delimiter positions and capacity+1
+ *          bytes, plus up to alignof(size_t)-1 bytes to align the positions.
+ * @param   capacity
+ *          The target capacity of the ring buffer.
+ * @param   msgindex
+ *          Number of delimiter positions to record.
+ * @return  Size of the storage in bytes, see 
+ *          YaRBc(uint8_t*, size_t, uint8_t, size_t, bool).
+ */
+size_t YaRBc::storageSize(size_t capacity, size_t msgindex) {
+    return (alignof(size_t) - 1) + (msgindex ? msgindex : 1) * sizeof(size_t) + capacity + 1;
 }
 
-// same as for YaRB
-bool YaRBc::isFull(void) const {
-    return readindex == (writeindex + 1) % cap;
+/**
+ * @brief   Copy the stored elements and the recorded delimiter positions 
+ *          of rb to the same positions.
+ * @details The indices and msgcap of both ring buffers must already be 
+ *          equal. Only size() elements are copied, in at most two segments.
+ * @param   rb
+ *          Reference to class instance to copy from.
+ */
+void YaRBc::copyElements(const YaRBc &rb) {
+    const size_t n = rb.size();
+    const size_t diff_to_max = cap - readindex;
+    if (n <= diff_to_max) { // does not wrap
+        memcpy(arraypointer+readindex, rb.arraypointer+readindex, n);
+    }
+    else {
+        memcpy(arraypointer+readindex, rb.arraypointer+readindex, diff_to_max);
+        memcpy(arraypointer, rb.arraypointer, n-diff_to_max);
+    }
+    memcpy(msgarray, rb.msgarray, msgcap * sizeof(size_t));
 }
 
-// same as for YaRB
-bool YaRBc::isEmpty(void) const {
-    return readindex == writeindex;
+/**
+ * @brief   Free the arrays or give the storage back to its pool.
+ */
+void YaRBc::freeArrays(void) {
+    if (pool) {
+        // msgarray and arraypointer both point into the block
+        pool->release(arraypointer);
+    }
+    else if (own) {
+        delete[] arraypointer;
+        delete[] msgarray;
+    }
 }
 
-// modified compared to YaRB
-void YaRBc::flush(void) {
-    // fast-forward readindex to position of writeindex
-    readindex = writeindex;
+/**
+ * @brief   Let go of the arrays (after they were moved), leaving an empty
+ *          ring buffer with a capacity of 0.
+ */
+void YaRBc::forgetArrays(void) {
+    cap = 1;
+    readindex = 0;
+    writeindex = 0;
+    arraypointer = yarbc_moved_from;
     ct = 0;
+    msgarray = yarbc_moved_from_msg;
+    msgcap = 1;
+    msgfirst = 0;
+    msgct = 0;
+    own = false;
+    pool = nullptr;
+    st = nullptr;
+    crc = nullptr;
+    ts = nullptr;
 }
 
-// same as for YaRB
-size_t YaRBc::limit(void) {
-    return SIZE_MAX - 1;
+/**
+ * @brief   Get the number of bytes needed to align the delimiter positions.
+ * @param   storage
+ *          Start of the storage.
+ * @return  Offset of the first aligned address from storage.
+ */
+size_t YaRBc::padding(const uint8_t *storage) {
+    const size_t misalignment = reinterpret_cast<uintptr_t>(storage) % alignof(size_t);
+    return misalignment ? (alignof(size_t) - misalignment) : 0;
+}
+
+/**
+ * @brief   Get the array size for caller-owned storage.
+ * @details The worst-case padding is always assumed, so all storages of 
+ *          the same size give the same capacity.
+ * @return  Array size (i.e. capacity+1), 1 if the storage is unusable.
+ */
+size_t YaRBc::storageCap(const uint8_t *storage, size_t storage_size, size_t msgindex) {
+    const size_t overhead = storageSize(0, msgindex) - 1;
+    return (storage && storage_size > overhead) ? (storage_size - overhead) : 1;
 }
 
 /**
@@ -241,3 +615,397 @@ size_t YaRBc::limit(void) {
 size_t YaRBc::count(void) const {
     return ct;
 }
+
+/**
+ * @brief      Get the delimiter for messages.
+ * @return     The delimiter given to the constructor.
+ */
+uint8_t YaRBc::delimiter(void) const {
+    return delim;
+}
+
+/**
+ * @brief      Get the length of the next complete message in the ring buffer.
+ * @details    A message consists of all bytes up to and @b including the
+ *             next delimiter byte.
+ * @return     Number of bytes in the next message, including the delimiter.
+ *             0 if there is no complete message in the ring buffer.
+ */
+size_t YaRBc::messageLength(void) {
+    if (ct == 0) {
+        return 0;
+    }
+    if (msgct == 0) {
+        // there are delimiters, but their positions are unknown
+        indexScan();
+    }
+    const size_t delimpos = msgarray[msgfirst];
+    if (delimpos >= readindex) {
+        return delimpos - readindex + 1;
+    }
+    else {
+        return cap - readindex + delimpos + 1;
+    }
+}
+
+/**
+ * @brief      Get exactly one complete message from the ring buffer, 
+ *             thereby removing it from the buffer.
+ * @details    If there is no complete message in the ring buffer or if
+ *             nbr_elements is too small to hold the message, nothing is
+ *             written to returned_elements and the ring buffer remains
+ *             unchanged.
+ * @param[out] returned_elements
+ *             Pointer to a uint8_t. The message (including the delimiter)
+ *             is stored in an array starting at this address.
+ * @param      nbr_elements
+ *             Size of the array returned_elements points to.
+ * @return     Number of bytes copied, including the delimiter. 
+ *             0 if nothing was copied.
+ */
+size_t YaRBc::getMessage(uint8_t *returned_elements, size_t nbr_elements) {
+    // check for nullptr
+    if (!returned_elements) {
+        return 0;
+    }
+    const size_t len = this->messageLength();
+    if (len == 0 || len > nbr_elements) {
+        return 0;
+    }
+    // copy out in at most two segments (see get()), but there is no need
+    // to count: the message contains exactly one delimiter
+    const size_t diff_to_max = cap - readindex;
+    if (len < diff_to_max) { // does not wrap
+        memcpy(returned_elements, arraypointer+readindex, len);
+        readindex += len;
+    }
+    else {
+        memcpy(returned_elements, arraypointer+readindex, diff_to_max);
+        memcpy(returned_elements+diff_to_max, arraypointer, len-diff_to_max);
+        readindex = len - diff_to_max;
+    }
+    ct--;
+    indexPop(1);
+    if (st) st->removed(len);
+    return len;
+}
+
+/**
+ * @brief      Discard (i.e. remove) exactly one complete message from the
+ *             ring buffer.
+ * @return     Number of bytes removed, including the delimiter. 
+ *             0 if there is no complete message in the ring buffer.
+ */
+size_t YaRBc::discardMessage(void) {
+    const size_t len = this->messageLength();
+    if (len == 0) {
+        return 0;
+    }
+    readindex = advance(readindex, len);
+    ct--;
+    indexPop(1);
+    if (st) st->removed(len);
+    return len;
+}
+
+/**
+ * @brief      Get the CRC of the next complete message in the ring buffer.
+ * @details    The CRC covers the message @b without the delimiter. It is
+ *             the CRC snapshot taken by the attached tracker when the 
+ *             delimiter was put, or calculated from the stored bytes if the
+ *             snapshot was not kept (see yarb_crc.h).
+ * @param[out] crc
+ *             Pointer to a uint32_t to store the CRC in.
+ * @return     true if there is a complete message and a CRC tracker is
+ *             attached, false otherwise (nothing is stored).
+ */
+bool YaRBc::messageCrc(uint32_t *crc) {
+    // check for nullptr
+    if (!crc || !this->crc) {
+        return false;
+    }
+    const size_t len = this->messageLength();
+    if (len == 0) {
+        return false;
+    }
+    if (this->crc->first(crc)) {
+        return true;
+    }
+    // calculate over at most two segments, without the delimiter
+    const size_t n = len - 1;
+    const size_t diff_to_max = cap - readindex;
+    if (n < diff_to_max) { // does not wrap
+        *crc = this->crc->calculate(arraypointer+readindex, n, nullptr, 0);
+    }
+    else {
+        *crc = this->crc->calculate(arraypointer+readindex, diff_to_max, arraypointer, n-diff_to_max);
+    }
+    return true;
+}
+
+/**
+ * @brief      Get exactly one complete message and its CRC from the ring
+ *             buffer, thereby removing it from the buffer.
+ * @details    See getMessage(uint8_t*, size_t) and messageCrc().
+ * @param[out] returned_elements
+ *             Pointer to a uint8_t. The message (including the delimiter)
+ *             is stored in an array starting at this address.
+ * @param      nbr_elements
+ *             Size of the array returned_elements points to.
+ * @param[out] crc
+ *             Pointer to a uint32_t to store the CRC of the message in.
+ * @return     Number of bytes copied, including the delimiter. 
+ *             0 if nothing was copied (also without attached CRC tracker).
+ */
+size_t YaRBc::getMessage(uint8_t *returned_elements, size_t nbr_elements, uint32_t *crc) {
+    // check for nullptr
+    if (!returned_elements || this->messageLength() > nbr_elements || !this->messageCrc(crc)) {
+        return 0;
+    }
+    return this->getMessage(returned_elements, nbr_elements);
+}
+
+/**
+ * @brief      Get the timestamp of the next complete message in the ring 
+ *             buffer.
+ * @details    The timestamp is the time of the attached tracker's clock 
+ *             when the delimiter of the message was put (see yarb_time.h).
+ * @param[out] timestamp
+ *             Pointer to a uint32_t to store the timestamp in.
+ * @return     true if there is a complete message with a timestamp, false
+ *             otherwise (nothing is stored).
+ */
+bool YaRBc::messageTime(uint32_t *timestamp) {
+    // check for nullptr
+    if (!timestamp || !ts || ct == 0) {
+        return false;
+    }
+    return ts->first(timestamp);
+}
+
+/**
+ * @brief      Get exactly one complete message and its timestamp from the
+ *             ring buffer, thereby removing it from the buffer.
+ * @details    See getMessage(uint8_t*, size_t) and messageTime().
+ * @param[out] returned_elements
+ *             Pointer to a uint8_t. The message (including the delimiter)
+ *             is stored in an array starting at this address.
+ * @param      nbr_elements
+ *             Size of the array returned_elements points to.
+ * @param[out] timestamp
+ *             Pointer to a uint32_t to store the timestamp of the message in.
+ * @return     Number of bytes copied, including the delimiter. 
+ *             0 if nothing was copied (also if the message has no timestamp).
+ */
+size_t YaRBc::getMessageTimed(uint8_t *returned_elements, size_t nbr_elements, uint32_t *timestamp) {
+    // check for nullptr
+    if (!returned_elements || this->messageLength() > nbr_elements || !this->messageTime(timestamp)) {
+        return 0;
+    }
+    return this->getMessage(returned_elements, nbr_elements);
+}
+
+/**
+ * @brief      COBS-encode a message and add it, including the delimiter.
+ * @details    The message is encoded directly into the array, no buffer
+ *             for the encoded message is needed. The message is only added
+ *             if it fits completely (also in overwrite mode). The encoded
+ *             message never contains the delimiter (see yarb_cobs.h).
+ * @param      raw
+ *             Pointer to the message. It may contain any byte values.
+ * @param      nbr_elements
+ *             Length of the message.
+ * @return     Number of bytes added: the encoded length including the
+ *             delimiter. 0 if the encoded message does not fit.
+ */
+size_t YaRBc::putMessageCobs(const uint8_t *raw, size_t nbr_elements) {
+    // check validity of input pointer (may be nullptr)
+    if (!raw) {
+        return 0;
+    }
+    const size_t len = yarb_cobs_encoded_size(raw, nbr_elements);
+    if (len > this->free()) {
+        if (st) st->refused(len);
+        return 0;
+    }
+    yarb_cobs_encode_ring(raw, nbr_elements, arraypointer, cap, writeindex, delim);
+    // publish in at most two segments, commit() counts and records the delimiter
+    const size_t first = this->commit(len);
+    if (first < len) {
+        this->commit(len - first);
+    }
+    return len;
+}
+
+/**
+ * @brief      COBS-decode the next complete message and remove it.
+ * @details    The message is decoded directly from the array into decoded,
+ *             handling the wrap-around, no buffer for the encoded message
+ *             is needed. The message and its delimiter are removed. 
+ * @param      decoded
+ *             Pointer to an array for the decoded message.
+ * @param      nbr_elements
+ *             Size of the array decoded points to.
+ * @param[out] decoded_length
+ *             Pointer to a size_t. The length of the decoded message is
+ *             stored there, also if it does not fit into decoded.
+ * @return     Number of bytes removed from the ring buffer (the encoded
+ *             length including the delimiter). 0 if there is no complete 
+ *             message, if the decoded message does not fit (nothing is 
+ *             removed then) or if a pointer is nullptr.
+ */
+size_t YaRBc::getMessageCobs(uint8_t *decoded, size_t nbr_elements, size_t *decoded_length) {
+    // check for nullptr
+    if (!decoded || !decoded_length) {
+        return 0;
+    }
+    const size_t len = this->messageLength();
+    if (len == 0) {
+        return 0;
+    }
+    if (!yarb_cobs_decode_ring(arraypointer, cap, readindex, len-1, delim, 
+                               decoded, nbr_elements, decoded_length)) {
+        return 0;
+    }
+    return this->discardMessage();
+}
+
+/**
+ * @brief   Attach a YaRBStats to collect statistics about this ring buffer.
+ * @details The counters are not reset when attaching. Without attached
+ *          statistics, the only cost is one comparison per call.
+ * @param   stats
+ *          Pointer to the statistics to update, nullptr to stop 
+ *          collecting statistics. Must outlive the ring buffer or be
+ *          detached before it goes out of scope.
+ */
+void YaRBc::attachStats(YaRBStats *stats) {
+    st = stats;
+}
+
+/**
+ * @brief   Attach a CRC tracker to calculate the CRC of each message while
+ *          it is put into this ring buffer.
+ * @details The tracker starts over when attaching. For the messages 
+ *          already stored (also for an incomplete one, whose first bytes
+ *          are stored), the CRC is calculated when requested. Without 
+ *          attached tracker, the only cost is one comparison per call.
+ * @param   tracker
+ *          Pointer to the tracker (e.g. a YaRBCrcTracker<YaRBCrc16>), 
+ *          nullptr to stop tracking. Must outlive the ring buffer or be
+ *          detached before it goes out of scope.
+ */
+void YaRBc::attachCrc(IYaRBCrc *tracker) {
+    crc = tracker;
+    if (crc) crc->reset(ct, unfinished());
+}
+
+/**
+ * @brief   Attach a timestamp tracker to record the time each message is
+ *          completed in this ring buffer.
+ * @details The tracker starts over when attaching, the messages already
+ *          stored have no timestamps. Without attached tracker, the only
+ *          cost is one comparison per call.
+ * @param   tracker
+ *          Pointer to the tracker (e.g. a YaRBTimestamps<YaRBMicros>), 
+ *          nullptr to stop tracking. Must outlive the ring buffer or be
+ *          detached before it goes out of scope.
+ */
+void YaRBc::attachTimestamps(IYaRBTime *tracker) {
+    ts = tracker;
+    if (ts) ts->reset(ct);
+}
+
+/**
+ * @brief   Advance an index by a number of elements, modulo cap.
+ * @param   val
+ *          Index to advance, must be smaller than cap.
+ * @param   nbr_elements
+ *          Number of elements to advance the index by, must be smaller
+ *          than cap.
+ * @return  New value of the index.
+ */
+size_t YaRBc::advance(size_t val, size_t nbr_elements) const {
+    // do modulus calculation "manually" (see YaRB::discard())
+    const size_t diff_to_max = cap - val;
+    return (nbr_elements >= diff_to_max) ? (nbr_elements - diff_to_max) : (val + nbr_elements);
+}
+
+/**
+ * @brief   Check if there are bytes of an incomplete message in the ring
+ *          buffer, i.e. bytes after the newest delimiter.
+ * @return  true if the ring buffer is not empty and the newest byte is not
+ *          the delimiter.
+ */
+bool YaRBc::unfinished(void) const {
+    return !this->isEmpty() && arraypointer[(writeindex == 0) ? (cap - 1) : (writeindex - 1)] != delim;
+}
+
+/**
+ * @brief   Record the position of a new delimiter (as the newest entry).
+ * @param   delimpos
+ *          Index of the new delimiter within the array.
+ */
+void YaRBc::indexAppend(size_t delimpos) {
+    if (msgct < msgcap) {
+        size_t slot = msgfirst + msgct;
+        if (slot >= msgcap) slot -= msgcap;
+        msgarray[slot] = delimpos;
+        msgct++;
+    }
+}
+
+/**
+ * @brief   Remove the positions (and CRC snapshots and timestamps) of the
+ *          oldest delimiters, because they were removed from the ring buffer.
+ * @param   nbr_delims
+ *          Number of removed delimiters.
+ */
+void YaRBc::indexPop(size_t nbr_delims) {
+    if (crc) crc->removed(nbr_delims);
+    if (ts) ts->removed(nbr_delims);
+    if (nbr_delims >= msgct) {
+        msgct = 0;
+        msgfirst = 0;
+    }
+    else {
+        msgct -= nbr_delims;
+        msgfirst += nbr_delims;
+        if (msgfirst >= msgcap) msgfirst -= msgcap;
+    }
+}
+
+/**
+ * @brief   Record the positions of delimiters in a contiguous block of
+ *          new elements, until msgarray is full.
+ * @param   data
+ *          Pointer to the new elements (need not be within the ring buffer).
+ * @param   nbr_elements
+ *          Number of new elements.
+ * @param   start
+ *          Index within the array where data[0] is (or will be) stored.
+ */
+void YaRBc::indexBlock(const uint8_t *data, size_t nbr_elements, size_t start) {
+    const uint8_t *p = data;
+    const uint8_t * const end = data + nbr_elements;
+    while (msgct < msgcap && p < end) {
+        p = static_cast<const uint8_t*>(memchr(p, delim, end - p));
+        if (!p) break;
+        indexAppend(advance(start, p - data));
+        p++;
+    }
+}
+
+/**
+ * @brief   Scan the stored elements for delimiters from readindex on,
+ *          when there are delimiters in the ring buffer, but their
+ *          positions are not recorded.
+ */
+void YaRBc::indexScan(void) {
+    // scan in at most two segments, see readSpan()
+    const uint8_t *region;
+    const size_t first = this->readSpan(&region);
+    const size_t second = this->size() - first;
+    indexBlock(region, first, readindex);
+    indexBlock(arraypointer, second, 0);
+}
@@ -34,6 +34,13 @@
 #define yarbc_h
 
 #include "yarb_interface.h"
+#include "yarb_index.h"
+#include "yarb_count.h"
+#include "yarb_cobs.h"
+#include "yarb_crc.h"
+#include "yarb_time.h"
+#include "yarb_stats.h"
+#include "yarb_pool.h"
 
 /**
  * @class   YaRBc
@@ -45,21 +52,23 @@
  *          This is due to the fact that the assignment operation for data
  *          type size_t is not atomic on some platforms.
  */
-class YaRBc : public IYaRB {
+class YaRBc final : public IYaRB {
     public:
-        // constructor
-        YaRBc(size_t capacity=63, uint8_t delimiter=0);
+        // constructors
+        YaRBc(size_t capacity=63, uint8_t delimiter=0, size_t msgindex=8, bool overwrite=false);
+        YaRBc(uint8_t *storage, size_t storage_size, uint8_t delimiter=0, size_t msgindex=8, bool overwrite=false);
+        YaRBc(YaRBPool &pool, uint8_t delimiter=0, size_t msgindex=8, bool overwrite=false);
         
-        // copy constructor
+        // copy and move constructors
         YaRBc(const YaRBc &rb);
+        YaRBc(YaRBc &&rb);
         
         // destructor
         virtual ~YaRBc(void);
         
-        // Genrally do not allow assignments:
-        // It is unclear how to handle assignment of ring buffers with
-        // different capacities.
-        YaRBc& operator= (const YaRBc &rb) = delete;
+        // assignment and move assignment, see YaRB
+        YaRBc& operator= (const YaRBc &rb);
+        YaRBc& operator= (YaRBc &&rb);
 
         // put element(s) into ring buffer
         virtual size_t put(uint8_t new_element) override;
@@ -69,38 +78,200 @@ class YaRBc : public IYaRB {
         virtual size_t get(uint8_t *returned_element) override;
         virtual size_t get(uint8_t *returned_elements, size_t nbr_elements) override;
         
-        // look at next element in ring buffer
-        // note: there is no multi-byte-version!
+        // look at element(s) in ring buffer without removing them
         virtual size_t peek(uint8_t *peeked_element) const override; 
+        virtual size_t peek(uint8_t *peeked_element, size_t offset) const override;
+        virtual size_t peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const override;
         
         // discard some elements from ring buffer, 
         // return number of discarded elements
         virtual size_t discard(size_t nbr_elements) override;
 
+        // zero-copy access to the internal array
+        virtual size_t writeReserve(uint8_t **region) override;
+        virtual size_t commit(size_t nbr_elements) override;
+        virtual size_t readSpan(const uint8_t **region) const override;
+        virtual size_t consume(size_t nbr_elements) override;
+
         virtual size_t size(void) const override;     // return number of slots in use
         virtual size_t free(void) const override;     // return number of free slots
         virtual size_t capacity(void) const override; // return total number of slots
 
         // function *not* from interface, but special to this class
         virtual size_t count(void) const;             // return count of messages
+        virtual uint8_t delimiter(void) const;        // return delimiter for messages
+
+        // message (frame) access, a message ends with (and includes) the delimiter
+        virtual size_t messageLength(void);           // return length of next complete message, 0 if none
+        virtual size_t getMessage(uint8_t *returned_elements, size_t nbr_elements); // get exactly one message
+        virtual size_t discardMessage(void);          // discard exactly one message, return its length
+
+        // COBS-encoded messages, encoded/decoded directly in the array (see yarb_cobs.h)
+        virtual size_t putMessageCobs(const uint8_t *raw, size_t nbr_elements); // encode and add one message
+        virtual size_t getMessageCobs(uint8_t *decoded, size_t nbr_elements, size_t *decoded_length); // decode and remove one message
+
+        // per-message CRC, needs an attached CRC tracker (see yarb_crc.h)
+        bool   messageCrc(uint32_t *crc);             // return CRC of next complete message
+        size_t getMessage(uint8_t *returned_elements, size_t nbr_elements, uint32_t *crc); // get exactly one message and its CRC
+
+        // per-message timestamps, need an attached timestamp tracker (see yarb_time.h)
+        bool   messageTime(uint32_t *timestamp);      // return timestamp of next complete message
+        size_t getMessageTimed(uint8_t *returned_elements, size_t nbr_elements, uint32_t *timestamp); // get exactly one message and its timestamp
 
         virtual bool   isFull(void) const override;   // return true when buffer is full
         virtual bool   isEmpty(void) const override;  // return true when buffer is empty
         virtual void   flush(void) override;          // clear all elements from buffer
         
+        // opt-in statistics, see yarb_stats.h
+        void attachStats(YaRBStats *stats);          // collect statistics in *stats, nullptr to stop
+
+        // opt-in per-message CRC, see yarb_crc.h
+        void attachCrc(IYaRBCrc *tracker);           // track message CRCs in *tracker, nullptr to stop
+
+        // opt-in per-message timestamps, see yarb_time.h
+        void attachTimestamps(IYaRBTime *tracker);   // track message timestamps in *tracker, nullptr to stop
+
         // no override for static functions...
         static size_t limit(void);   // return maximum possible number of elements on a given platform
+        static size_t storageSize(size_t capacity, size_t msgindex=8); // return storage size in bytes needed
 
     private:
-        const size_t  cap;     ///< store size of internaly array
-        const uint8_t delim;   ///< delimiter for messages 
+        size_t  cap;           ///< store size of internaly array
+        uint8_t delim;         ///< delimiter for messages 
+        bool    ovw;           ///< overwrite oldest elements when full
 
         size_t  readindex;     ///< index for get()
         size_t  writeindex;    ///< index for put()
         uint8_t *arraypointer; ///< pointer to array which holds the elements
         size_t  ct;            ///< counter for delimiter bytes
+        
+        size_t  *msgarray;     ///< ring of positions of the oldest delimiters
+        size_t  msgcap;        ///< number of positions msgarray can hold
+        size_t  msgfirst;      ///< index of oldest recorded position in msgarray
+        size_t  msgct;         ///< number of recorded positions, always <= ct
+
+        bool    own;           ///< arrays were allocated by this instance
+        YaRBPool *pool;        ///< pool the storage belongs to, may be nullptr
+        YaRBStats *st;         ///< attached statistics, may be nullptr
+        IYaRBCrc *crc;         ///< attached CRC tracker, may be nullptr
+        IYaRBTime *ts;         ///< attached timestamp tracker, may be nullptr
+
+        // helper functions for caller-owned storage
+        static size_t padding(const uint8_t *storage);
+        static size_t storageCap(const uint8_t *storage, size_t storage_size, size_t msgindex);
+
+        // helper functions for copying and moving
+        void   copyElements(const YaRBc &rb);
+        void   freeArrays(void);
+        void   forgetArrays(void);
+
+        // helper functions for message access
+        size_t advance(size_t val, size_t nbr_elements) const;
+        bool   unfinished(void) const;
+        void   indexAppend(size_t delimpos);
+        void   indexPop(size_t nbr_delims);
+        void   indexBlock(const uint8_t *data, size_t nbr_elements, size_t start);
+        void   indexScan(void);
 };
 
+// inline definitions of the functions on the hot path
+
+inline size_t YaRBc::put(uint8_t new_element) {
+    if (this->isFull()) {
+        if (!ovw) {
+            if (st) st->added(1, 0, this->size());
+            return 0;
+        }
+        // with capacity 0, the new element is dropped right away
+        if (this->isEmpty()) {
+            if (st) st->dropped(1);
+            return 1;
+        }
+        // overwrite mode: drop oldest element
+        if (arraypointer[readindex] == delim) {
+            ct--;
+            indexPop(1);
+        }
+        else if (crc) {
+            crc->truncated();
+        }
+        readindex = (readindex + 1 == cap) ? 0 : (readindex + 1);
+        if (st) {
+            st->removed(1);
+            st->dropped(1);
+        }
+    }
+    if (new_element == delim) {
+        // record position if all older delimiters are recorded
+        if (msgct == ct) indexAppend(writeindex);
+        ct++;
+        if (ts) ts->added(1);
+    }
+    arraypointer[writeindex] = new_element;
+    // no division, even on CPUs without hardware divider
+    writeindex = (writeindex + 1 == cap) ? 0 : (writeindex + 1);
+    if (crc) crc->added(&new_element, 1, delim);
+    if (st) st->added(1, 1, this->size());
+    return 1;
+}
+
+inline size_t YaRBc::peek(uint8_t *peeked_element) const {
+    // check for emptyness and validity of output pointer (may be nullptr)
+    if (this->isEmpty() || !peeked_element) {
+        return 0;
+    }
+    else {
+        *peeked_element = arraypointer[readindex];
+        return 1;
+    }
+}
+
+inline size_t YaRBc::get(uint8_t *returned_element) {
+    // check for emptyness and validity of output pointer (may  be nullptr)
+    if (this->isEmpty() || !returned_element) {
+        if (st && this->isEmpty()) st->emptyGet();
+        return 0;
+    }
+    else {
+        if (arraypointer[readindex] == delim) {
+            ct--;
+            indexPop(1);
+        }
+        else if (crc) {
+            crc->truncated();
+        }
+        *returned_element = arraypointer[readindex];
+        readindex = (readindex + 1 == cap) ? 0 : (readindex + 1);
+        if (st) st->removed(1);
+        return 1;
+    }
+}
+
+inline size_t YaRBc::size(void) const {
+    if (writeindex >= readindex) {
+        return writeindex - readindex;
+    }
+    else {
+        return cap - (readindex - writeindex);
+    }
+}
+
+inline size_t YaRBc::free(void) const {
+    return this->capacity() - this->size();
+}
+
+inline size_t YaRBc::capacity(void) const {
+    return cap-1;
+}
+
+inline bool YaRBc::isFull(void) const {
+    return readindex == ((writeindex + 1 == cap) ? 0 : (writeindex + 1));
+}
+
+inline bool YaRBc::isEmpty(void) const {
+    return readindex == writeindex;
+}
+
 
 /**
  * @class   YaRBct
@@ -108,33 +279,47 @@ class YaRBc : public IYaRB {
  *          With additional tracking of delimiter bytes.
  * @note    The template parameter specifies the @b effective, i.e. usable 
  *          capacity of the ring buffer. Internally, one additional byte is
- *          allocated.
+ *          allocated, unless CAPACITY is a power of two (see YaRBt).
+ * @note    MSGINDEX is the number of delimiter positions recorded for 
+ *          the message functions (see YaRBc).
+ * @note    STATS is the statistics policy (see yarb_stats.h). With 
+ *          YaRBWithStats, the ring buffer has the additional functions
+ *          stats() and resetStats().
+ * @note    CRC is the per-message CRC policy (see yarb_crc.h). With a
+ *          YaRBCrcTracker, messageCrc() and getMessage() with CRC can be
+ *          used.
+ * @note    TIME is the per-message timestamp policy (see yarb_time.h).
+ *          With a YaRBTimestamps, messageTime() and getMessageTimed() can
+ *          be used.
+ * @note    INDEX is the type of the indices and of the recorded delimiter
+ *          positions, by default the smallest unsigned type which can hold
+ *          them (see YaRBt).
  * @warning This class is @b not interrupt-safe, even with only a single
  *          interrupt priority (as on AVR Arduinos) and when only adding 
  *          to it in an ISR and removing from it in loop() (or vice versa).
  *          This is due to the fact that the assignment operation for data
  *          type size_t is not atomic on some platforms.
  */
-
-
-template <size_t CAPACITY = 63> 
-class YaRBct : public IYaRB {
+template <size_t CAPACITY = 63, size_t MSGINDEX = 8, class STATS = YaRBNoStats, class CRC = YaRBNoCrc,
+          class TIME = YaRBNoTime, typename INDEX = typename YaRBIndexType<yarb_index_maxval(CAPACITY)>::type> 
+class YaRBct final : public IYaRB, public STATS, protected CRC, protected TIME {
     public:
         // sanity checking
         static_assert(CAPACITY > 0, "not allowed to instantiate template with CAPACITY=0");
+        static_assert(MSGINDEX > 0, "not allowed to instantiate template with MSGINDEX=0");
         
         // constructor
         YaRBct(uint8_t delimiter=0);
         
         // copy constructor
-        YaRBct(const YaRBct<CAPACITY> &rb);
+        YaRBct(const YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX> &rb);
         
         // destructor
         virtual ~YaRBct(void) = default;
         
         // Do not allow assignments, even in templated version.
         // It does not make sense to change delimting byte after construction.
-        YaRBct<CAPACITY>& operator= (const YaRBct<CAPACITY> &rb) = delete;
+        YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>& operator= (const YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX> &rb) = delete;
 
         // put element(s) into ring buffer
         virtual size_t put(uint8_t new_element) override;
@@ -144,20 +329,45 @@ class YaRBct : public IYaRB {
         virtual size_t get(uint8_t *returned_element) override;
         virtual size_t get(uint8_t *returned_elements, size_t nbr_elements) override;
         
-        // look at next element in ring buffer
-        // note: there is no multi-byte-version!
+        // look at element(s) in ring buffer without removing them
         virtual size_t peek(uint8_t *peeked_element) const override; 
+        virtual size_t peek(uint8_t *peeked_element, size_t offset) const override;
+        virtual size_t peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const override;
         
         // discard some elements from ring buffer, 
         // return number of discarded elements
         virtual size_t discard(size_t nbr_elements) override;
 
+        // zero-copy access to the internal array
+        virtual size_t writeReserve(uint8_t **region) override;
+        virtual size_t commit(size_t nbr_elements) override;
+        virtual size_t readSpan(const uint8_t **region) const override;
+        virtual size_t consume(size_t nbr_elements) override;
+
         virtual size_t size(void) const override;     // return number of slots in use
         virtual size_t free(void) const override;     // return number of free slots
         virtual size_t capacity(void) const override; // return total number of slots
 
         // function *not* from interface, but special to this class --> no override
         virtual size_t count(void) const;             // return count of messages
+        virtual uint8_t delimiter(void) const;        // return delimiter for messages
+
+        // message (frame) access, a message ends with (and includes) the delimiter
+        virtual size_t messageLength(void);           // return length of next complete message, 0 if none
+        virtual size_t getMessage(uint8_t *returned_elements, size_t nbr_elements); // get exactly one message
+        virtual size_t discardMessage(void);          // discard exactly one message, return its length
+
+        // COBS-encoded messages, encoded/decoded directly in the array (see yarb_cobs.h)
+        virtual size_t putMessageCobs(const uint8_t *raw, size_t nbr_elements); // encode and add one message
+        virtual size_t getMessageCobs(uint8_t *decoded, size_t nbr_elements, size_t *decoded_length); // decode and remove one message
+
+        // per-message CRC, needs a CRC policy other than YaRBNoCrc (see yarb_crc.h)
+        bool   messageCrc(uint32_t *crc);             // return CRC of next complete message
+        size_t getMessage(uint8_t *returned_elements, size_t nbr_elements, uint32_t *crc); // get exactly one message and its CRC
+
+        // per-message timestamps, need a timestamp policy other than YaRBNoTime (see yarb_time.h)
+        bool   messageTime(uint32_t *timestamp);      // return timestamp of next complete message
+        size_t getMessageTimed(uint8_t *returned_elements, size_t nbr_elements, uint32_t *timestamp); // get exactly one message and its timestamp
         
         virtual bool   isFull(void) const override;   // return true when buffer is full
         virtual bool   isEmpty(void) const override;  // return true when buffer is empty
@@ -169,10 +379,22 @@ class YaRBct : public IYaRB {
     private:
         const uint8_t delim;         ///< delimiter for messages 
 
-        size_t  readindex;           ///< index for get()
-        size_t  writeindex;          ///< index for put()
-        uint8_t arr[CAPACITY+1];     ///< array which holds the elements
+        typedef YaRBIndex<CAPACITY, yarb_is_pow2(CAPACITY), INDEX> idx; ///< index arithmetic, selected by CAPACITY
+
+        INDEX   readindex;           ///< index for get()
+        INDEX   writeindex;          ///< index for put()
+        uint8_t arr[idx::slots];     ///< array which holds the elements
         size_t  ct;                  ///< counter for delimiter bytes
+        
+        INDEX   msgarray[MSGINDEX];  ///< ring of positions of the oldest delimiters
+        size_t  msgfirst;            ///< index of oldest recorded position in msgarray
+        size_t  msgct;               ///< number of recorded positions, always <= ct
+
+        // helper functions for message access
+        void   indexAppend(size_t delimpos);
+        void   indexPop(size_t nbr_delims);
+        void   indexBlock(const uint8_t *data, size_t nbr_elements, size_t start);
+        void   indexScan(void);
 };
 
 // include imlementation file for template here
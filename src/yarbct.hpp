@@ -30,7 +30,15 @@
  * SOFTWARE.
  */
 
-#include <string.h>  // memcpy(), for copy constructor
+#include <string.h>  // memcpy(), memchr()
+
+/*
+ * Note:
+ * All index calculations are done by the helper class idx (see yarb_index.h),
+ * exactly as for YaRBt.
+ * The positions of delimiters are recorded in msgarray as for YaRBc. 
+ * Positions are stored as array positions (idx::pos()).
+ */
 
 /**
  * @brief   The constructor.
@@ -39,9 +47,10 @@
  *          Capacity is not given as a parameter to the constructor, but
  *          as a template parameter
  */
-template <size_t CAPACITY>
-YaRBct<CAPACITY>::YaRBct(uint8_t delimiter) 
-    : delim{delimiter}, readindex{0}, writeindex{0}, arr{0}, ct{0} {
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::YaRBct(uint8_t delimiter) 
+    : delim{delimiter}, readindex{0}, writeindex{0}, ct{0},
+      msgarray{0}, msgfirst{0}, msgct{0} {
 }
 
 /**
@@ -49,70 +58,159 @@ YaRBct<CAPACITY>::YaRBct(uint8_t delimiter)
  * @param   rb
  *          Reference to class instance to copy.
  */
-template <size_t CAPACITY>
-YaRBct<CAPACITY>::YaRBct(const YaRBct<CAPACITY> &rb)
-    : delim{rb.delim}, readindex{rb.readindex}, writeindex{rb.writeindex}, arr{0}, ct{rb.ct} {
-    memcpy(arr, &(rb.arr), CAPACITY+1);        
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::YaRBct(const YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX> &rb)
+    : STATS(rb), CRC(rb), TIME(rb), delim{rb.delim}, readindex{rb.readindex}, writeindex{rb.writeindex}, ct{rb.ct},
+      msgfirst{rb.msgfirst}, msgct{rb.msgct} {
+    memcpy(arr, rb.arr, idx::slots);        
+    memcpy(msgarray, rb.msgarray, sizeof(msgarray));
 }
 
 // modified
-template <size_t CAPACITY>
-size_t YaRBct<CAPACITY>::put(uint8_t new_element) {
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::put(uint8_t new_element) {
     if (this->isFull()) {
+        this->statsAdded(1, 0, CAPACITY);
         return 0;
     }
     else {
-        if (new_element == delim) ct++;
-        arr[writeindex] = new_element;
-        writeindex = (writeindex + 1) % (CAPACITY+1);
+        if (new_element == delim) {
+            // record position if all older delimiters are recorded
+            if (msgct == ct) indexAppend(idx::pos(writeindex));
+            ct++;
+            TIME::added(1);
+        }
+        arr[idx::pos(writeindex)] = new_element;
+        writeindex = idx::next(writeindex);
+        CRC::added(&new_element, 1, delim);
+        this->statsAdded(1, 1, this->size());
         return 1;
     }
 }
 
 // modified
-template <size_t CAPACITY>
-size_t YaRBct<CAPACITY>::put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) {
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) {
     // check validity of input pointer (may be nullptr)
     if (!new_elements ) {
         return 0;
     }
     // only add at most free() elements to ring buffer
+    const size_t requested = nbr_elements;
     if (nbr_elements > this->free()) {
-        if (only_complete) return 0;
+        if (only_complete) {
+            this->statsRefused(nbr_elements);
+            return 0;
+        }
         nbr_elements = this->free();
     }
-    for (size_t i=0; i<nbr_elements; i++) {
-          // re-implementation is about 3-4 times faster than calling
-          // single-element put()
-          if (*new_elements == delim) ct++;
-          arr[writeindex] = *new_elements;
-          writeindex = (writeindex + 1) % (CAPACITY+1);
-          new_elements++;
+    const size_t new_delims = yarb_count(new_elements, nbr_elements, delim);
+    if (new_delims) {
+        // record positions if all older delimiters are recorded
+        if (msgct == ct) indexBlock(new_elements, nbr_elements, idx::pos(writeindex));
+        ct += new_delims;
+        TIME::added(new_delims);
+    }
+    // copy in at most two segments: 
+    // from writeindex to end of array, then from start of array
+    const size_t w = idx::pos(writeindex);
+    const size_t diff_to_end = idx::slots - w;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        memcpy(arr+w, new_elements, nbr_elements);
     }
+    else {
+        memcpy(arr+w, new_elements, diff_to_end);
+        memcpy(arr, new_elements+diff_to_end, nbr_elements-diff_to_end);
+    }
+    writeindex = idx::advance(writeindex, nbr_elements);
+    CRC::added(new_elements, nbr_elements, delim);
+    this->statsAdded(requested, nbr_elements, this->size());
     return nbr_elements;
 }
 
-template <size_t CAPACITY>
-size_t YaRBct<CAPACITY>::peek(uint8_t *peeked_element) const {
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::peek(uint8_t *peeked_element) const {
     // check for emptyness and validity of output pointer (may be nullptr)
     if (this->isEmpty() || !peeked_element) {
         return 0;
     }
     else {
-        *peeked_element = arr[readindex];
+        *peeked_element = arr[idx::pos(readindex)];
         return 1;
     }
 }
 
 // modified
-template <size_t CAPACITY>
-size_t YaRBct<CAPACITY>::discard(size_t nbr_elements) {
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::peek(uint8_t *peeked_element, size_t offset) const {
+    // check for enough elements and validity of output pointer (may be nullptr)
+    if (offset >= this->size() || !peeked_element) {
+        return 0;
+    }
+    else {
+        // do modulus calculation "manually" (see discard())
+        const size_t r = idx::pos(readindex);
+        const size_t diff_to_end = idx::slots - r;
+        *peeked_element = arr[(offset < diff_to_end) ? (r + offset) : (offset - diff_to_end)];
+        return 1;
+    }
+}
+
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const {
+    // check for nullptr
+    if (!peeked_elements) {
+        return 0;
+    }
+    // only peek at most the size()-offset elements after offset
+    const size_t used = this->size();
+    if (offset >= used) {
+        return 0;
+    }
+    if (nbr_elements > used - offset) {
+        nbr_elements = used - offset;
+    }
+    // first element to peek at, see peek(peeked_element, offset)
+    const size_t r = idx::pos(readindex);
+    const size_t diff = idx::slots - r;
+    const size_t start = (offset < diff) ? (r + offset) : (offset - diff);
+    // copy out in at most two segments, exactly like get(), but leave
+    // readindex unchanged
+    const size_t diff_to_end = idx::slots - start;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        memcpy(peeked_elements, arr+start, nbr_elements);
+    }
+    else {
+        memcpy(peeked_elements, arr+start, diff_to_end);
+        memcpy(peeked_elements+diff_to_end, arr, nbr_elements-diff_to_end);
+    }
+    return nbr_elements;
+}
+
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::discard(size_t nbr_elements) {
     if (this->size() > nbr_elements) { // there will be remaining elements in buffer
-        // use loop instead just index shifting
-        for (size_t i=0; i<nbr_elements; i++) {    
-            if (arr[readindex] == delim) ct--;
-            readindex = (readindex + 1 ) % (CAPACITY+1);
+        // count removed delimiters in at most two segments, 
+        // then shift readindex
+        size_t removed_delims;
+        size_t last;  // position of the last removed element
+        const size_t r = idx::pos(readindex);
+        const size_t diff_to_end = idx::slots - r;
+        if (nbr_elements <= diff_to_end) { // does not wrap
+            removed_delims = yarb_count(arr+r, nbr_elements, delim);
+            last = r + nbr_elements - 1;
+        }
+        else {
+            removed_delims  = yarb_count(arr+r, diff_to_end, delim);
+            removed_delims += yarb_count(arr, nbr_elements-diff_to_end, delim);
+            last = nbr_elements - diff_to_end - 1;
         }
+        ct -= removed_delims;
+        indexPop(removed_delims);
+        // the last removed byte was not a delimiter: the head message lost bytes
+        if (nbr_elements && arr[last] != delim) CRC::truncated();
+        readindex = idx::advance(readindex, nbr_elements);
+        this->statsRemoved(nbr_elements);
         return nbr_elements;
     }
     else { // discard *all* elements --> flush()
@@ -124,24 +222,88 @@ size_t YaRBct<CAPACITY>::discard(size_t nbr_elements) {
     }
 }
 
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::writeReserve(uint8_t **region) {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
+        return 0;
+    }
+    const size_t w = idx::pos(writeindex);
+    *region = arr+w;
+    // the free region ends at the end of the array at the latest
+    const size_t diff_to_end = idx::slots - w;
+    const size_t free_slots = this->free();
+    return (free_slots < diff_to_end) ? free_slots : diff_to_end;
+}
+
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::commit(size_t nbr_elements) {
+    // only commit at most the region writeReserve() reports
+    const size_t requested = nbr_elements;
+    uint8_t *region;
+    const size_t reserved = this->writeReserve(&region);
+    if (nbr_elements > reserved) {
+        nbr_elements = reserved;
+    }
+    // count (and record) new delimiters
+    const size_t new_delims = yarb_count(region, nbr_elements, delim);
+    if (new_delims) {
+        if (msgct == ct) indexBlock(region, nbr_elements, idx::pos(writeindex));
+        ct += new_delims;
+        TIME::added(new_delims);
+    }
+    writeindex = idx::advance(writeindex, nbr_elements);
+    CRC::added(region, nbr_elements, delim);
+    this->statsAdded(requested, nbr_elements, this->size());
+    return nbr_elements;
+}
+
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::readSpan(const uint8_t **region) const {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
+        return 0;
+    }
+    const size_t r = idx::pos(readindex);
+    *region = arr+r;
+    // the stored region ends at the end of the array at the latest
+    const size_t diff_to_end = idx::slots - r;
+    const size_t used = this->size();
+    return (used < diff_to_end) ? used : diff_to_end;
+}
 
-template <size_t CAPACITY>
-size_t YaRBct<CAPACITY>::get(uint8_t *returned_element) {
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::consume(size_t nbr_elements) {
+    return this->discard(nbr_elements);
+}
+
+
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::get(uint8_t *returned_element) {
     // check for emptyness and validity of output pointer (may  be nullptr)
     if (this->isEmpty() || !returned_element) {
+        if (this->isEmpty()) this->statsEmptyGet();
         return 0;
     }
     else {
-        if (arr[readindex] == delim) ct--;
-        *returned_element = arr[readindex];
-        readindex = (readindex + 1) % (CAPACITY+1);
+        const uint8_t element = arr[idx::pos(readindex)];
+        if (element == delim) {
+            ct--;
+            indexPop(1);
+        }
+        else {
+            CRC::truncated();
+        }
+        *returned_element = element;
+        readindex = idx::next(readindex);
+        this->statsRemoved(1);
         return 1;
     }
 }
 
 // modified
-template <size_t CAPACITY>
-size_t YaRBct<CAPACITY>::get(uint8_t *returned_elements, size_t nbr_elements) {
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::get(uint8_t *returned_elements, size_t nbr_elements) {
     // check for nullptr
     if (!returned_elements) {
         return 0;
@@ -149,65 +311,414 @@ size_t YaRBct<CAPACITY>::get(uint8_t *returned_elements, size_t nbr_elements) {
     else {
         // only get at most size() elements from buffer
         if (nbr_elements > this->size()) {
+            if (this->isEmpty() && nbr_elements) this->statsEmptyGet();
             nbr_elements = this->size();
         }
-        for (size_t i=0; i<nbr_elements; i++) {
-            if (arr[readindex] == delim) ct--;
-            *returned_elements = arr[readindex];
-            readindex = (readindex+1) % (CAPACITY+1);
-            returned_elements++;
+        // copy out in at most two segments:
+        // from readindex to end of array, then from start of array
+        const size_t r = idx::pos(readindex);
+        const size_t diff_to_end = idx::slots - r;
+        if (nbr_elements <= diff_to_end) { // does not wrap
+            memcpy(returned_elements, arr+r, nbr_elements);
         }
+        else {
+            memcpy(returned_elements, arr+r, diff_to_end);
+            memcpy(returned_elements+diff_to_end, arr, nbr_elements-diff_to_end);
+        }
+        readindex = idx::advance(readindex, nbr_elements);
+        // count removed delimiters in the (contiguous) output array
+        const size_t removed_delims = yarb_count(returned_elements, nbr_elements, delim);
+        ct -= removed_delims;
+        indexPop(removed_delims);
+        if (nbr_elements && returned_elements[nbr_elements-1] != delim) CRC::truncated();
+        this->statsRemoved(nbr_elements);
         return nbr_elements;
     }
 }
         
-template <size_t CAPACITY>
-size_t YaRBct<CAPACITY>::size(void) const {
-    if (writeindex >= readindex) {
-        return writeindex - readindex;
-    }
-    else {
-        return (CAPACITY+1) - (readindex - writeindex);
-    }
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::size(void) const {
+    return idx::used(readindex, writeindex);
 }
 
-template <size_t CAPACITY>
-size_t YaRBct<CAPACITY>::free(void) const {
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::free(void) const {
     return this->capacity() - this->size();
 }
 
-template <size_t CAPACITY>
-size_t YaRBct<CAPACITY>::capacity(void) const {
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::capacity(void) const {
     return CAPACITY;
 }
 
-template <size_t CAPACITY>
-bool YaRBct<CAPACITY>::isFull(void) const {
-    return readindex == (writeindex + 1) % (CAPACITY+1);
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+bool YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::isFull(void) const {
+    return idx::full(readindex, writeindex);
 }
 
-template <size_t CAPACITY>
-bool YaRBct<CAPACITY>::isEmpty(void) const {
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+bool YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::isEmpty(void) const {
     return readindex == writeindex;
 }
 
-template <size_t CAPACITY>
-void YaRBct<CAPACITY>::flush(void) {
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+void YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::flush(void) {
+    this->statsRemoved(this->size());
     // fast-forward readindex to position of writeindex
     readindex = writeindex;
     ct = 0;
+    msgct = 0;
+    CRC::reset(0, false);
+    TIME::reset(0);
 }
 
-template <size_t CAPACITY>
-size_t YaRBct<CAPACITY>::limit(void) {
-    return SIZE_MAX - 1;
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::limit(void) {
+    return idx::max_capacity;
 }
 
 /**
  * @brief      Get the count of delimiter bytes within ring buffer.
  * @return     Number of delimiter bytes currently stored in ring buffer.
  */
-template <size_t CAPACITY>
-size_t YaRBct<CAPACITY>::count(void) const {
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::count(void) const {
     return ct;
 }
+
+/**
+ * @brief      Get the delimiter for messages.
+ * @return     The delimiter given to the constructor.
+ */
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+uint8_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::delimiter(void) const {
+    return delim;
+}
+
+/**
+ * @brief      Get the length of the next complete message in the ring buffer.
+ * @details    A message consists of all bytes up to and @b including the
+ *             next delimiter byte.
+ * @return     Number of bytes in the next message, including the delimiter.
+ *             0 if there is no complete message in the ring buffer.
+ */
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::messageLength(void) {
+    if (ct == 0) {
+        return 0;
+    }
+    if (msgct == 0) {
+        // there are delimiters, but their positions are unknown
+        indexScan();
+    }
+    const size_t r = idx::pos(readindex);
+    const size_t delimpos = msgarray[msgfirst];
+    if (delimpos >= r) {
+        return delimpos - r + 1;
+    }
+    else {
+        return idx::slots - r + delimpos + 1;
+    }
+}
+
+/**
+ * @brief      Get exactly one complete message from the ring buffer, 
+ *             thereby removing it from the buffer.
+ * @details    If there is no complete message in the ring buffer or if
+ *             nbr_elements is too small to hold the message, nothing is
+ *             written to returned_elements and the ring buffer remains
+ *             unchanged.
+ * @param[out] returned_elements
+ *             Pointer to a uint8_t. The message (including the delimiter)
+ *             is stored in an array starting at this address.
+ * @param      nbr_elements
+ *             Size of the array returned_elements points to.
+ * @return     Number of bytes copied, including the delimiter. 
+ *             0 if nothing was copied.
+ */
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::getMessage(uint8_t *returned_elements, size_t nbr_elements) {
+    // check for nullptr
+    if (!returned_elements) {
+        return 0;
+    }
+    const size_t len = this->messageLength();
+    if (len == 0 || len > nbr_elements) {
+        return 0;
+    }
+    // copy out in at most two segments (see get()), but there is no need
+    // to count: the message contains exactly one delimiter
+    const size_t r = idx::pos(readindex);
+    const size_t diff_to_end = idx::slots - r;
+    if (len <= diff_to_end) { // does not wrap
+        memcpy(returned_elements, arr+r, len);
+    }
+    else {
+        memcpy(returned_elements, arr+r, diff_to_end);
+        memcpy(returned_elements+diff_to_end, arr, len-diff_to_end);
+    }
+    readindex = idx::advance(readindex, len);
+    ct--;
+    indexPop(1);
+    this->statsRemoved(len);
+    return len;
+}
+
+/**
+ * @brief      Discard (i.e. remove) exactly one complete message from the
+ *             ring buffer.
+ * @return     Number of bytes removed, including the delimiter. 
+ *             0 if there is no complete message in the ring buffer.
+ */
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::discardMessage(void) {
+    const size_t len = this->messageLength();
+    if (len == 0) {
+        return 0;
+    }
+    readindex = idx::advance(readindex, len);
+    ct--;
+    indexPop(1);
+    this->statsRemoved(len);
+    return len;
+}
+
+/**
+ * @brief      Get the CRC of the next complete message in the ring buffer.
+ * @details    See YaRBc::messageCrc().
+ * @param[out] crc
+ *             Pointer to a uint32_t to store the CRC in.
+ * @return     true if there is a complete message, false otherwise 
+ *             (nothing is stored).
+ */
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+bool YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::messageCrc(uint32_t *crc) {
+    // check for nullptr
+    if (!crc) {
+        return false;
+    }
+    const size_t len = this->messageLength();
+    if (len == 0) {
+        return false;
+    }
+    if (CRC::first(crc)) {
+        return true;
+    }
+    // calculate over at most two segments, without the delimiter
+    const size_t n = len - 1;
+    const size_t r = idx::pos(readindex);
+    const size_t diff_to_end = idx::slots - r;
+    if (n <= diff_to_end) { // does not wrap
+        *crc = CRC::calculate(arr+r, n, nullptr, 0);
+    }
+    else {
+        *crc = CRC::calculate(arr+r, diff_to_end, arr, n-diff_to_end);
+    }
+    return true;
+}
+
+/**
+ * @brief      Get exactly one complete message and its CRC from the ring
+ *             buffer, thereby removing it from the buffer.
+ * @details    See YaRBc::getMessage(uint8_t*, size_t, uint32_t*).
+ * @param[out] returned_elements
+ *             Pointer to a uint8_t. The message (including the delimiter)
+ *             is stored in an array starting at this address.
+ * @param      nbr_elements
+ *             Size of the array returned_elements points to.
+ * @param[out] crc
+ *             Pointer to a uint32_t to store the CRC of the message in.
+ * @return     Number of bytes copied, including the delimiter. 
+ *             0 if nothing was copied.
+ */
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::getMessage(uint8_t *returned_elements, size_t nbr_elements, uint32_t *crc) {
+    // check for nullptr
+    if (!returned_elements || this->messageLength() > nbr_elements || !this->messageCrc(crc)) {
+        return 0;
+    }
+    return this->getMessage(returned_elements, nbr_elements);
+}
+
+/**
+ * @brief      Get the timestamp of the next complete message in the ring 
+ *             buffer.
+ * @details    See YaRBc::messageTime().
+ * @param[out] timestamp
+ *             Pointer to a uint32_t to store the timestamp in.
+ * @return     true if there is a complete message with a timestamp, false
+ *             otherwise (nothing is stored).
+ */
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+bool YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::messageTime(uint32_t *timestamp) {
+    // check for nullptr
+    if (!timestamp || ct == 0) {
+        return false;
+    }
+    return TIME::first(timestamp);
+}
+
+/**
+ * @brief      Get exactly one complete message and its timestamp from the
+ *             ring buffer, thereby removing it from the buffer.
+ * @details    See YaRBc::getMessageTimed().
+ * @param[out] returned_elements
+ *             Pointer to a uint8_t. The message (including the delimiter)
+ *             is stored in an array starting at this address.
+ * @param      nbr_elements
+ *             Size of the array returned_elements points to.
+ * @param[out] timestamp
+ *             Pointer to a uint32_t to store the timestamp of the message in.
+ * @return     Number of bytes copied, including the delimiter. 
+ *             0 if nothing was copied.
+ */
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::getMessageTimed(uint8_t *returned_elements, size_t nbr_elements, uint32_t *timestamp) {
+    // check for nullptr
+    if (!returned_elements || this->messageLength() > nbr_elements || !this->messageTime(timestamp)) {
+        return 0;
+    }
+    return this->getMessage(returned_elements, nbr_elements);
+}
+
+/**
+ * @brief      COBS-encode a message and add it, including the delimiter.
+ * @details    The message is encoded directly into the array, no buffer
+ *             for the encoded message is needed. The message is only added
+ *             if it fits completely (also in overwrite mode). The encoded
+ *             message never contains the delimiter (see yarb_cobs.h).
+ * @param      raw
+ *             Pointer to the message. It may contain any byte values.
+ * @param      nbr_elements
+ *             Length of the message.
+ * @return     Number of bytes added: the encoded length including the
+ *             delimiter. 0 if the encoded message does not fit.
+ */
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::putMessageCobs(const uint8_t *raw, size_t nbr_elements) {
+    // check validity of input pointer (may be nullptr)
+    if (!raw) {
+        return 0;
+    }
+    const size_t len = yarb_cobs_encoded_size(raw, nbr_elements);
+    if (len > this->free()) {
+        this->statsRefused(len);
+        return 0;
+    }
+    yarb_cobs_encode_ring(raw, nbr_elements, arr, idx::slots, idx::pos(writeindex), delim);
+    // publish in at most two segments, commit() counts and records the delimiter
+    const size_t first = this->commit(len);
+    if (first < len) {
+        this->commit(len - first);
+    }
+    return len;
+}
+
+/**
+ * @brief      COBS-decode the next complete message and remove it.
+ * @details    The message is decoded directly from the array into decoded,
+ *             handling the wrap-around, no buffer for the encoded message
+ *             is needed. The message and its delimiter are removed. 
+ * @param      decoded
+ *             Pointer to an array for the decoded message.
+ * @param      nbr_elements
+ *             Size of the array decoded points to.
+ * @param[out] decoded_length
+ *             Pointer to a size_t. The length of the decoded message is
+ *             stored there, also if it does not fit into decoded.
+ * @return     Number of bytes removed from the ring buffer (the encoded
+ *             length including the delimiter). 0 if there is no complete 
+ *             message, if the decoded message does not fit (nothing is 
+ *             removed then) or if a pointer is nullptr.
+ */
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+size_t YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::getMessageCobs(uint8_t *decoded, size_t nbr_elements, size_t *decoded_length) {
+    // check for nullptr
+    if (!decoded || !decoded_length) {
+        return 0;
+    }
+    const size_t len = this->messageLength();
+    if (len == 0) {
+        return 0;
+    }
+    if (!yarb_cobs_decode_ring(arr, idx::slots, idx::pos(readindex), len-1, delim, 
+                               decoded, nbr_elements, decoded_length)) {
+        return 0;
+    }
+    return this->discardMessage();
+}
+
+/**
+ * @brief   Record the array position of a new delimiter (as the newest entry).
+ * @param   delimpos
+ *          Position of the new delimiter within the array.
+ */
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+void YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::indexAppend(size_t delimpos) {
+    if (msgct < MSGINDEX) {
+        size_t slot = msgfirst + msgct;
+        if (slot >= MSGINDEX) slot -= MSGINDEX;
+        msgarray[slot] = static_cast<INDEX>(delimpos);
+        msgct++;
+    }
+}
+
+/**
+ * @brief   Remove the positions (and CRC snapshots and timestamps) of the
+ *          oldest delimiters, because they were removed from the ring buffer.
+ * @param   nbr_delims
+ *          Number of removed delimiters.
+ */
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+void YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::indexPop(size_t nbr_delims) {
+    CRC::removed(nbr_delims);
+    TIME::removed(nbr_delims);
+    if (nbr_delims >= msgct) {
+        msgct = 0;
+        msgfirst = 0;
+    }
+    else {
+        msgct -= nbr_delims;
+        msgfirst += nbr_delims;
+        if (msgfirst >= MSGINDEX) msgfirst -= MSGINDEX;
+    }
+}
+
+/**
+ * @brief   Record the positions of delimiters in a contiguous block of
+ *          new elements, until msgarray is full.
+ * @param   data
+ *          Pointer to the new elements (need not be within the ring buffer).
+ * @param   nbr_elements
+ *          Number of new elements.
+ * @param   start
+ *          Array position where data[0] is (or will be) stored.
+ */
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+void YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::indexBlock(const uint8_t *data, size_t nbr_elements, size_t start) {
+    const uint8_t *p = data;
+    const uint8_t * const end = data + nbr_elements;
+    while (msgct < MSGINDEX && p < end) {
+        p = static_cast<const uint8_t*>(memchr(p, delim, end - p));
+        if (!p) break;
+        size_t delimpos = start + (p - data);
+        if (delimpos >= idx::slots) delimpos -= idx::slots;
+        indexAppend(delimpos);
+        p++;
+    }
+}
+
+/**
+ * @brief   Scan the stored elements for delimiters from readindex on,
+ *          when there are delimiters in the ring buffer, but their
+ *          positions are not recorded.
+ */
+template <size_t CAPACITY, size_t MSGINDEX, class STATS, class CRC, class TIME, typename INDEX>
+void YaRBct<CAPACITY, MSGINDEX, STATS, CRC, TIME, INDEX>::indexScan(void) {
+    // scan in at most two segments, see readSpan()
+    const uint8_t *region;
+    const size_t first = this->readSpan(&region);
+    const size_t second = this->size() - first;
+    indexBlock(region, first, idx::pos(readindex));
+    indexBlock(arr, second, 0);
+}
@@ -0,0 +1,149 @@
+/**
+ * @file    yarbd.h
+ * @brief   Header file for DMA-fed ring buffers in a template version
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarbd_h License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef yarbd_h
+#define yarbd_h
+
+#include "yarb_interface.h"
+#include "yarb_atomic.h"
+#include "yarb_index.h"
+#include "yarb_count.h"
+
+/**
+ * @class   YaRBdt
+ * @brief   Ring buffer whose array is written directly by hardware, e.g. by
+ *          a DMA channel in circular mode, with tracking of delimiter bytes.
+ * @details The DMA channel is set up once to write into dmaBuffer() with a
+ *          length of dmaLength() bytes, wrapping around at the end. There
+ *          is no CPU copy on the receive path. Before reading, the position
+ *          of the hardware is reported with syncPosition() or syncRemaining(),
+ *          which makes all bytes received so far available to get(),
+ *          discard(), count() etc.
+ *
+ *          The hardware is the only producer: put() and commit() never
+ *          add anything, writeReserve() never reports a free region.
+ * @note    The template parameter CAPACITY is the size of the array and
+ *          the DMA transfer. As for YaRBt, one byte cannot be used to 
+ *          distinguish a full from an empty buffer, so capacity() is 
+ *          CAPACITY-1.
+ * @note    ALIGN is the alignment of the array in bytes. 
+ * @warning The hardware does not stop when the ring buffer is full. Unread
+ *          bytes are overwritten when the consumer falls behind. This is
+ *          detected by the next sync (see overruns()), as long as the 
+ *          hardware advanced less than CAPACITY bytes since the last sync.
+ * @warning All functions must be called from the same context (e.g. only
+ *          from loop()).
+ */
+template <size_t CAPACITY = 64, size_t ALIGN = 4> 
+class YaRBdt final : public IYaRB {
+    public:
+        // sanity checking
+        static_assert(CAPACITY > 1, "not allowed to instantiate template with CAPACITY<2");
+        static_assert(ALIGN > 0 && (ALIGN & (ALIGN - 1)) == 0, "ALIGN must be a power of two");
+        
+        // constructor
+        YaRBdt(uint8_t delimiter=0);
+        
+        // do not allow copies or assignments:
+        // the hardware writes into one particular array
+        YaRBdt(const YaRBdt &rb) = delete;
+        YaRBdt<CAPACITY, ALIGN>& operator= (const YaRBdt<CAPACITY, ALIGN> &rb) = delete;
+        
+        // destructor
+        virtual ~YaRBdt(void) = default;
+
+        // the hardware is the producer: nothing is added by these functions
+        size_t put(uint8_t new_element) override;
+        size_t put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) override;
+
+        // get/remove element(s) from ring buffer
+        size_t get(uint8_t *returned_element) override;
+        size_t get(uint8_t *returned_elements, size_t nbr_elements) override;
+        
+        // look at element(s) in ring buffer without removing them
+        size_t peek(uint8_t *peeked_element) const override; 
+        size_t peek(uint8_t *peeked_element, size_t offset) const override;
+        size_t peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const override;
+        
+        // discard some elements from ring buffer, 
+        // return number of discarded elements
+        size_t discard(size_t nbr_elements) override;
+
+        // zero-copy access to the internal array
+        // (writeReserve()/commit() never add anything, see put())
+        size_t writeReserve(uint8_t **region) override;
+        size_t commit(size_t nbr_elements) override;
+        size_t readSpan(const uint8_t **region) const override;
+        size_t consume(size_t nbr_elements) override;
+
+        size_t size(void) const override;     // return number of slots in use
+        size_t free(void) const override;     // return number of free slots
+        size_t capacity(void) const override; // return total number of slots
+
+        // functions *not* from interface, but special to this class
+        size_t count(void) const;             // return count of messages
+
+        // hardware side
+        uint8_t* dmaBuffer(void);             // return array for the hardware to write into
+        static size_t dmaLength(void);        // return size of that array in bytes (CAPACITY)
+        size_t syncPosition(size_t position); // hardware's next write position, return number of new bytes
+        size_t syncRemaining(size_t remaining); // same, from a remaining-count (BTCNT), return number of new bytes
+        size_t overruns(void) const;          // return number of detected overruns
+
+        bool   isFull(void) const override;   // return true when buffer is full
+        bool   isEmpty(void) const override;  // return true when buffer is empty
+        void   flush(void) override;          // clear all elements from buffer
+        
+        // no override for static functions...
+        static size_t limit(void);   // return maximum possible number of elements on a given platform
+
+    private:
+        const uint8_t delim;         ///< delimiter for messages 
+
+        // always the classic index arithmetic: array size must be CAPACITY
+        // (also for powers of two), indices stay within [0, CAPACITY)
+        typedef YaRBIndex<CAPACITY-1, false> idx;
+
+        size_t  readindex;           ///< index for get()
+        size_t  writeindex;          ///< hardware position at the last sync
+        size_t  ct;                  ///< counter for delimiter bytes
+        size_t  ovr;                 ///< counter for detected overruns
+        alignas(ALIGN) uint8_t arr[CAPACITY]; ///< array written by the hardware
+
+        // helper function for counting delimiters
+        size_t countRange(size_t start, size_t nbr_elements) const;
+};
+
+// include imlementation file for template here
+#include "yarbdt.hpp"
+
+#endif // yarbd_h
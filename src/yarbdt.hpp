@@ -0,0 +1,366 @@
+/**
+ * @file    yarbdt.hpp
+ * @brief   Implementation file for DMA-fed ring buffers in a template version
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarbdt_hpp License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>  // memcpy()
+
+/*
+ * Note:
+ * The read side is the same as for YaRBct, without the message index. 
+ * writeindex is not advanced by put(), but set to the position of the
+ * hardware by syncPosition(). The delimiters in the new bytes are counted
+ * once at that point, so count() is always exact for the bytes known to
+ * the ring buffer.
+ *
+ * The number of new bytes is the distance from the last known position,
+ * so an overrun can only be detected if the hardware advanced less than
+ * CAPACITY bytes between two syncs.
+ */
+
+/**
+ * @brief   The constructor.
+ * @details This is the default constructor with one optional argument,
+ *          the delimiting byte. 
+ *          Capacity is not given as a parameter to the constructor, but
+ *          as a template parameter
+ */
+template <size_t CAPACITY, size_t ALIGN>
+YaRBdt<CAPACITY, ALIGN>::YaRBdt(uint8_t delimiter) 
+    : delim{delimiter}, readindex{0}, writeindex{0}, ct{0}, ovr{0} {
+}
+
+template <size_t CAPACITY, size_t ALIGN>
+size_t YaRBdt<CAPACITY, ALIGN>::put(uint8_t) {
+    return 0;
+}
+
+template <size_t CAPACITY, size_t ALIGN>
+size_t YaRBdt<CAPACITY, ALIGN>::put(const uint8_t *, size_t, bool) {
+    return 0;
+}
+
+template <size_t CAPACITY, size_t ALIGN>
+size_t YaRBdt<CAPACITY, ALIGN>::peek(uint8_t *peeked_element) const {
+    // check for emptyness and validity of output pointer (may be nullptr)
+    if (this->isEmpty() || !peeked_element) {
+        return 0;
+    }
+    else {
+        *peeked_element = arr[readindex];
+        return 1;
+    }
+}
+
+template <size_t CAPACITY, size_t ALIGN>
+size_t YaRBdt<CAPACITY, ALIGN>::peek(uint8_t *peeked_element, size_t offset) const {
+    // check for enough elements and validity of output pointer (may be nullptr)
+    if (offset >= this->size() || !peeked_element) {
+        return 0;
+    }
+    else {
+        // do modulus calculation "manually" (see discard())
+        const size_t r = readindex;
+        const size_t diff_to_end = idx::slots - r;
+        *peeked_element = arr[(offset < diff_to_end) ? (r + offset) : (offset - diff_to_end)];
+        return 1;
+    }
+}
+
+template <size_t CAPACITY, size_t ALIGN>
+size_t YaRBdt<CAPACITY, ALIGN>::peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const {
+    // check for nullptr
+    if (!peeked_elements) {
+        return 0;
+    }
+    // only peek at most the size()-offset elements after offset
+    const size_t used = this->size();
+    if (offset >= used) {
+        return 0;
+    }
+    if (nbr_elements > used - offset) {
+        nbr_elements = used - offset;
+    }
+    // first element to peek at, see peek(peeked_element, offset)
+    const size_t r = readindex;
+    const size_t diff = idx::slots - r;
+    const size_t start = (offset < diff) ? (r + offset) : (offset - diff);
+    // copy out in at most two segments, exactly like get(), but leave
+    // readindex unchanged
+    const size_t diff_to_end = idx::slots - start;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        memcpy(peeked_elements, arr+start, nbr_elements);
+    }
+    else {
+        memcpy(peeked_elements, arr+start, diff_to_end);
+        memcpy(peeked_elements+diff_to_end, arr, nbr_elements-diff_to_end);
+    }
+    return nbr_elements;
+}
+
+template <size_t CAPACITY, size_t ALIGN>
+size_t YaRBdt<CAPACITY, ALIGN>::discard(size_t nbr_elements) {
+    if (this->size() > nbr_elements) { // there will be remaining elements in buffer
+        ct -= countRange(readindex, nbr_elements);
+        readindex = idx::advance(readindex, nbr_elements);
+        return nbr_elements;
+    }
+    else { // discard *all* elements --> flush()
+        // we can only discard at many elements as are in the buffer
+        // --> return size()
+        const size_t retval = this->size();
+        this->flush();
+        return retval;
+    }
+}
+
+template <size_t CAPACITY, size_t ALIGN>
+size_t YaRBdt<CAPACITY, ALIGN>::writeReserve(uint8_t **) {
+    // the hardware owns the free region
+    return 0;
+}
+
+template <size_t CAPACITY, size_t ALIGN>
+size_t YaRBdt<CAPACITY, ALIGN>::commit(size_t) {
+    return 0;
+}
+
+template <size_t CAPACITY, size_t ALIGN>
+size_t YaRBdt<CAPACITY, ALIGN>::readSpan(const uint8_t **region) const {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
+        return 0;
+    }
+    const size_t r = readindex;
+    *region = arr+r;
+    // the stored region ends at the end of the array at the latest
+    const size_t diff_to_end = idx::slots - r;
+    const size_t used = this->size();
+    return (used < diff_to_end) ? used : diff_to_end;
+}
+
+template <size_t CAPACITY, size_t ALIGN>
+size_t YaRBdt<CAPACITY, ALIGN>::consume(size_t nbr_elements) {
+    return this->discard(nbr_elements);
+}
+
+template <size_t CAPACITY, size_t ALIGN>
+size_t YaRBdt<CAPACITY, ALIGN>::get(uint8_t *returned_element) {
+    // check for emptyness and validity of output pointer (may  be nullptr)
+    if (this->isEmpty() || !returned_element) {
+        return 0;
+    }
+    else {
+        const uint8_t element = arr[readindex];
+        if (element == delim) ct--;
+        *returned_element = element;
+        readindex = idx::next(readindex);
+        return 1;
+    }
+}
+
+template <size_t CAPACITY, size_t ALIGN>
+size_t YaRBdt<CAPACITY, ALIGN>::get(uint8_t *returned_elements, size_t nbr_elements) {
+    // check for nullptr
+    if (!returned_elements) {
+        return 0;
+    }
+    else {
+        // only get at most size() elements from buffer
+        if (nbr_elements > this->size()) {
+            nbr_elements = this->size();
+        }
+        // copy out in at most two segments:
+        // from readindex to end of array, then from start of array
+        const size_t r = readindex;
+        const size_t diff_to_end = idx::slots - r;
+        if (nbr_elements <= diff_to_end) { // does not wrap
+            memcpy(returned_elements, arr+r, nbr_elements);
+        }
+        else {
+            memcpy(returned_elements, arr+r, diff_to_end);
+            memcpy(returned_elements+diff_to_end, arr, nbr_elements-diff_to_end);
+        }
+        readindex = idx::advance(readindex, nbr_elements);
+        // count removed delimiters in the (contiguous) output array
+        ct -= yarb_count(returned_elements, nbr_elements, delim);
+        return nbr_elements;
+    }
+}
+        
+template <size_t CAPACITY, size_t ALIGN>
+size_t YaRBdt<CAPACITY, ALIGN>::size(void) const {
+    return idx::used(readindex, writeindex);
+}
+
+template <size_t CAPACITY, size_t ALIGN>
+size_t YaRBdt<CAPACITY, ALIGN>::free(void) const {
+    return this->capacity() - this->size();
+}
+
+template <size_t CAPACITY, size_t ALIGN>
+size_t YaRBdt<CAPACITY, ALIGN>::capacity(void) const {
+    return CAPACITY-1;
+}
+
+template <size_t CAPACITY, size_t ALIGN>
+bool YaRBdt<CAPACITY, ALIGN>::isFull(void) const {
+    return idx::full(readindex, writeindex);
+}
+
+template <size_t CAPACITY, size_t ALIGN>
+bool YaRBdt<CAPACITY, ALIGN>::isEmpty(void) const {
+    return readindex == writeindex;
+}
+
+template <size_t CAPACITY, size_t ALIGN>
+void YaRBdt<CAPACITY, ALIGN>::flush(void) {
+    // fast-forward readindex to the last known hardware position
+    readindex = writeindex;
+    ct = 0;
+}
+
+template <size_t CAPACITY, size_t ALIGN>
+size_t YaRBdt<CAPACITY, ALIGN>::limit(void) {
+    return idx::max_capacity;
+}
+
+/**
+ * @brief      Get the count of delimiter bytes within ring buffer.
+ * @return     Number of delimiter bytes currently stored in ring buffer.
+ */
+template <size_t CAPACITY, size_t ALIGN>
+size_t YaRBdt<CAPACITY, ALIGN>::count(void) const {
+    return ct;
+}
+
+/**
+ * @brief      Get the array the hardware writes into.
+ * @return     Pointer to the array, aligned to ALIGN bytes.
+ */
+template <size_t CAPACITY, size_t ALIGN>
+uint8_t* YaRBdt<CAPACITY, ALIGN>::dmaBuffer(void) {
+    return arr;
+}
+
+/**
+ * @brief      Get the size of the array the hardware writes into.
+ * @return     CAPACITY
+ */
+template <size_t CAPACITY, size_t ALIGN>
+size_t YaRBdt<CAPACITY, ALIGN>::dmaLength(void) {
+    return CAPACITY;
+}
+
+/**
+ * @brief      Make the bytes written by the hardware available.
+ * @param      position
+ *             Array position the hardware writes to next, 
+ *             0 <= position <= CAPACITY (CAPACITY is the same as 0).
+ * @return     Number of new bytes since the last sync. 0 if position is
+ *             out of range.
+ * @note       If the new bytes do not fit into the ring buffer, unread 
+ *             bytes were overwritten by the hardware. Only the newest 
+ *             capacity() bytes are kept and the overrun is counted.
+ */
+template <size_t CAPACITY, size_t ALIGN>
+size_t YaRBdt<CAPACITY, ALIGN>::syncPosition(size_t position) {
+    if (position > CAPACITY) {
+        return 0;
+    }
+    if (position == CAPACITY) {
+        position = 0;
+    }
+    // the array must be read only after the position
+    yarb_fence_acquire();
+    const size_t new_bytes = idx::used(writeindex, position);
+    if (this->size() + new_bytes > this->capacity()) {
+        // overrun: readindex points to overwritten bytes, keep the 
+        // newest bytes and count again
+        ovr++;
+        readindex = idx::next(position);
+        ct = countRange(readindex, this->capacity());
+    }
+    else {
+        ct += countRange(writeindex, new_bytes);
+    }
+    writeindex = position;
+    return new_bytes;
+}
+
+/**
+ * @brief      Make the bytes written by the hardware available, using the
+ *             number of bytes remaining in the current transfer.
+ * @details    Many DMA controllers (e.g. the BTCNT register on SAMD) 
+ *             count down from CAPACITY to 0 and reload in circular mode.
+ * @param      remaining
+ *             Number of bytes until the hardware wraps back to the start
+ *             of the array, 0 < remaining <= CAPACITY (0 is the same as
+ *             CAPACITY).
+ * @return     Number of new bytes since the last sync (see syncPosition()).
+ */
+template <size_t CAPACITY, size_t ALIGN>
+size_t YaRBdt<CAPACITY, ALIGN>::syncRemaining(size_t remaining) {
+    if (remaining > CAPACITY) {
+        return 0;
+    }
+    return this->syncPosition(remaining ? (CAPACITY - remaining) : 0);
+}
+
+/**
+ * @brief      Get the number of overruns detected by syncPosition().
+ * @return     Number of detected overruns since construction.
+ */
+template <size_t CAPACITY, size_t ALIGN>
+size_t YaRBdt<CAPACITY, ALIGN>::overruns(void) const {
+    return ovr;
+}
+
+/**
+ * @brief   Count the delimiters in a range of the array.
+ * @param   start
+ *          Array position of the first byte of the range.
+ * @param   nbr_elements
+ *          Number of bytes in the range, may wrap around the end of 
+ *          the array.
+ * @return  Number of delimiters in the range.
+ */
+template <size_t CAPACITY, size_t ALIGN>
+size_t YaRBdt<CAPACITY, ALIGN>::countRange(size_t start, size_t nbr_elements) const {
+    // count in at most two segments
+    const size_t diff_to_end = idx::slots - start;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        return yarb_count(arr+start, nbr_elements, delim);
+    }
+    else {
+        return yarb_count(arr+start, diff_to_end, delim)
+             + yarb_count(arr, nbr_elements-diff_to_end, delim);
+    }
+}
@@ -0,0 +1,421 @@
+/**
+ * @file    yarbe.cpp
+ * @brief   Implementation file for an elastic (growable) ring buffer
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarbe_cpp License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+ 
+#include "yarbe.h"
+#include <string.h>  // memcpy()
+#include <new>       // std::nothrow
+
+/*
+ * Note:
+ * The algorithms are the same as for YaRB, except where the array is
+ * resized. put() only calls grow() when the ring buffer is full, so the
+ * steady state is exactly as fast as YaRB.
+ *
+ * When growing automatically, the capacity is at least doubled (but 
+ * limited by maxcap), so adding n elements one by one costs O(n) copies
+ * in total.
+ *
+ * A moved-from YaRBe has a capacity of 0 and shares a static dummy array
+ * with all other moved-from instances, which must never be deleted.
+ */
+static uint8_t yarbe_moved_from[1];
+
+/**
+ * @brief   The constructor.
+ * @param   capacity
+ *          The initial capacity of the ring buffer.
+ * @param   max_capacity
+ *          Ceiling for the capacity. If larger than capacity, put() grows
+ *          the ring buffer automatically up to this capacity. reserve()
+ *          never exceeds it either. 0 (default): no automatic growth
+ *          and no ceiling for reserve() except limit().
+ * @note    capacity is the effectively usable capacity of the ring buffer.
+ *          This implementation allocates one additional byte internally.
+ */
+YaRBe::YaRBe(size_t capacity, size_t max_capacity) 
+    : cap{capacity+1}, maxcap{(max_capacity && max_capacity < capacity) ? capacity : max_capacity}, 
+      readindex{0}, writeindex{0}, arraypointer{nullptr} {
+    arraypointer = new uint8_t[cap];
+}
+
+/**
+ * @brief   The copy constructor.
+ * @param   rb
+ *          Reference to class instance to copy.
+ */
+YaRBe::YaRBe(const YaRBe &rb)
+    : cap{rb.cap}, maxcap{rb.maxcap}, readindex{0}, writeindex{0}, arraypointer{nullptr} {
+    arraypointer = new uint8_t[cap];
+    *this = rb;
+}
+
+/**
+ * @brief   The move constructor.
+ * @details The array is taken over from rb, nothing is allocated or 
+ *          copied. rb is left with a capacity of 0.
+ * @param   rb
+ *          Reference to class instance to move from.
+ */
+YaRBe::YaRBe(YaRBe &&rb)
+    : cap{rb.cap}, maxcap{rb.maxcap}, readindex{rb.readindex}, writeindex{rb.writeindex}, arraypointer{rb.arraypointer} {
+    rb.cap = 1;
+    rb.readindex = 0;
+    rb.writeindex = 0;
+    rb.arraypointer = yarbe_moved_from;
+}
+
+/**
+ * @brief   The destructor.
+ */
+YaRBe::~YaRBe() {
+    if (arraypointer != yarbe_moved_from) delete[] arraypointer;
+}
+
+/**
+ * @brief   The assignment operator.
+ * @details Afterwards, this ring buffer has the same capacity, ceiling and
+ *          contents as rb. Only the size() stored bytes are copied.
+ * @param   rb
+ *          Reference to class instance to copy.
+ * @return  Reference to this instance.
+ */
+YaRBe& YaRBe::operator=(const YaRBe &rb) {
+    // protect against self-assignment
+    if (this == &rb) return *this;
+    if (cap != rb.cap) {
+        if (arraypointer != yarbe_moved_from) delete[] arraypointer;
+        cap = rb.cap;
+        arraypointer = new uint8_t[cap];
+    }
+    maxcap = rb.maxcap;
+    readindex = rb.readindex;
+    writeindex = rb.writeindex;
+    // copy size() bytes to the same positions in at most two segments
+    const size_t n = rb.size();
+    const size_t diff_to_max = cap - readindex;
+    if (n <= diff_to_max) { // does not wrap
+        memcpy(arraypointer+readindex, rb.arraypointer+readindex, n);
+    }
+    else {
+        memcpy(arraypointer+readindex, rb.arraypointer+readindex, diff_to_max);
+        memcpy(arraypointer, rb.arraypointer, n-diff_to_max);
+    }
+    return *this;
+}
+
+/**
+ * @brief   The move assignment operator.
+ * @details The own array is freed and the array of rb is taken over. 
+ *          rb is left with a capacity of 0.
+ * @param   rb
+ *          Reference to class instance to move from.
+ * @return  Reference to this instance.
+ */
+YaRBe& YaRBe::operator=(YaRBe &&rb) {
+    // protect against self-assignment
+    if (this == &rb) return *this;
+    if (arraypointer != yarbe_moved_from) delete[] arraypointer;
+    cap = rb.cap;
+    maxcap = rb.maxcap;
+    readindex = rb.readindex;
+    writeindex = rb.writeindex;
+    arraypointer = rb.arraypointer;
+    rb.cap = 1;
+    rb.readindex = 0;
+    rb.writeindex = 0;
+    rb.arraypointer = yarbe_moved_from;
+    return *this;
+}
+
+size_t YaRBe::put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) {
+    // check validity of input pointer (may be nullptr)
+    if (!new_elements ) {
+        return 0;
+    }
+    // grow if allowed, then only add at most free() elements to ring buffer
+    if (nbr_elements > this->free()) {
+        grow(nbr_elements);
+        if (nbr_elements > this->free()) {
+            if (only_complete) return 0;
+            nbr_elements = this->free();
+        }
+    }
+    // copy in at most two segments: 
+    // from writeindex to end of array, then from start of array
+    const size_t diff_to_max = cap - writeindex;
+    if (nbr_elements < diff_to_max) { // does not wrap
+        memcpy(arraypointer+writeindex, new_elements, nbr_elements);
+        writeindex += nbr_elements;
+    }
+    else {
+        memcpy(arraypointer+writeindex, new_elements, diff_to_max);
+        memcpy(arraypointer, new_elements+diff_to_max, nbr_elements-diff_to_max);
+        writeindex = nbr_elements - diff_to_max;
+    }
+    return nbr_elements;
+}
+
+size_t YaRBe::peek(uint8_t *peeked_element, size_t offset) const {
+    // check for enough elements and validity of output pointer (may be nullptr)
+    if (offset >= this->size() || !peeked_element) {
+        return 0;
+    }
+    else {
+        // do modulus calculation "manually" (see discard())
+        const size_t r = readindex;
+        const size_t diff_to_end = cap - r;
+        *peeked_element = arraypointer[(offset < diff_to_end) ? (r + offset) : (offset - diff_to_end)];
+        return 1;
+    }
+}
+
+size_t YaRBe::peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const {
+    // check for nullptr
+    if (!peeked_elements) {
+        return 0;
+    }
+    // only peek at most the size()-offset elements after offset
+    const size_t used = this->size();
+    if (offset >= used) {
+        return 0;
+    }
+    if (nbr_elements > used - offset) {
+        nbr_elements = used - offset;
+    }
+    // first element to peek at, see peek(peeked_element, offset)
+    const size_t r = readindex;
+    const size_t diff = cap - r;
+    const size_t start = (offset < diff) ? (r + offset) : (offset - diff);
+    // copy out in at most two segments, exactly like get(), but leave
+    // readindex unchanged
+    const size_t diff_to_end = cap - start;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        memcpy(peeked_elements, arraypointer+start, nbr_elements);
+    }
+    else {
+        memcpy(peeked_elements, arraypointer+start, diff_to_end);
+        memcpy(peeked_elements+diff_to_end, arraypointer, nbr_elements-diff_to_end);
+    }
+    return nbr_elements;
+}
+
+size_t YaRBe::discard(size_t nbr_elements) {
+    if (this->size() > nbr_elements) { // there will be remaining elements in buffer
+        // do modulus calculation "manually" (see YaRB::discard())
+        const size_t diff_to_max = cap - readindex;
+        if (nbr_elements >= diff_to_max) { // readindex+nbr_elements >= cap --> wrap
+            readindex = nbr_elements - diff_to_max;
+        }
+        else { // adding nbr_elements to readindex does not wrap
+            readindex += nbr_elements;
+        }
+        return nbr_elements;
+    }
+    else { // discard *all* elements --> flush()
+        // we can only discard as many elements as are in the buffer
+        // --> return size()
+        const size_t retval = this->size();
+        this->flush();
+        return retval;
+    }
+}
+
+size_t YaRBe::writeReserve(uint8_t **region) {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
+        return 0;
+    }
+    const size_t w = writeindex;
+    *region = arraypointer+w;
+    // the free region ends at the end of the array at the latest
+    const size_t diff_to_end = cap - w;
+    const size_t free_slots = this->free();
+    return (free_slots < diff_to_end) ? free_slots : diff_to_end;
+}
+
+size_t YaRBe::commit(size_t nbr_elements) {
+    // only commit at most the region writeReserve() reports
+    uint8_t *region;
+    const size_t reserved = this->writeReserve(&region);
+    if (nbr_elements > reserved) {
+        nbr_elements = reserved;
+    }
+    // the region never wraps, but it may end exactly at the end of the array
+    writeindex += nbr_elements;
+    if (writeindex == cap) writeindex = 0;
+    return nbr_elements;
+}
+
+size_t YaRBe::readSpan(const uint8_t **region) const {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
+        return 0;
+    }
+    const size_t r = readindex;
+    *region = arraypointer+r;
+    // the stored region ends at the end of the array at the latest
+    const size_t diff_to_end = cap - r;
+    const size_t used = this->size();
+    return (used < diff_to_end) ? used : diff_to_end;
+}
+
+size_t YaRBe::consume(size_t nbr_elements) {
+    return this->discard(nbr_elements);
+}
+
+size_t YaRBe::get(uint8_t *returned_elements, size_t nbr_elements) {
+    // check for nullptr
+    if (!returned_elements) {
+        return 0;
+    }
+    else {
+        // only get at most size() elements from buffer
+        if (nbr_elements > this->size()) {
+            nbr_elements = this->size();
+        }
+        // copy out in at most two segments:
+        // from readindex to end of array, then from start of array
+        const size_t diff_to_max = cap - readindex;
+        if (nbr_elements < diff_to_max) { // does not wrap
+            memcpy(returned_elements, arraypointer+readindex, nbr_elements);
+            readindex += nbr_elements;
+        }
+        else {
+            memcpy(returned_elements, arraypointer+readindex, diff_to_max);
+            memcpy(returned_elements+diff_to_max, arraypointer, nbr_elements-diff_to_max);
+            readindex = nbr_elements - diff_to_max;
+        }
+        return nbr_elements;
+    }
+}
+        
+void YaRBe::flush(void) {
+    // fast-forward readindex to position of writeindex
+    readindex = writeindex;
+}
+
+size_t YaRBe::limit(void) {
+    return SIZE_MAX - 1;
+}
+
+/**
+ * @brief      Make sure the ring buffer can hold at least capacity elements.
+ * @details    The stored elements are kept. Nothing happens if capacity()
+ *             is already large enough.
+ * @param      capacity
+ *             The requested capacity.
+ * @return     @em true if capacity() is at least capacity afterwards, 
+ *             @em false if capacity exceeds maxCapacity() or limit(), or 
+ *             if the new array cannot be allocated.
+ */
+bool YaRBe::reserve(size_t capacity) {
+    if (capacity <= this->capacity()) {
+        return true;
+    }
+    if (capacity > limit() || (maxcap && capacity > maxcap)) {
+        return false;
+    }
+    return resize(capacity);
+}
+
+/**
+ * @brief      Reduce the capacity to the number of stored elements.
+ * @details    Afterwards, the ring buffer is full (or has a capacity of 0
+ *             when it is empty). Use this after a burst to give memory back.
+ */
+void YaRBe::shrinkToFit(void) {
+    if (this->size() < this->capacity()) {
+        resize(this->size());
+    }
+}
+
+/**
+ * @brief      Get the ceiling for the capacity.
+ * @return     The maximum capacity given to the constructor, 0 if there
+ *             is none.
+ */
+size_t YaRBe::maxCapacity(void) const {
+    return maxcap;
+}
+
+/**
+ * @brief   Grow the array automatically (if allowed) to make room for
+ *          new elements.
+ * @param   nbr_elements
+ *          Number of elements to add.
+ * @return  @em true if the capacity was increased.
+ */
+bool YaRBe::grow(size_t nbr_elements) {
+    // no automatic growth without a ceiling above the current capacity
+    const size_t current = this->capacity();
+    if (maxcap <= current) {
+        return false;
+    }
+    // at least double the capacity, but never exceed the ceiling
+    size_t target = (current > maxcap / 2) ? maxcap : 2 * current;
+    const size_t needed = (nbr_elements > maxcap - this->size()) ? maxcap : this->size() + nbr_elements;
+    if (target < needed) target = needed;
+    return resize(target);
+}
+
+/**
+ * @brief   Move the stored elements into a new array.
+ * @details The elements are copied in one pass (at most two segments) to
+ *          the start of the new array.
+ * @param   capacity
+ *          The new capacity, must be at least size().
+ * @return  @em true on success, @em false if the new array cannot be
+ *          allocated (the ring buffer is unchanged then).
+ */
+bool YaRBe::resize(size_t capacity) {
+    // no exception on hosted platforms: reserve(), grow() and put() fail softly
+    uint8_t *newarray = new (std::nothrow) uint8_t[capacity+1];
+    if (!newarray) {
+        return false;
+    }
+    // linearize: copy out like get(), but into the new array
+    const size_t n = this->size();
+    const size_t diff_to_max = cap - readindex;
+    if (n <= diff_to_max) { // does not wrap
+        memcpy(newarray, arraypointer+readindex, n);
+    }
+    else {
+        memcpy(newarray, arraypointer+readindex, diff_to_max);
+        memcpy(newarray+diff_to_max, arraypointer, n-diff_to_max);
+    }
+    if (arraypointer != yarbe_moved_from) delete[] arraypointer;
+    arraypointer = newarray;
+    cap = capacity+1;
+    readindex = 0;
+    writeindex = n;
+    return true;
+}
@@ -0,0 +1,182 @@
+/**
+ * @file    yarbe.h
+ * @brief   Header file for an elastic (growable) ring buffer
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarbe_h License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef yarbe_h
+#define yarbe_h
+
+#include "yarb_interface.h"
+
+/**
+ * @class   YaRBe
+ * @brief   Classic ring buffer implementation using a dynamically allocated
+ *          array and two indices, with a capacity that can change at run time.
+ * @details The capacity is changed explicitly with reserve() and 
+ *          shrinkToFit(). Optionally, put() grows the array automatically
+ *          when the ring buffer is full, up to a ceiling (max_capacity).
+ *          On every resize, the stored elements are copied into the new
+ *          array in one pass, starting at its beginning.
+ *
+ *          As long as the array is not resized, all functions work exactly
+ *          like those of YaRB and are just as fast.
+ * @warning Resizing invalidates pointers returned by writeReserve() and
+ *          readSpan().
+ * @warning This class is @b not interrupt-safe (see YaRB).
+ */
+class YaRBe final : public IYaRB {
+    public:
+        // constructor
+        YaRBe(size_t capacity=63, size_t max_capacity=0);
+        
+        // copy and move constructors
+        YaRBe(const YaRBe &rb);
+        YaRBe(YaRBe &&rb);
+        
+        // destructor
+        virtual ~YaRBe(void);
+        
+        // assignment and move assignment, see YaRB
+        YaRBe& operator= (const YaRBe &rb);
+        YaRBe& operator= (YaRBe &&rb);
+
+        // put element(s) into ring buffer, growing it if allowed
+        size_t put(uint8_t new_element) override;
+        size_t put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) override;
+
+        // get/remove element(s) from ring buffer
+        size_t get(uint8_t *returned_element) override;
+        size_t get(uint8_t *returned_elements, size_t nbr_elements) override;
+        
+        // look at element(s) in ring buffer without removing them
+        size_t peek(uint8_t *peeked_element) const override; 
+        size_t peek(uint8_t *peeked_element, size_t offset) const override;
+        size_t peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const override;
+        
+        // discard some elements from ring buffer, 
+        // return number of discarded elements
+        size_t discard(size_t nbr_elements) override;
+
+        // zero-copy access to the internal array (never grows the array)
+        size_t writeReserve(uint8_t **region) override;
+        size_t commit(size_t nbr_elements) override;
+        size_t readSpan(const uint8_t **region) const override;
+        size_t consume(size_t nbr_elements) override;
+
+        size_t size(void) const override;     // return number of slots in use
+        size_t free(void) const override;     // return number of free slots
+        size_t capacity(void) const override; // return total number of slots
+
+        // functions *not* from interface, but special to this class
+        bool   reserve(size_t capacity);      // grow to at least capacity, return true on success
+        void   shrinkToFit(void);             // shrink capacity to size()
+        size_t maxCapacity(void) const;       // return ceiling, 0 if there is none
+
+        bool   isFull(void) const override;   // return true when buffer is full
+        bool   isEmpty(void) const override;  // return true when buffer is empty
+        void   flush(void) override;          // clear all elements from buffer
+        
+        // no override for static functions...
+        static size_t limit(void);   // return maximum possible number of elements on a given platform
+
+    private:
+        size_t  cap;           ///< store size of internaly array
+        size_t  maxcap;        ///< ceiling for the capacity, 0 if none
+        size_t  readindex;     ///< index for get()
+        size_t  writeindex;    ///< index for put()
+        uint8_t *arraypointer; ///< pointer to array which holds the elements
+
+        // helper functions for resizing
+        bool   grow(size_t nbr_elements);
+        bool   resize(size_t capacity);
+};
+
+// inline definitions of the functions on the hot path
+
+inline size_t YaRBe::put(uint8_t new_element) {
+    // grow() is only called when the buffer is full
+    if (this->isFull() && !grow(1)) {
+        return 0;
+    }
+    arraypointer[writeindex] = new_element;
+    // no division, even on CPUs without hardware divider
+    writeindex = (writeindex + 1 == cap) ? 0 : (writeindex + 1);
+    return 1;
+}
+
+inline size_t YaRBe::peek(uint8_t *peeked_element) const {
+    // check for emptyness and validity of output pointer (may be nullptr)
+    if (this->isEmpty() || !peeked_element) {
+        return 0;
+    }
+    else {
+        *peeked_element = arraypointer[readindex];
+        return 1;
+    }
+}
+
+inline size_t YaRBe::get(uint8_t *returned_element) {
+    // check for emptyness and validity of output pointer (may  be nullptr)
+    if (this->isEmpty() || !returned_element) {
+        return 0;
+    }
+    else {
+        *returned_element = arraypointer[readindex];
+        readindex = (readindex + 1 == cap) ? 0 : (readindex + 1);
+        return 1;
+    }
+}
+
+inline size_t YaRBe::size(void) const {
+    if (writeindex >= readindex) {
+        return writeindex - readindex;
+    }
+    else {
+        return cap - (readindex - writeindex);
+    }
+}
+
+inline size_t YaRBe::free(void) const {
+    return this->capacity() - this->size();
+}
+
+inline size_t YaRBe::capacity(void) const {
+    return cap-1;
+}
+
+inline bool YaRBe::isFull(void) const {
+    return readindex == ((writeindex + 1 == cap) ? 0 : (writeindex + 1));
+}
+
+inline bool YaRBe::isEmpty(void) const {
+    return readindex == writeindex;
+}
+
+#endif // yarbe_h
@@ -0,0 +1,427 @@
+/**
+ * @file    yarbf.cpp
+ * @brief   Implementation file for a persistent ring buffer in a memory-mapped file (hosted platforms only)
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarbf_cpp License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "yarbf.h"
+
+#if defined(YARB_HOSTED)
+
+#include "yarb_crc.h"  // YaRBCrc32
+
+#include <string.h>    // memcpy(), memcmp(), memset()
+#include <fcntl.h>     // open()
+#include <unistd.h>    // sysconf(), ftruncate(), fsync(), close()
+#include <sys/file.h>  // flock()
+#include <sys/mman.h>  // mmap(), munmap(), msync()
+#include <sys/stat.h>  // fstat()
+
+/* YaRBf */
+
+constexpr size_t YaRBf::header_size;
+
+// layout of the header
+static const char     yarbf_magic[8] = {'Y', 'a', 'R', 'B', 'f', '0', '0', '1'};
+static const size_t   yarbf_capacity_offset = 8;     // uint64_t capacity
+static const size_t   yarbf_record_offset[2] = {512, 1024}; // one record per disk sector
+static const size_t   yarbf_record_size = 3*sizeof(uint64_t) + sizeof(uint32_t);
+
+/**
+ * @brief   Write an index record to the header.
+ * @param   dst
+ *          Start of the record.
+ * @param   seq, rd, wr
+ *          Sequence number, readindex and writeindex.
+ */
+static void yarbf_put_record(uint8_t *dst, uint64_t seq, uint64_t rd, uint64_t wr) {
+    uint8_t rec[yarbf_record_size];
+    memcpy(rec,                      &seq, sizeof(uint64_t));
+    memcpy(rec+sizeof(uint64_t),     &rd,  sizeof(uint64_t));
+    memcpy(rec+2*sizeof(uint64_t),   &wr,  sizeof(uint64_t));
+    const uint32_t crc = YaRBCrc32::final(YaRBCrc32::update(YaRBCrc32::init(), rec, 3*sizeof(uint64_t)));
+    memcpy(rec+3*sizeof(uint64_t),   &crc, sizeof(uint32_t));
+    memcpy(dst, rec, yarbf_record_size);
+}
+
+/**
+ * @brief   Read and check an index record from the header.
+ * @param   src
+ *          Start of the record.
+ * @param   cap
+ *          Capacity of the ring buffer.
+ * @param   seq, rd, wr
+ *          Output: sequence number, readindex and writeindex.
+ * @return  true if the record is valid.
+ */
+static bool yarbf_get_record(const uint8_t *src, size_t cap, uint64_t *seq, uint64_t *rd, uint64_t *wr) {
+    uint8_t rec[yarbf_record_size];
+    memcpy(rec, src, yarbf_record_size);
+    uint32_t crc;
+    memcpy(&crc, rec+3*sizeof(uint64_t), sizeof(uint32_t));
+    if (crc != YaRBCrc32::final(YaRBCrc32::update(YaRBCrc32::init(), rec, 3*sizeof(uint64_t)))) {
+        return false;
+    }
+    memcpy(seq, rec,                    sizeof(uint64_t));
+    memcpy(rd,  rec+sizeof(uint64_t),   sizeof(uint64_t));
+    memcpy(wr,  rec+2*sizeof(uint64_t), sizeof(uint64_t));
+    return *rd <= *wr && *wr - *rd <= cap;
+}
+
+/**
+ * @brief   The constructor.
+ * @details Opens the file, creating it if it does not exist. A new (or 
+ *          empty) file is initialized as an empty ring buffer. An existing 
+ *          ring buffer file is resumed with the contents published in its
+ *          newest valid index record.
+ * @param   path
+ *          Path of the file.
+ * @param   capacity
+ *          The capacity of a new file. Ignored for existing files.
+ * @param   sync_bytes
+ *          Durability policy: 0 to only sync in sync() and in the 
+ *          destructor, 1 to sync after every call which changes the 
+ *          contents, n to sync after at least n elements were added.
+ * @note    If the file cannot be used, capacity() will return 0.
+ */
+YaRBf::YaRBf(const char *path, size_t capacity, size_t sync_bytes)
+    : fd{-1}, pagesize{static_cast<size_t>(sysconf(_SC_PAGESIZE))}, cap{0}, syncbytes{sync_bytes},
+      mapping{nullptr}, arraypointer{nullptr},
+      readindex{0}, writeindex{0}, syncedread{0}, syncedwrite{0}, sequence{0} {
+    if (!open(path, capacity)) {
+        close();
+    }
+}
+
+/**
+ * @brief   The destructor.
+ * @details Syncs all elements and the indices and closes the file.
+ */
+YaRBf::~YaRBf() {
+    sync();
+    close();
+}
+
+/**
+ * @brief   Open, lock and map the file and read the indices.
+ * @param   path
+ *          Path of the file.
+ * @param   capacity
+ *          The capacity of a new file.
+ * @return  true on success.
+ */
+bool YaRBf::open(const char *path, size_t capacity) {
+    if (!path) return false;
+    fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) return false;
+
+    // read the header of an existing file
+    uint8_t header[header_size];
+    bool fresh = true;
+    if (st.st_size != 0) {
+        if (static_cast<size_t>(st.st_size) < header_size) return false;
+        if (pread(fd, header, header_size, 0) != static_cast<ssize_t>(header_size)) return false;
+        // all zeros: the file was created, but initialization did not finish
+        uint8_t zeros[sizeof(yarbf_magic)] = {0};
+        fresh = (memcmp(header, zeros, sizeof(yarbf_magic)) == 0);
+        if (!fresh) {
+            if (memcmp(header, yarbf_magic, sizeof(yarbf_magic)) != 0) return false;
+            uint64_t c;
+            memcpy(&c, header+yarbf_capacity_offset, sizeof(c));
+            if (c == 0 || c > limit() || static_cast<uint64_t>(st.st_size) != header_size + c) return false;
+            capacity = static_cast<size_t>(c);
+        }
+    }
+    if (fresh && (capacity == 0 || capacity > limit())) return false;
+    if (fresh && ftruncate(fd, static_cast<off_t>(header_size + capacity)) != 0) return false;
+
+    void *m = mmap(nullptr, header_size + capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (m == MAP_FAILED) return false;
+    mapping = static_cast<uint8_t*>(m);
+    arraypointer = mapping + header_size;
+    cap = capacity;
+
+    if (fresh) {
+        // write the header with a single valid record, then the magic
+        const uint64_t c = capacity;
+        memset(mapping, 0, header_size);
+        memcpy(mapping+yarbf_capacity_offset, &c, sizeof(c));
+        yarbf_put_record(mapping+yarbf_record_offset[0], 0, 0, 0);
+        if (!syncRange(mapping, header_size)) return false;
+        memcpy(mapping, yarbf_magic, sizeof(yarbf_magic));
+        if (!syncRange(mapping, header_size) || fsync(fd) != 0) return false;
+        return true;
+    }
+
+    // resume with the newest valid record
+    bool valid = false;
+    for (size_t i=0; i<2; i++) {
+        uint64_t seq, rd, wr;
+        if (yarbf_get_record(mapping+yarbf_record_offset[i], cap, &seq, &rd, &wr) && (!valid || seq > sequence)) {
+            valid = true;
+            sequence = seq;
+            readindex = syncedread = rd;
+            writeindex = syncedwrite = wr;
+        }
+    }
+    return valid;
+}
+
+/**
+ * @brief   Unmap and close the file.
+ */
+void YaRBf::close(void) {
+    if (mapping) {
+        munmap(mapping, header_size + cap);
+    }
+    if (fd >= 0) {
+        ::close(fd);  // also releases the lock
+    }
+    fd = -1;
+    cap = 0;
+    mapping = nullptr;
+    arraypointer = nullptr;
+    readindex = writeindex = syncedread = syncedwrite = 0;
+}
+
+/**
+ * @brief   Write bytes of the mapping to the file and wait for completion.
+ * @param   start
+ *          First byte to write.
+ * @param   nbr_bytes
+ *          Number of bytes to write.
+ * @return  true on success.
+ */
+bool YaRBf::syncRange(const uint8_t *start, size_t nbr_bytes) const {
+    // msync() needs an address aligned to a page
+    const size_t offset = static_cast<size_t>(start - mapping) % pagesize;
+    return msync(const_cast<uint8_t*>(start - offset), nbr_bytes + offset, MS_SYNC) == 0;
+}
+
+/**
+ * @brief   Publish the current readindex and the synced writeindex in
+ *          a new index record.
+ * @details The record overwrites the older of the two records, so the 
+ *          newest one stays intact if this write is torn.
+ * @return  true on success.
+ */
+bool YaRBf::writeRecord(void) {
+    if (!mapping) return false;
+    // removed elements which were never synced are not in any record
+    const uint64_t rd = (readindex < syncedwrite) ? readindex : syncedwrite;
+    sequence++;
+    uint8_t *rec = mapping + yarbf_record_offset[sequence & 1];
+    yarbf_put_record(rec, sequence, rd, syncedwrite);
+    syncedread = rd;
+    return syncRange(rec, yarbf_record_size);
+}
+
+/**
+ * @brief   Write all elements added since the last sync to the file, then 
+ *          publish the indices.
+ * @details Call this function to make sure the contents survive a crash,
+ *          e.g. before acknowledging data to its sender. With a 
+ *          @p sync_bytes of 0, this (and the destructor) are the only 
+ *          places where the file is synced.
+ * @return  true on success, false on an I/O error or if the file is not open.
+ */
+bool YaRBf::sync(void) {
+    if (!mapping) {
+        return false;
+    }
+    if (writeindex != syncedwrite) {
+        // the elements must be in the file before a record points to them
+        const size_t p0 = pos(syncedwrite);
+        const size_t n = static_cast<size_t>(writeindex - syncedwrite);
+        bool ok;
+        if (p0 + n <= cap) {
+            ok = syncRange(arraypointer+p0, n);
+        }
+        else { // two segments
+            ok = syncRange(arraypointer+p0, cap-p0) && syncRange(arraypointer, n-(cap-p0));
+        }
+        if (!ok) return false;
+        syncedwrite = writeindex;
+    }
+    else if (readindex == syncedread) {
+        return true; // nothing changed
+    }
+    return writeRecord();
+}
+
+/**
+ * @brief   Get the number of elements which were added, but not synced 
+ *          yet.
+ * @details These elements are lost in case of a crash.
+ * @return  Number of unsynced elements.
+ */
+size_t YaRBf::unsynced(void) const {
+    return static_cast<size_t>(writeindex - syncedwrite);
+}
+
+size_t YaRBf::put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) {
+    // check validity of input pointer (may be nullptr)
+    if (!new_elements) {
+        return 0;
+    }
+    // only add at most free() elements to ring buffer
+    if (nbr_elements > this->free()) {
+        if (only_complete) return 0;
+        nbr_elements = this->free();
+    }
+    if (nbr_elements == 0) {
+        return 0;
+    }
+    reclaim(nbr_elements);
+    const size_t p = pos(writeindex);
+    if (p + nbr_elements <= cap) {
+        memcpy(arraypointer+p, new_elements, nbr_elements);
+    }
+    else { // two segments
+        memcpy(arraypointer+p, new_elements, cap-p);
+        memcpy(arraypointer, new_elements+(cap-p), nbr_elements-(cap-p));
+    }
+    writeindex += nbr_elements;
+    added();  // a single sync for the whole block
+    return nbr_elements;
+}
+
+size_t YaRBf::peek(uint8_t *peeked_element, size_t offset) const {
+    // check for enough elements and validity of output pointer (may be nullptr)
+    if (offset >= this->size() || !peeked_element) {
+        return 0;
+    }
+    else {
+        *peeked_element = arraypointer[pos(readindex + offset)];
+        return 1;
+    }
+}
+
+size_t YaRBf::peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const {
+    // check for nullptr
+    if (!peeked_elements) {
+        return 0;
+    }
+    // only peek at most the size()-offset elements after offset
+    const size_t used = this->size();
+    if (offset >= used) {
+        return 0;
+    }
+    if (nbr_elements > used - offset) {
+        nbr_elements = used - offset;
+    }
+    const size_t p = pos(readindex + offset);
+    if (p + nbr_elements <= cap) {
+        memcpy(peeked_elements, arraypointer+p, nbr_elements);
+    }
+    else { // two segments
+        memcpy(peeked_elements, arraypointer+p, cap-p);
+        memcpy(peeked_elements+(cap-p), arraypointer, nbr_elements-(cap-p));
+    }
+    return nbr_elements;
+}
+
+size_t YaRBf::discard(size_t nbr_elements) {
+    // we can only discard at many elements as are in the buffer
+    if (nbr_elements > this->size()) {
+        nbr_elements = this->size();
+    }
+    if (nbr_elements != 0) {
+        readindex += nbr_elements;
+        removed();
+    }
+    return nbr_elements;
+}
+
+size_t YaRBf::writeReserve(uint8_t **region) {
+    // check validity of output pointer (may be nullptr)
+    if (!region || this->isFull()) {
+        return 0;
+    }
+    // free slots up to the end of the array
+    const size_t p = pos(writeindex);
+    const size_t n = (cap - p < this->free()) ? (cap - p) : this->free();
+    // the caller may write to all of them before commit()
+    reclaim(n);
+    *region = arraypointer+p;
+    return n;
+}
+
+size_t YaRBf::commit(size_t nbr_elements) {
+    if (nbr_elements > this->free()) {
+        nbr_elements = this->free();
+    }
+    if (nbr_elements != 0) {
+        writeindex += nbr_elements;
+        added();
+    }
+    return nbr_elements;
+}
+
+size_t YaRBf::readSpan(const uint8_t **region) const {
+    // check validity of output pointer (may be nullptr)
+    if (!region || this->isEmpty()) {
+        return 0;
+    }
+    // stored elements up to the end of the array
+    const size_t p = pos(readindex);
+    *region = arraypointer+p;
+    return (cap - p < this->size()) ? (cap - p) : this->size();
+}
+
+size_t YaRBf::consume(size_t nbr_elements) {
+    return this->discard(nbr_elements);
+}
+
+size_t YaRBf::get(uint8_t *returned_elements, size_t nbr_elements) {
+    // check nullptr
+    if (!returned_elements) {
+        return 0;
+    }
+    nbr_elements = this->peek(returned_elements, nbr_elements, 0);
+    return this->discard(nbr_elements);
+}
+        
+void YaRBf::flush(void) {
+    // fast-forward readindex to position of writeindex
+    if (readindex != writeindex) {
+        readindex = writeindex;
+        removed();
+    }
+}
+
+size_t YaRBf::limit(void) {
+    // the whole file must fit into the address space
+    return SIZE_MAX - header_size;
+}
+
+#endif // YARB_HOSTED
@@ -0,0 +1,260 @@
+/**
+ * @file    yarbf.h
+ * @brief   Header file for a persistent ring buffer in a memory-mapped file (hosted platforms only)
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarbf_h License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef yarbf_h
+#define yarbf_h
+
+#include "yarb_interface.h"
+
+#if defined(YARB_HOSTED)
+
+/**
+ * @class   YaRBf
+ * @brief   Persistent ring buffer, the array and the indices are stored
+ *          in a memory-mapped file ("f" for file).
+ * @details The file starts with a header of YaRBf::header_size bytes,
+ *          followed by the array. The header holds two index records
+ *          (sequence number, readindex, writeindex, CRC-32), which are
+ *          written alternately. After a crash, the valid record with the
+ *          highest sequence number is used, so a torn write of one record
+ *          falls back to the previous one. Opening an existing file only
+ *          reads these two records, nothing is rebuilt.
+ *
+ *          The indices are 64 bit counters which are never reduced, the
+ *          position in the array is the index modulo capacity().
+ *
+ *          Elements added are only published in a record after they were
+ *          written to the file with msync(). A record never exposes
+ *          elements which were not synced. Elements removed are published
+ *          lazily: after a crash, they may be returned again (at-least-once
+ *          delivery), but never with other contents.
+ *
+ *          When elements are synced is determined by the @p sync_bytes
+ *          argument of the constructor:
+ *
+ *          @li 0: only in sync() and in the destructor
+ *          @li 1: after every call which adds elements (the indices are
+ *              also written after every call which removes elements)
+ *          @li n: as soon as at least n elements were added since the
+ *              last sync
+ *
+ * @note    The capacity of an existing file is taken from the file, the
+ *          @p capacity argument of the constructor is only used for new 
+ *          files. If the file cannot be opened, locked or mapped, or is
+ *          not a valid ring buffer file, capacity() returns 0 and every 
+ *          put() or get() fails.
+ * @note    The file is locked with flock(), only one instance (in any
+ *          process) can use it at the same time. The file format uses
+ *          the byte order of the host.
+ * @note    This class is only available on hosted platforms (Linux, macOS),
+ *          i.e. if YARB_HOSTED is defined.
+ * @warning This class is @b not thread-safe.
+ */
+class YaRBf final : public IYaRB {
+    public:
+        static constexpr size_t header_size = 4096; ///< size of the file header (bytes)
+
+        // constructor: open or create the file
+        YaRBf(const char *path, size_t capacity=4096, size_t sync_bytes=4096);
+
+        // destructor: sync and close the file
+        virtual ~YaRBf(void);
+
+        // a file cannot be copied or assigned
+        YaRBf(const YaRBf &rb) = delete;
+        YaRBf& operator= (const YaRBf &rb) = delete;
+
+        // put element(s) into ring buffer
+        size_t put(uint8_t new_element) override;
+        size_t put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) override;
+
+        // get/remove element(s) from ring buffer
+        size_t get(uint8_t *returned_element) override;
+        size_t get(uint8_t *returned_elements, size_t nbr_elements) override;
+        
+        // look at element(s) in ring buffer without removing them
+        size_t peek(uint8_t *peeked_element) const override; 
+        size_t peek(uint8_t *peeked_element, size_t offset) const override;
+        size_t peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const override;
+        
+        // discard some elements from ring buffer, 
+        // return number of discarded elements
+        size_t discard(size_t nbr_elements) override;
+
+        // zero-copy access to the internal array
+        size_t writeReserve(uint8_t **region) override;
+        size_t commit(size_t nbr_elements) override;
+        size_t readSpan(const uint8_t **region) const override;
+        size_t consume(size_t nbr_elements) override;
+
+        size_t size(void) const override;     // return number of slots in use
+        size_t free(void) const override;     // return number of free slots
+        size_t capacity(void) const override; // return total number of slots
+
+        bool   isFull(void) const override;   // return true when buffer is full
+        bool   isEmpty(void) const override;  // return true when buffer is empty
+        void   flush(void) override;          // clear all elements from buffer
+
+        bool   sync(void);                    // write elements and indices to the file
+        size_t unsynced(void) const;          // return number of elements added since last sync
+        
+        // no override for static functions...
+        static size_t limit(void);   // return maximum possible number of elements on a given platform
+
+    private:
+        int      fd;            ///< file descriptor, kept open for the lock
+        size_t   pagesize;      ///< page size of the operating system
+        size_t   cap;           ///< capacity of ring buffer
+        size_t   syncbytes;     ///< durability policy, see constructor
+        uint8_t  *mapping;      ///< start of the mapping of the whole file
+        uint8_t  *arraypointer; ///< start of the array, mapping+header_size
+        uint64_t readindex;     ///< index for get()
+        uint64_t writeindex;    ///< index for put()
+        uint64_t syncedread;    ///< readindex in the newest record
+        uint64_t syncedwrite;   ///< writeindex in the newest record
+        uint64_t sequence;      ///< sequence number of the newest record
+
+        size_t   pos(uint64_t val) const;
+        void     reclaim(size_t nbr_elements);
+        void     added(void);
+        void     removed(void);
+        bool     writeRecord(void);
+        bool     syncRange(const uint8_t *start, size_t nbr_bytes) const;
+        bool     open(const char *path, size_t capacity);
+        void     close(void);
+};
+
+// inline definitions of the functions on the hot path
+
+/**
+ * @brief   Get the position within the array for an index.
+ * @param   val
+ *          Index.
+ * @return  Position within the array.
+ */
+inline size_t YaRBf::pos(uint64_t val) const {
+    return static_cast<size_t>(val % cap);
+}
+
+/**
+ * @brief   Make sure new elements do not overwrite elements still
+ *          published in the newest record.
+ * @details Elements which were removed, but are still part of the newest
+ *          record, would be returned after a crash. Before their slots 
+ *          are reused, a new record is written.
+ * @param   nbr_elements
+ *          Number of elements which will be added, at most free().
+ */
+inline void YaRBf::reclaim(size_t nbr_elements) {
+    if (syncedread < syncedwrite && writeindex + nbr_elements > syncedread + cap) {
+        writeRecord();
+    }
+}
+
+/**
+ * @brief   Apply the durability policy after elements were added.
+ */
+inline void YaRBf::added(void) {
+    if (syncbytes != 0 && writeindex - syncedwrite >= syncbytes) {
+        sync();
+    }
+}
+
+/**
+ * @brief   Apply the durability policy after elements were removed.
+ */
+inline void YaRBf::removed(void) {
+    if (syncbytes == 1) {
+        writeRecord();
+    }
+}
+
+inline size_t YaRBf::put(uint8_t new_element) {
+    if (this->isFull()) {
+        return 0;
+    }
+    else {
+        reclaim(1);
+        arraypointer[pos(writeindex)] = new_element;
+        writeindex++;
+        added();
+        return 1;
+    }
+}
+
+inline size_t YaRBf::peek(uint8_t *peeked_element) const {
+    // check for emptyness and validity of output pointer (may be nullptr)
+    if (this->isEmpty() || !peeked_element) {
+        return 0;
+    }
+    else {
+        *peeked_element = arraypointer[pos(readindex)];
+        return 1;
+    }
+}
+
+inline size_t YaRBf::get(uint8_t *returned_element) {
+    // check for emptyness and validity of output pointer (may  be nullptr)
+    if (this->isEmpty() || !returned_element) {
+        return 0;
+    }
+    else {
+        *returned_element = arraypointer[pos(readindex)];
+        readindex++;
+        removed();
+        return 1;
+    }
+}
+
+inline size_t YaRBf::size(void) const {
+    return static_cast<size_t>(writeindex - readindex);
+}
+
+inline size_t YaRBf::free(void) const {
+    return cap - this->size();
+}
+
+inline size_t YaRBf::capacity(void) const {
+    return cap;
+}
+
+inline bool YaRBf::isFull(void) const {
+    return this->size() == cap;
+}
+
+inline bool YaRBf::isEmpty(void) const {
+    return writeindex == readindex;
+}
+
+#endif // YARB_HOSTED
+
+#endif // yarbf_h
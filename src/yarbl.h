@@ -0,0 +1,140 @@
+/**
+ * @file    yarbl.h
+ * @brief   Header file for ring buffers with several producers and consumers, protected by a lock policy
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarbl_h License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef yarbl_h
+#define yarbl_h
+
+#include "yarb_interface.h"
+#include "yarb_index.h"
+#include "yarb_lock.h"
+
+/**
+ * @class   YaRBlt
+ * @brief   Ring buffer for several producers and consumers, e.g. ISRs of
+ *          different priorities ("l" for lock).
+ * @details Every put() and get() is done in three steps: 
+ *
+ *          @li reserve a range of slots (with the lock held)
+ *          @li copy the data (without the lock)
+ *          @li publish the range (with the lock held)
+ *
+ *          So the lock is only held for a few instructions, independent of
+ *          the number of bytes copied. Each side has a reserved and a 
+ *          published index plus a count of pending copies. The published
+ *          index catches up with the reserved one when the last pending 
+ *          copy is finished. With nested ISRs this is always the outermost
+ *          one, no context ever waits for another one.
+ *
+ *          Bytes added by a put() interrupted by another put() become
+ *          visible for get() when both are finished.
+ * @tparam  CAPACITY
+ *          The usable capacity. Internally, one additional byte is 
+ *          allocated, unless CAPACITY is a power of two (see YaRBt).
+ * @tparam  LOCK
+ *          Lock policy (see yarb_lock.h): YaRBLockNone, YaRBLockIrq, 
+ *          YaRBLockBasepri<LEVEL> or YaRBLockMutex.
+ * @note    The zero-copy functions writeReserve()/commit() and 
+ *          readSpan()/consume() do not reserve the region they return. 
+ *          Only use them with a single producer or consumer, respectively.
+ */
+template <size_t CAPACITY = 63, class LOCK = YaRBLockNone>
+class YaRBlt final : public IYaRB {
+    public:
+        // sanity checking
+        static_assert(CAPACITY > 0, "not allowed to instantiate template with CAPACITY=0");
+
+        // constructor
+        YaRBlt(void);
+
+        // do not allow copies or assignments:
+        // the indices might be changed concurrently while copying
+        YaRBlt(const YaRBlt &rb) = delete;
+        YaRBlt<CAPACITY, LOCK>& operator= (const YaRBlt<CAPACITY, LOCK> &rb) = delete;
+
+        // destructor
+        virtual ~YaRBlt(void) = default;
+
+        // put element(s) into ring buffer
+        size_t put(uint8_t new_element) override;
+        size_t put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) override;
+
+        // get/remove element(s) from ring buffer
+        size_t get(uint8_t *returned_element) override;
+        size_t get(uint8_t *returned_elements, size_t nbr_elements) override;
+
+        // look at element(s) in ring buffer without removing them
+        size_t peek(uint8_t *peeked_element) const override;
+        size_t peek(uint8_t *peeked_element, size_t offset) const override;
+        size_t peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const override;
+
+        // discard some elements from ring buffer,
+        // return number of discarded elements
+        size_t discard(size_t nbr_elements) override;
+
+        // zero-copy access to the internal array (single producer/consumer only)
+        size_t writeReserve(uint8_t **region) override;
+        size_t commit(size_t nbr_elements) override;
+        size_t readSpan(const uint8_t **region) const override;
+        size_t consume(size_t nbr_elements) override;
+
+        size_t size(void) const override;     // return number of slots ready for get()
+        size_t free(void) const override;     // return number of slots ready for put()
+        size_t capacity(void) const override; // return total number of slots
+
+        bool   isFull(void) const override;   // return true when buffer is full
+        bool   isEmpty(void) const override;  // return true when buffer is empty
+        void   flush(void) override;          // clear all elements from buffer
+
+        // no override for static functions...
+        static size_t limit(void);   // return maximum possible number of elements on a given platform
+
+    private:
+        typedef YaRBIndex<CAPACITY> idx; ///< index arithmetic, selected by CAPACITY
+
+        mutable LOCK lk;             ///< lock policy, protects all indices and counters
+        size_t  wres;                ///< end of slots reserved by put()
+        size_t  wpub;                ///< end of slots ready for get()
+        size_t  rres;                ///< end of slots reserved by get()
+        size_t  rpub;                ///< end of slots ready for put()
+        uint8_t wpend;               ///< number of unfinished copies into the array
+        uint8_t rpend;               ///< number of unfinished copies out of the array
+        uint8_t arr[idx::slots];     ///< array which holds the elements
+
+        // copy in/out in at most two segments, starting at raw index start
+        void   copyIn(size_t start, const uint8_t *src, size_t nbr_elements);
+        void   copyOut(uint8_t *dst, size_t start, size_t nbr_elements) const;
+};
+
+// include imlementation file for template here
+#include "yarblt.hpp"
+
+#endif // yarbl_h
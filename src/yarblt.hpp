@@ -0,0 +1,344 @@
+/**
+ * @file    yarblt.hpp
+ * @brief   Implementation file for ring buffers with several producers and consumers, protected by a lock policy
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarblt_hpp License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>  // memcpy()
+
+/*
+ * Note:
+ * The slots of the array are divided by the four indices (in this order)
+ *
+ *     [rpub, rres)  being copied out by get()/peek()
+ *     [rres, wpub)  stored, ready for get()
+ *     [wpub, wres)  being copied in by put()
+ *     [wres, rpub)  free, ready for put()
+ *
+ * All indices and both counters are only accessed with the lock held.
+ * A range is reserved by advancing wres (rres) and incrementing wpend 
+ * (rpend). When the copy is finished, wpend (rpend) is decremented and,
+ * if it reaches zero, wpub (rpub) is set to wres (rres).
+ */
+
+/**
+ * @brief   The constructor.
+ * @details Capacity is given as a template parameter.
+ */
+template <size_t CAPACITY, class LOCK>
+YaRBlt<CAPACITY, LOCK>::YaRBlt(void)
+    : lk{}, wres{0}, wpub{0}, rres{0}, rpub{0}, wpend{0}, rpend{0} {
+}
+
+template <size_t CAPACITY, class LOCK>
+void YaRBlt<CAPACITY, LOCK>::copyIn(size_t start, const uint8_t *src, size_t nbr_elements) {
+    const size_t w = idx::pos(start);
+    const size_t diff_to_end = idx::slots - w;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        memcpy(arr+w, src, nbr_elements);
+    }
+    else {
+        memcpy(arr+w, src, diff_to_end);
+        memcpy(arr, src+diff_to_end, nbr_elements-diff_to_end);
+    }
+}
+
+template <size_t CAPACITY, class LOCK>
+void YaRBlt<CAPACITY, LOCK>::copyOut(uint8_t *dst, size_t start, size_t nbr_elements) const {
+    const size_t r = idx::pos(start);
+    const size_t diff_to_end = idx::slots - r;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        memcpy(dst, arr+r, nbr_elements);
+    }
+    else {
+        memcpy(dst, arr+r, diff_to_end);
+        memcpy(dst+diff_to_end, arr, nbr_elements-diff_to_end);
+    }
+}
+
+template <size_t CAPACITY, class LOCK>
+size_t YaRBlt<CAPACITY, LOCK>::put(uint8_t new_element) {
+    // a single byte is written with the lock held: 
+    // this is cheaper than locking twice
+    const typename LOCK::state s = lk.lock();
+    if (idx::used(rpub, wres) == CAPACITY) {
+        lk.unlock(s);
+        return 0;
+    }
+    arr[idx::pos(wres)] = new_element;
+    wres = idx::next(wres);
+    if (wpend == 0) {
+        wpub = wres;
+    }
+    lk.unlock(s);
+    return 1;
+}
+
+template <size_t CAPACITY, class LOCK>
+size_t YaRBlt<CAPACITY, LOCK>::put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) {
+    // check validity of input pointer (may be nullptr)
+    if (!new_elements) {
+        return 0;
+    }
+    // reserve at most the free slots
+    typename LOCK::state s = lk.lock();
+    const size_t free_slots = CAPACITY - idx::used(rpub, wres);
+    if (nbr_elements > free_slots) {
+        nbr_elements = only_complete ? 0 : free_slots;
+    }
+    if (nbr_elements == 0) {
+        lk.unlock(s);
+        return 0;
+    }
+    const size_t start = wres;
+    wres = idx::advance(wres, nbr_elements);
+    wpend++;
+    lk.unlock(s);
+    // copy without the lock
+    this->copyIn(start, new_elements, nbr_elements);
+    // publish, if no other copy is pending
+    s = lk.lock();
+    if (--wpend == 0) {
+        wpub = wres;
+    }
+    lk.unlock(s);
+    return nbr_elements;
+}
+
+template <size_t CAPACITY, class LOCK>
+size_t YaRBlt<CAPACITY, LOCK>::get(uint8_t *returned_element) {
+    // check validity of output pointer (may be nullptr)
+    if (!returned_element) {
+        return 0;
+    }
+    // a single byte is read with the lock held, see put()
+    const typename LOCK::state s = lk.lock();
+    if (rres == wpub) {
+        lk.unlock(s);
+        return 0;
+    }
+    *returned_element = arr[idx::pos(rres)];
+    rres = idx::next(rres);
+    if (rpend == 0) {
+        rpub = rres;
+    }
+    lk.unlock(s);
+    return 1;
+}
+
+template <size_t CAPACITY, class LOCK>
+size_t YaRBlt<CAPACITY, LOCK>::get(uint8_t *returned_elements, size_t nbr_elements) {
+    // check for nullptr
+    if (!returned_elements) {
+        return 0;
+    }
+    // reserve at most the stored elements
+    typename LOCK::state s = lk.lock();
+    const size_t used = idx::used(rres, wpub);
+    if (nbr_elements > used) {
+        nbr_elements = used;
+    }
+    if (nbr_elements == 0) {
+        lk.unlock(s);
+        return 0;
+    }
+    const size_t start = rres;
+    rres = idx::advance(rres, nbr_elements);
+    rpend++;
+    lk.unlock(s);
+    // copy without the lock
+    this->copyOut(returned_elements, start, nbr_elements);
+    // release slots, if no other copy is pending
+    s = lk.lock();
+    if (--rpend == 0) {
+        rpub = rres;
+    }
+    lk.unlock(s);
+    return nbr_elements;
+}
+
+template <size_t CAPACITY, class LOCK>
+size_t YaRBlt<CAPACITY, LOCK>::peek(uint8_t *peeked_element) const {
+    return this->peek(peeked_element, 0);
+}
+
+template <size_t CAPACITY, class LOCK>
+size_t YaRBlt<CAPACITY, LOCK>::peek(uint8_t *peeked_element, size_t offset) const {
+    // check validity of output pointer (may be nullptr)
+    if (!peeked_element) {
+        return 0;
+    }
+    const typename LOCK::state s = lk.lock();
+    if (offset >= idx::used(rres, wpub)) {
+        lk.unlock(s);
+        return 0;
+    }
+    *peeked_element = arr[idx::pos(idx::advance(rres, offset))];
+    lk.unlock(s);
+    return 1;
+}
+
+template <size_t CAPACITY, class LOCK>
+size_t YaRBlt<CAPACITY, LOCK>::peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const {
+    // check for nullptr
+    if (!peeked_elements) {
+        return 0;
+    }
+    // the peeked elements are not reserved, so they are copied with the 
+    // lock held: a consumer could remove them and a producer could 
+    // overwrite them while copying
+    const typename LOCK::state s = lk.lock();
+    const size_t used = idx::used(rres, wpub);
+    if (offset >= used) {
+        lk.unlock(s);
+        return 0;
+    }
+    if (nbr_elements > used - offset) {
+        nbr_elements = used - offset;
+    }
+    this->copyOut(peeked_elements, idx::advance(rres, offset), nbr_elements);
+    lk.unlock(s);
+    return nbr_elements;
+}
+
+template <size_t CAPACITY, class LOCK>
+size_t YaRBlt<CAPACITY, LOCK>::discard(size_t nbr_elements) {
+    const typename LOCK::state s = lk.lock();
+    const size_t used = idx::used(rres, wpub);
+    if (nbr_elements > used) {
+        nbr_elements = used;
+    }
+    rres = idx::advance(rres, nbr_elements);
+    if (rpend == 0) {
+        rpub = rres;
+    }
+    lk.unlock(s);
+    return nbr_elements;
+}
+
+template <size_t CAPACITY, class LOCK>
+size_t YaRBlt<CAPACITY, LOCK>::writeReserve(uint8_t **region) {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
+        return 0;
+    }
+    const typename LOCK::state s = lk.lock();
+    const size_t w = idx::pos(wres);
+    const size_t free_slots = CAPACITY - idx::used(rpub, wres);
+    lk.unlock(s);
+    *region = arr+w;
+    // the free region ends at the end of the array at the latest
+    const size_t diff_to_end = idx::slots - w;
+    return (free_slots < diff_to_end) ? free_slots : diff_to_end;
+}
+
+template <size_t CAPACITY, class LOCK>
+size_t YaRBlt<CAPACITY, LOCK>::commit(size_t nbr_elements) {
+    const typename LOCK::state s = lk.lock();
+    // only commit at most the region writeReserve() reports
+    const size_t diff_to_end = idx::slots - idx::pos(wres);
+    const size_t free_slots = CAPACITY - idx::used(rpub, wres);
+    const size_t reserved = (free_slots < diff_to_end) ? free_slots : diff_to_end;
+    if (nbr_elements > reserved) {
+        nbr_elements = reserved;
+    }
+    wres = idx::advance(wres, nbr_elements);
+    if (wpend == 0) {
+        wpub = wres;
+    }
+    lk.unlock(s);
+    return nbr_elements;
+}
+
+template <size_t CAPACITY, class LOCK>
+size_t YaRBlt<CAPACITY, LOCK>::readSpan(const uint8_t **region) const {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
+        return 0;
+    }
+    const typename LOCK::state s = lk.lock();
+    const size_t r = idx::pos(rres);
+    const size_t used = idx::used(rres, wpub);
+    lk.unlock(s);
+    *region = arr+r;
+    // the stored region ends at the end of the array at the latest
+    const size_t diff_to_end = idx::slots - r;
+    return (used < diff_to_end) ? used : diff_to_end;
+}
+
+template <size_t CAPACITY, class LOCK>
+size_t YaRBlt<CAPACITY, LOCK>::consume(size_t nbr_elements) {
+    return this->discard(nbr_elements);
+}
+
+template <size_t CAPACITY, class LOCK>
+size_t YaRBlt<CAPACITY, LOCK>::size(void) const {
+    const typename LOCK::state s = lk.lock();
+    const size_t used = idx::used(rres, wpub);
+    lk.unlock(s);
+    return used;
+}
+
+template <size_t CAPACITY, class LOCK>
+size_t YaRBlt<CAPACITY, LOCK>::free(void) const {
+    const typename LOCK::state s = lk.lock();
+    const size_t free_slots = CAPACITY - idx::used(rpub, wres);
+    lk.unlock(s);
+    return free_slots;
+}
+
+template <size_t CAPACITY, class LOCK>
+size_t YaRBlt<CAPACITY, LOCK>::capacity(void) const {
+    return CAPACITY;
+}
+
+template <size_t CAPACITY, class LOCK>
+bool YaRBlt<CAPACITY, LOCK>::isFull(void) const {
+    return this->free() == 0;
+}
+
+template <size_t CAPACITY, class LOCK>
+bool YaRBlt<CAPACITY, LOCK>::isEmpty(void) const {
+    return this->size() == 0;
+}
+
+template <size_t CAPACITY, class LOCK>
+void YaRBlt<CAPACITY, LOCK>::flush(void) {
+    const typename LOCK::state s = lk.lock();
+    rres = wpub;
+    if (rpend == 0) {
+        rpub = rres;
+    }
+    lk.unlock(s);
+}
+
+template <size_t CAPACITY, class LOCK>
+size_t YaRBlt<CAPACITY, LOCK>::limit(void) {
+    return idx::max_capacity;
+}
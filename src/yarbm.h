@@ -0,0 +1,148 @@
+/**
+ * @file    yarbm.h
+ * @brief   Header file for lock-free multi-producer/multi-consumer ring buffers
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarbm_h License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef yarbm_h
+#define yarbm_h
+
+#include "yarb_interface.h"
+#include "yarb_index.h"
+#include "yarb_atomic.h"
+
+#if defined(YARB_HAS_CAS)
+
+/**
+ * @class   YaRBmt
+ * @brief   Ring buffer for several producers and several consumers on 
+ *          different cores, without locks ("m" for multi).
+ * @details Each side has a head index (end of the slots claimed so far)
+ *          and a tail index (end of the slots finished so far). put()
+ *          claims its whole range of slots with one compare-and-swap on 
+ *          the producer head, copies the data and then advances the 
+ *          producer tail. get() works the same way on the consumer side.
+ *          Bulk operations therefore cost one atomic operation, not one
+ *          per byte.
+ *
+ *          The tails are advanced in the order the ranges were claimed: a
+ *          put() which finishes copying before an older put() waits for 
+ *          it. This wait is only a few instructions long - unless the
+ *          older put() was interrupted or preempted: then it spins until
+ *          the older context runs again, which never happens if the 
+ *          waiting context has the higher priority (an ISR interrupting 
+ *          loop(), a high-priority RTOS task preempting a low-priority 
+ *          one). So at most one context per core may use a given YaRBmt,
+ *          use YaRBlt otherwise. Threads of a hosted program are the only
+ *          exception: the time-sharing scheduler of the operating system
+ *          eventually runs the older thread again.
+ * @tparam  CAPACITY
+ *          The capacity, must be a power of two. All slots are used.
+ * @note    The zero-copy functions writeReserve()/commit() and 
+ *          readSpan()/consume() are not supported, they always return 0.
+ *          peek() is only reliable with a single consumer.
+ * @note    Not available on AVR (no compare-and-swap, single core). On 
+ *          Cortex-M0/M0+ (e.g. RP2040), the compiler calls library 
+ *          functions for the atomic operations, which the core or SDK has
+ *          to provide. YaRBmt is therefore only available there if 
+ *          YARB_ARMV6M_ATOMICS is defined before including the library.
+ */
+template <size_t CAPACITY = 64>
+class YaRBmt final : public IYaRB {
+    public:
+        // sanity checking
+        static_assert(yarb_is_pow2(CAPACITY), "CAPACITY must be a power of two");
+
+        // constructor
+        YaRBmt(void);
+
+        // do not allow copies or assignments:
+        // the indices might be changed concurrently while copying
+        YaRBmt(const YaRBmt &rb) = delete;
+        YaRBmt<CAPACITY>& operator= (const YaRBmt<CAPACITY> &rb) = delete;
+
+        // destructor
+        virtual ~YaRBmt(void) = default;
+
+        // put element(s) into ring buffer
+        size_t put(uint8_t new_element) override;
+        size_t put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) override;
+
+        // get/remove element(s) from ring buffer
+        size_t get(uint8_t *returned_element) override;
+        size_t get(uint8_t *returned_elements, size_t nbr_elements) override;
+
+        // look at element(s) in ring buffer without removing them (single consumer only)
+        size_t peek(uint8_t *peeked_element) const override;
+        size_t peek(uint8_t *peeked_element, size_t offset) const override;
+        size_t peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const override;
+
+        // discard some elements from ring buffer,
+        // return number of discarded elements
+        size_t discard(size_t nbr_elements) override;
+
+        // zero-copy access to the internal array: not supported
+        size_t writeReserve(uint8_t **region) override;
+        size_t commit(size_t nbr_elements) override;
+        size_t readSpan(const uint8_t **region) const override;
+        size_t consume(size_t nbr_elements) override;
+
+        size_t size(void) const override;     // return number of slots ready for get()
+        size_t free(void) const override;     // return number of slots ready for put()
+        size_t capacity(void) const override; // return total number of slots
+
+        bool   isFull(void) const override;   // return true when buffer is full
+        bool   isEmpty(void) const override;  // return true when buffer is empty
+        void   flush(void) override;          // clear all elements from buffer
+
+        // no override for static functions...
+        static size_t limit(void);   // return maximum possible number of elements on a given platform
+
+    private:
+        typedef YaRBFreeIndex<CAPACITY> idx; ///< index arithmetic, free-running indices
+
+        size_t  whead;               ///< end of slots claimed by put()
+        size_t  wtail;               ///< end of slots ready for get()
+        size_t  rhead;               ///< end of slots claimed by get()
+        size_t  rtail;               ///< end of slots ready for put()
+        uint8_t arr[CAPACITY];       ///< array which holds the elements
+
+        // claim up to nbr_elements slots, return number of claimed slots
+        size_t claimWrite(size_t *start, size_t nbr_elements, bool only_complete);
+        size_t claimRead(size_t *start, size_t nbr_elements);
+        // wait for older claims, then hand over the slots to the other side
+        static void finish(size_t *tail, size_t start, size_t nbr_elements);
+};
+
+// include imlementation file for template here
+#include "yarbmt.hpp"
+
+#endif // YARB_HAS_CAS
+
+#endif // yarbm_h
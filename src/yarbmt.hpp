@@ -0,0 +1,321 @@
+/**
+ * @file    yarbmt.hpp
+ * @brief   Implementation file for lock-free multi-producer/multi-consumer ring buffers
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarbmt_hpp License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>  // memcpy()
+#if defined(YARB_HOSTED)
+#include <sched.h>   // sched_yield()
+#endif
+
+/*
+ * Note:
+ * All four indices are free-running (see yarb_index.h): they are only
+ * ever incremented, the number of slots between two of them is simply
+ * their difference. At any time
+ *
+ *     rtail <= rhead <= wtail <= whead <= rtail + CAPACITY
+ *
+ * A producer claims [whead, whead+n) with a compare-and-swap, if the n
+ * slots are free, i.e. if whead+n <= rtail+CAPACITY. A consumer claims
+ * [rhead, rhead+n) if rhead+n <= wtail. Copying is done without any
+ * synchronization, as no other context touches claimed slots. Finally,
+ * the tail is advanced from start to start+n when it has reached start,
+ * i.e. when all older claims are finished.
+ *
+ * The indices of the other side are read before the own head, so that
+ * the difference can never be "negative". If the own head has moved on
+ * in between, the compare-and-swap fails and the free (or stored) slots
+ * are calculated again.
+ */
+
+/**
+ * @brief   The constructor.
+ * @details Capacity is given as a template parameter.
+ */
+template <size_t CAPACITY>
+YaRBmt<CAPACITY>::YaRBmt(void)
+    : whead{0}, wtail{0}, rhead{0}, rtail{0} {
+}
+
+template <size_t CAPACITY>
+size_t YaRBmt<CAPACITY>::claimWrite(size_t *start, size_t nbr_elements, bool only_complete) {
+    size_t h = yarb_load_relaxed(&whead);
+    size_t n;
+    do {
+        const size_t r = yarb_load_acquire(&rtail);
+        const size_t used = h - r;
+        // used > CAPACITY: h is outdated, the compare-and-swap will fail
+        const size_t free_slots = (used < CAPACITY) ? (CAPACITY - used) : 0;
+        n = nbr_elements;
+        if (n > free_slots) {
+            n = only_complete ? 0 : free_slots;
+        }
+        if (n == 0 && used <= CAPACITY) {
+            return 0;
+        }
+    } while (!yarb_compare_exchange(&whead, &h, h + n));
+    *start = h;
+    return n;
+}
+
+template <size_t CAPACITY>
+size_t YaRBmt<CAPACITY>::claimRead(size_t *start, size_t nbr_elements) {
+    size_t h = yarb_load_relaxed(&rhead);
+    size_t n;
+    do {
+        const size_t w = yarb_load_acquire(&wtail);
+        const size_t used = w - h;
+        // used > CAPACITY: h is outdated, the compare-and-swap will fail
+        n = (nbr_elements < used) ? nbr_elements : used;
+        if (n == 0) {
+            return 0;
+        }
+        if (used > CAPACITY) {
+            n = 0;
+        }
+    } while (!yarb_compare_exchange(&rhead, &h, h + n));
+    *start = h;
+    return n;
+}
+
+template <size_t CAPACITY>
+void YaRBmt<CAPACITY>::finish(size_t *tail, size_t start, size_t nbr_elements) {
+    // wait for all older claims of the same side; this never ends if one
+    // of them was preempted on the same core (at most one context per core)
+    for (unsigned spins = 1; yarb_load_acquire(tail) != start; spins++) {
+        yarb_cpu_relax();
+#if defined(YARB_HOSTED)
+        // the older claim may belong to a thread which is not running,
+        // the time-sharing scheduler will run it again
+        if ((spins % 64) == 0) {
+            sched_yield();
+        }
+#endif
+    }
+    yarb_store_release(tail, start + nbr_elements);
+}
+
+template <size_t CAPACITY>
+size_t YaRBmt<CAPACITY>::put(uint8_t new_element) {
+    size_t start;
+    if (!this->claimWrite(&start, 1, true)) {
+        return 0;
+    }
+    arr[idx::pos(start)] = new_element;
+    finish(&wtail, start, 1);
+    return 1;
+}
+
+template <size_t CAPACITY>
+size_t YaRBmt<CAPACITY>::put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) {
+    // check validity of input pointer (may be nullptr)
+    if (!new_elements) {
+        return 0;
+    }
+    size_t start;
+    nbr_elements = this->claimWrite(&start, nbr_elements, only_complete);
+    if (nbr_elements == 0) {
+        return 0;
+    }
+    // copy in at most two segments
+    const size_t w = idx::pos(start);
+    const size_t diff_to_end = CAPACITY - w;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        memcpy(arr+w, new_elements, nbr_elements);
+    }
+    else {
+        memcpy(arr+w, new_elements, diff_to_end);
+        memcpy(arr, new_elements+diff_to_end, nbr_elements-diff_to_end);
+    }
+    finish(&wtail, start, nbr_elements);
+    return nbr_elements;
+}
+
+template <size_t CAPACITY>
+size_t YaRBmt<CAPACITY>::get(uint8_t *returned_element) {
+    // check validity of output pointer (may be nullptr)
+    if (!returned_element) {
+        return 0;
+    }
+    size_t start;
+    if (!this->claimRead(&start, 1)) {
+        return 0;
+    }
+    *returned_element = arr[idx::pos(start)];
+    finish(&rtail, start, 1);
+    return 1;
+}
+
+template <size_t CAPACITY>
+size_t YaRBmt<CAPACITY>::get(uint8_t *returned_elements, size_t nbr_elements) {
+    // check for nullptr
+    if (!returned_elements) {
+        return 0;
+    }
+    size_t start;
+    nbr_elements = this->claimRead(&start, nbr_elements);
+    if (nbr_elements == 0) {
+        return 0;
+    }
+    // copy out in at most two segments
+    const size_t r = idx::pos(start);
+    const size_t diff_to_end = CAPACITY - r;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        memcpy(returned_elements, arr+r, nbr_elements);
+    }
+    else {
+        memcpy(returned_elements, arr+r, diff_to_end);
+        memcpy(returned_elements+diff_to_end, arr, nbr_elements-diff_to_end);
+    }
+    finish(&rtail, start, nbr_elements);
+    return nbr_elements;
+}
+
+template <size_t CAPACITY>
+size_t YaRBmt<CAPACITY>::peek(uint8_t *peeked_element) const {
+    return this->peek(peeked_element, 0);
+}
+
+template <size_t CAPACITY>
+size_t YaRBmt<CAPACITY>::peek(uint8_t *peeked_element, size_t offset) const {
+    // check for enough elements and validity of output pointer (may be nullptr)
+    if (offset >= this->size() || !peeked_element) {
+        return 0;
+    }
+    *peeked_element = arr[idx::pos(yarb_load_relaxed(&rhead) + offset)];
+    return 1;
+}
+
+template <size_t CAPACITY>
+size_t YaRBmt<CAPACITY>::peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const {
+    // check for nullptr
+    if (!peeked_elements) {
+        return 0;
+    }
+    // only peek at most the size()-offset elements after offset
+    const size_t used = this->size();
+    if (offset >= used) {
+        return 0;
+    }
+    if (nbr_elements > used - offset) {
+        nbr_elements = used - offset;
+    }
+    // copy out in at most two segments, exactly like get(), but leave
+    // the indices unchanged
+    const size_t start = idx::pos(yarb_load_relaxed(&rhead) + offset);
+    const size_t diff_to_end = CAPACITY - start;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        memcpy(peeked_elements, arr+start, nbr_elements);
+    }
+    else {
+        memcpy(peeked_elements, arr+start, diff_to_end);
+        memcpy(peeked_elements+diff_to_end, arr, nbr_elements-diff_to_end);
+    }
+    return nbr_elements;
+}
+
+template <size_t CAPACITY>
+size_t YaRBmt<CAPACITY>::discard(size_t nbr_elements) {
+    // claim like get(), but do not copy
+    size_t start;
+    nbr_elements = this->claimRead(&start, nbr_elements);
+    if (nbr_elements == 0) {
+        return 0;
+    }
+    finish(&rtail, start, nbr_elements);
+    return nbr_elements;
+}
+
+template <size_t CAPACITY>
+size_t YaRBmt<CAPACITY>::writeReserve(uint8_t **region) {
+    // a region cannot be handed out without claiming it
+    (void)region;
+    return 0;
+}
+
+template <size_t CAPACITY>
+size_t YaRBmt<CAPACITY>::commit(size_t nbr_elements) {
+    (void)nbr_elements;
+    return 0;
+}
+
+template <size_t CAPACITY>
+size_t YaRBmt<CAPACITY>::readSpan(const uint8_t **region) const {
+    (void)region;
+    return 0;
+}
+
+template <size_t CAPACITY>
+size_t YaRBmt<CAPACITY>::consume(size_t nbr_elements) {
+    (void)nbr_elements;
+    return 0;
+}
+
+template <size_t CAPACITY>
+size_t YaRBmt<CAPACITY>::size(void) const {
+    const size_t r = yarb_load_acquire(&rhead);
+    const size_t w = yarb_load_acquire(&wtail);
+    const size_t used = w - r;
+    return (used < CAPACITY) ? used : CAPACITY;
+}
+
+template <size_t CAPACITY>
+size_t YaRBmt<CAPACITY>::free(void) const {
+    const size_t r = yarb_load_acquire(&rtail);
+    const size_t w = yarb_load_acquire(&whead);
+    const size_t used = w - r;
+    return (used < CAPACITY) ? (CAPACITY - used) : 0;
+}
+
+template <size_t CAPACITY>
+size_t YaRBmt<CAPACITY>::capacity(void) const {
+    return CAPACITY;
+}
+
+template <size_t CAPACITY>
+bool YaRBmt<CAPACITY>::isFull(void) const {
+    return this->free() == 0;
+}
+
+template <size_t CAPACITY>
+bool YaRBmt<CAPACITY>::isEmpty(void) const {
+    return this->size() == 0;
+}
+
+template <size_t CAPACITY>
+void YaRBmt<CAPACITY>::flush(void) {
+    this->discard(CAPACITY);
+}
+
+template <size_t CAPACITY>
+size_t YaRBmt<CAPACITY>::limit(void) {
+    return idx::max_capacity;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file    yarbp.h
+ * @brief   Header file for a ring buffer implementation with counters for byte classes
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarbp_h License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef yarbp_h
+#define yarbp_h
+
+#include "yarb_interface.h"
+#include "yarb_index.h"
+#include "yarb_count.h"
+
+/**
+ * @class   YaRBpt
+ * @brief   Classic ring buffer implementation using a template and two indices,
+ *          with one counter per byte class ("p" for predicate).
+ * @details This is a generalization of YaRBct: instead of a single delimiter,
+ *          NCLASSES sets of byte values (YaRBByteClass, see yarb_count.h) are
+ *          given to the constructor, and count(k) returns the number of 
+ *          stored bytes which belong to class k. All classes are counted
+ *          in one pass over the data by the bulk operations.
+ *
+ *          Class 0 ends messages: messageLength(), getMessage() and 
+ *          discardMessage() work exactly like those of YaRBct, with "a 
+ *          byte of class 0" instead of "the delimiter". The other classes
+ *          are only counted.
+ * @note    The template parameter specifies the @b effective, i.e. usable 
+ *          capacity of the ring buffer (see YaRBt).
+ * @note    NCLASSES is the number of byte classes, at most 
+ *          YaRBClassSet::max_classes.
+ * @note    MSGINDEX is the number of class-0 positions recorded for 
+ *          the message functions (see YaRBc).
+ * @note    INDEX is the type of the indices and of the recorded positions
+ *          (see YaRBt).
+ * @warning This class is @b not interrupt-safe (see YaRBct).
+ */
+template <size_t CAPACITY = 63, size_t NCLASSES = 2, size_t MSGINDEX = 8,
+          typename INDEX = typename YaRBIndexType<yarb_index_maxval(CAPACITY)>::type> 
+class YaRBpt final : public IYaRB {
+    public:
+        // sanity checking
+        static_assert(CAPACITY > 0, "not allowed to instantiate template with CAPACITY=0");
+        static_assert(NCLASSES > 0, "not allowed to instantiate template with NCLASSES=0");
+        static_assert(NCLASSES <= YaRBClassSet::max_classes, "too many byte classes");
+        static_assert(MSGINDEX > 0, "not allowed to instantiate template with MSGINDEX=0");
+        
+        // constructor, the class tables are copied into a lookup table
+        YaRBpt(const YaRBByteClass (&classes)[NCLASSES]);
+        
+        // copy constructor
+        YaRBpt(const YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX> &rb);
+        
+        // destructor
+        virtual ~YaRBpt(void) = default;
+        
+        // Do not allow assignments (see YaRBct).
+        YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>& operator= (const YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX> &rb) = delete;
+
+        // put element(s) into ring buffer
+        size_t put(uint8_t new_element) override;
+        size_t put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) override;
+
+        // get/remove element(s) from ring buffer
+        size_t get(uint8_t *returned_element) override;
+        size_t get(uint8_t *returned_elements, size_t nbr_elements) override;
+        
+        // look at element(s) in ring buffer without removing them
+        size_t peek(uint8_t *peeked_element) const override; 
+        size_t peek(uint8_t *peeked_element, size_t offset) const override;
+        size_t peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const override;
+        
+        // discard some elements from ring buffer, 
+        // return number of discarded elements
+        size_t discard(size_t nbr_elements) override;
+
+        // zero-copy access to the internal array
+        size_t writeReserve(uint8_t **region) override;
+        size_t commit(size_t nbr_elements) override;
+        size_t readSpan(const uint8_t **region) const override;
+        size_t consume(size_t nbr_elements) override;
+
+        size_t size(void) const override;     // return number of slots in use
+        size_t free(void) const override;     // return number of free slots
+        size_t capacity(void) const override; // return total number of slots
+
+        // functions *not* from interface, but special to this class
+        size_t count(size_t cls) const;       // return count of bytes in class cls
+        static size_t classes(void);          // return number of classes (NCLASSES)
+
+        // message (frame) access, a message ends with (and includes) a byte of class 0
+        size_t messageLength(void);           // return length of next complete message, 0 if none
+        size_t getMessage(uint8_t *returned_elements, size_t nbr_elements); // get exactly one message
+        size_t discardMessage(void);          // discard exactly one message, return its length
+
+        bool   isFull(void) const override;   // return true when buffer is full
+        bool   isEmpty(void) const override;  // return true when buffer is empty
+        void   flush(void) override;          // clear all elements from buffer
+        
+        // no override for static functions...
+        static size_t limit(void);   // return maximum possible number of elements on a given platform
+
+    private:
+        const YaRBClassSet set;      ///< the byte classes, prepared for counting
+
+        typedef YaRBIndex<CAPACITY, yarb_is_pow2(CAPACITY), INDEX> idx; ///< index arithmetic, selected by CAPACITY
+
+        INDEX   readindex;           ///< index for get()
+        INDEX   writeindex;          ///< index for put()
+        uint8_t arr[idx::slots];     ///< array which holds the elements
+        size_t  ct[NCLASSES];        ///< counters for the bytes of each class
+        
+        INDEX   msgarray[MSGINDEX];  ///< ring of positions of the oldest class-0 bytes
+        size_t  msgfirst;            ///< index of oldest recorded position in msgarray
+        size_t  msgct;               ///< number of recorded positions, always <= ct[0]
+
+        // helper functions for the counters
+        void   added(const uint8_t *data, size_t nbr_elements, size_t start);
+        void   removed(const size_t *nbr_bytes);
+
+        // helper functions for message access
+        void   indexAppend(size_t endpos);
+        void   indexPop(size_t nbr_ends);
+        void   indexBlock(const uint8_t *data, size_t nbr_elements, size_t start);
+        void   indexScan(void);
+};
+
+// include imlementation file for template here
+#include "yarbpt.hpp"
+
+#endif // yarbp_h
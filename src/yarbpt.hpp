@@ -0,0 +1,537 @@
+/**
+ * @file    yarbpt.hpp
+ * @brief   Implementation file for ring buffers with counters for byte classes in a template version
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarbpt_hpp License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <string.h>  // memcpy()
+
+/*
+ * Note:
+ * All index calculations are done by the helper class idx (see yarb_index.h),
+ * exactly as for YaRBct.
+ * The bulk operations count all classes with one call to set.count() per 
+ * contiguous segment (see YaRBClassSet). The positions of class-0 bytes
+ * are recorded in msgarray as the positions of the delimiters in YaRBct,
+ * with the same invariant: msgarray holds the positions of the first msgct
+ * class-0 bytes, msgct <= ct[0].
+ */
+
+/**
+ * @brief   The constructor.
+ * @param   classes
+ *          Array of NCLASSES byte classes. Bytes of class 0 end messages.
+ *          The array is merged into a table of 256 class masks and not 
+ *          referred to afterwards, so it may be a temporary.
+ */
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::YaRBpt(const YaRBByteClass (&classes)[NCLASSES]) 
+    : set{classes, NCLASSES}, readindex{0}, writeindex{0}, ct{0},
+      msgarray{0}, msgfirst{0}, msgct{0} {
+}
+
+/**
+ * @brief   The copy constructor.
+ * @param   rb
+ *          Reference to class instance to copy.
+ */
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::YaRBpt(const YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX> &rb)
+    : IYaRB(rb), set{rb.set}, readindex{rb.readindex}, writeindex{rb.writeindex},
+      msgfirst{rb.msgfirst}, msgct{rb.msgct} {
+    memcpy(arr, rb.arr, idx::slots);        
+    memcpy(ct, rb.ct, sizeof(ct));
+    memcpy(msgarray, rb.msgarray, sizeof(msgarray));
+}
+
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+size_t YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::put(uint8_t new_element) {
+    if (this->isFull()) {
+        return 0;
+    }
+    const uint8_t m = set.mask(new_element);
+    if (m) {
+        // record position if all older class-0 bytes are recorded
+        if ((m & 1) && msgct == ct[0]) indexAppend(idx::pos(writeindex));
+        for (size_t k=0; k<NCLASSES; k++) {
+            ct[k] += (m >> k) & 1;
+        }
+    }
+    arr[idx::pos(writeindex)] = new_element;
+    writeindex = idx::next(writeindex);
+    return 1;
+}
+
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+size_t YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) {
+    // check validity of input pointer (may be nullptr)
+    if (!new_elements ) {
+        return 0;
+    }
+    // only add at most free() elements to ring buffer
+    if (nbr_elements > this->free()) {
+        if (only_complete) {
+            return 0;
+        }
+        nbr_elements = this->free();
+    }
+    added(new_elements, nbr_elements, idx::pos(writeindex));
+    // copy in at most two segments: 
+    // from writeindex to end of array, then from start of array
+    const size_t w = idx::pos(writeindex);
+    const size_t diff_to_end = idx::slots - w;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        memcpy(arr+w, new_elements, nbr_elements);
+    }
+    else {
+        memcpy(arr+w, new_elements, diff_to_end);
+        memcpy(arr, new_elements+diff_to_end, nbr_elements-diff_to_end);
+    }
+    writeindex = idx::advance(writeindex, nbr_elements);
+    return nbr_elements;
+}
+
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+size_t YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::peek(uint8_t *peeked_element) const {
+    // check for emptyness and validity of output pointer (may be nullptr)
+    if (this->isEmpty() || !peeked_element) {
+        return 0;
+    }
+    else {
+        *peeked_element = arr[idx::pos(readindex)];
+        return 1;
+    }
+}
+
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+size_t YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::peek(uint8_t *peeked_element, size_t offset) const {
+    // check for enough elements and validity of output pointer (may be nullptr)
+    if (offset >= this->size() || !peeked_element) {
+        return 0;
+    }
+    else {
+        // do modulus calculation "manually" (see discard())
+        const size_t r = idx::pos(readindex);
+        const size_t diff_to_end = idx::slots - r;
+        *peeked_element = arr[(offset < diff_to_end) ? (r + offset) : (offset - diff_to_end)];
+        return 1;
+    }
+}
+
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+size_t YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const {
+    // check for nullptr
+    if (!peeked_elements) {
+        return 0;
+    }
+    // only peek at most the size()-offset elements after offset
+    const size_t used = this->size();
+    if (offset >= used) {
+        return 0;
+    }
+    if (nbr_elements > used - offset) {
+        nbr_elements = used - offset;
+    }
+    // first element to peek at, see peek(peeked_element, offset)
+    const size_t r = idx::pos(readindex);
+    const size_t diff = idx::slots - r;
+    const size_t start = (offset < diff) ? (r + offset) : (offset - diff);
+    // copy out in at most two segments, exactly like get(), but leave
+    // readindex unchanged
+    const size_t diff_to_end = idx::slots - start;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        memcpy(peeked_elements, arr+start, nbr_elements);
+    }
+    else {
+        memcpy(peeked_elements, arr+start, diff_to_end);
+        memcpy(peeked_elements+diff_to_end, arr, nbr_elements-diff_to_end);
+    }
+    return nbr_elements;
+}
+
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+size_t YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::discard(size_t nbr_elements) {
+    if (this->size() > nbr_elements) { // there will be remaining elements in buffer
+        // count removed bytes of all classes in at most two segments, 
+        // then shift readindex
+        size_t nbr_bytes[NCLASSES] = {0};
+        const size_t r = idx::pos(readindex);
+        const size_t diff_to_end = idx::slots - r;
+        if (nbr_elements <= diff_to_end) { // does not wrap
+            set.count(arr+r, nbr_elements, nbr_bytes);
+        }
+        else {
+            set.count(arr+r, diff_to_end, nbr_bytes);
+            set.count(arr, nbr_elements-diff_to_end, nbr_bytes);
+        }
+        removed(nbr_bytes);
+        readindex = idx::advance(readindex, nbr_elements);
+        return nbr_elements;
+    }
+    else { // discard *all* elements --> flush()
+        // we can only discard at many elements as are in the buffer
+        // --> return size()
+        size_t retval = this->size();
+        this->flush();
+        return retval;
+    }
+}
+
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+size_t YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::writeReserve(uint8_t **region) {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
+        return 0;
+    }
+    const size_t w = idx::pos(writeindex);
+    *region = arr+w;
+    // the free region ends at the end of the array at the latest
+    const size_t diff_to_end = idx::slots - w;
+    const size_t free_slots = this->free();
+    return (free_slots < diff_to_end) ? free_slots : diff_to_end;
+}
+
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+size_t YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::commit(size_t nbr_elements) {
+    // only commit at most the region writeReserve() reports
+    uint8_t *region;
+    const size_t reserved = this->writeReserve(&region);
+    if (nbr_elements > reserved) {
+        nbr_elements = reserved;
+    }
+    added(region, nbr_elements, idx::pos(writeindex));
+    writeindex = idx::advance(writeindex, nbr_elements);
+    return nbr_elements;
+}
+
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+size_t YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::readSpan(const uint8_t **region) const {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
+        return 0;
+    }
+    const size_t r = idx::pos(readindex);
+    *region = arr+r;
+    // the stored region ends at the end of the array at the latest
+    const size_t diff_to_end = idx::slots - r;
+    const size_t used = this->size();
+    return (used < diff_to_end) ? used : diff_to_end;
+}
+
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+size_t YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::consume(size_t nbr_elements) {
+    return this->discard(nbr_elements);
+}
+
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+size_t YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::get(uint8_t *returned_element) {
+    // check for emptyness and validity of output pointer (may  be nullptr)
+    if (this->isEmpty() || !returned_element) {
+        return 0;
+    }
+    else {
+        const uint8_t element = arr[idx::pos(readindex)];
+        const uint8_t m = set.mask(element);
+        if (m) {
+            if (m & 1) indexPop(1);
+            for (size_t k=0; k<NCLASSES; k++) {
+                ct[k] -= (m >> k) & 1;
+            }
+        }
+        *returned_element = element;
+        readindex = idx::next(readindex);
+        return 1;
+    }
+}
+
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+size_t YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::get(uint8_t *returned_elements, size_t nbr_elements) {
+    // check for nullptr
+    if (!returned_elements) {
+        return 0;
+    }
+    else {
+        // only get at most size() elements from buffer
+        if (nbr_elements > this->size()) {
+            nbr_elements = this->size();
+        }
+        // copy out in at most two segments:
+        // from readindex to end of array, then from start of array
+        const size_t r = idx::pos(readindex);
+        const size_t diff_to_end = idx::slots - r;
+        if (nbr_elements <= diff_to_end) { // does not wrap
+            memcpy(returned_elements, arr+r, nbr_elements);
+        }
+        else {
+            memcpy(returned_elements, arr+r, diff_to_end);
+            memcpy(returned_elements+diff_to_end, arr, nbr_elements-diff_to_end);
+        }
+        readindex = idx::advance(readindex, nbr_elements);
+        // count removed bytes in the (contiguous) output array
+        size_t nbr_bytes[NCLASSES] = {0};
+        set.count(returned_elements, nbr_elements, nbr_bytes);
+        removed(nbr_bytes);
+        return nbr_elements;
+    }
+}
+        
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+size_t YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::size(void) const {
+    return idx::used(readindex, writeindex);
+}
+
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+size_t YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::free(void) const {
+    return this->capacity() - this->size();
+}
+
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+size_t YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::capacity(void) const {
+    return CAPACITY;
+}
+
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+bool YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::isFull(void) const {
+    return idx::full(readindex, writeindex);
+}
+
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+bool YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::isEmpty(void) const {
+    return readindex == writeindex;
+}
+
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+void YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::flush(void) {
+    // fast-forward readindex to position of writeindex
+    readindex = writeindex;
+    for (size_t k=0; k<NCLASSES; k++) {
+        ct[k] = 0;
+    }
+    msgct = 0;
+}
+
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+size_t YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::limit(void) {
+    return idx::max_capacity;
+}
+
+/**
+ * @brief      Get the count of bytes of one class within ring buffer.
+ * @param      cls
+ *             Number of the class, i.e. its position in the array given
+ *             to the constructor.
+ * @return     Number of bytes of class cls currently stored in ring buffer.
+ *             0 if cls >= NCLASSES.
+ */
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+size_t YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::count(size_t cls) const {
+    return (cls < NCLASSES) ? ct[cls] : 0;
+}
+
+/**
+ * @brief      Get the number of byte classes.
+ * @return     NCLASSES.
+ */
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+size_t YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::classes(void) {
+    return NCLASSES;
+}
+
+/**
+ * @brief      Get the length of the next complete message in the ring buffer.
+ * @details    A message consists of all bytes up to and @b including the
+ *             next byte of class 0. Use peek(&b, length-1) to find out 
+ *             which byte ended it.
+ * @return     Number of bytes in the next message, including the last byte.
+ *             0 if there is no complete message in the ring buffer.
+ */
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+size_t YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::messageLength(void) {
+    if (ct[0] == 0) {
+        return 0;
+    }
+    if (msgct == 0) {
+        // there are class-0 bytes, but their positions are unknown
+        indexScan();
+    }
+    const size_t r = idx::pos(readindex);
+    const size_t endpos = msgarray[msgfirst];
+    if (endpos >= r) {
+        return endpos - r + 1;
+    }
+    else {
+        return idx::slots - r + endpos + 1;
+    }
+}
+
+/**
+ * @brief      Get exactly one complete message from the ring buffer, 
+ *             thereby removing it from the buffer.
+ * @details    See YaRBct::getMessage().
+ * @param[out] returned_elements
+ *             Pointer to a uint8_t. The message (including its last byte)
+ *             is stored in an array starting at this address.
+ * @param      nbr_elements
+ *             Size of the array returned_elements points to.
+ * @return     Number of bytes copied, including the last byte. 
+ *             0 if nothing was copied.
+ */
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+size_t YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::getMessage(uint8_t *returned_elements, size_t nbr_elements) {
+    // check for nullptr
+    if (!returned_elements) {
+        return 0;
+    }
+    const size_t len = this->messageLength();
+    if (len == 0 || len > nbr_elements) {
+        return 0;
+    }
+    // get() counts the bytes of the other classes in the message
+    return this->get(returned_elements, len);
+}
+
+/**
+ * @brief      Discard (i.e. remove) exactly one complete message from the
+ *             ring buffer.
+ * @return     Number of bytes removed, including the last byte. 
+ *             0 if there is no complete message in the ring buffer.
+ */
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+size_t YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::discardMessage(void) {
+    const size_t len = this->messageLength();
+    if (len == 0) {
+        return 0;
+    }
+    return this->discard(len);
+}
+
+/**
+ * @brief   Count the bytes of all classes in a contiguous block of new
+ *          elements and record the positions of class-0 bytes.
+ * @param   data
+ *          Pointer to the new elements (need not be within the ring buffer).
+ * @param   nbr_elements
+ *          Number of new elements.
+ * @param   start
+ *          Array position where data[0] is (or will be) stored.
+ */
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+void YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::added(const uint8_t *data, size_t nbr_elements, size_t start) {
+    size_t nbr_bytes[NCLASSES] = {0};
+    set.count(data, nbr_elements, nbr_bytes);
+    // record positions if all older class-0 bytes are recorded
+    if (nbr_bytes[0] && msgct == ct[0]) indexBlock(data, nbr_elements, start);
+    for (size_t k=0; k<NCLASSES; k++) {
+        ct[k] += nbr_bytes[k];
+    }
+}
+
+/**
+ * @brief   Decrease the counters for removed bytes.
+ * @param   nbr_bytes
+ *          Number of removed bytes of each class.
+ */
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+void YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::removed(const size_t *nbr_bytes) {
+    for (size_t k=0; k<NCLASSES; k++) {
+        ct[k] -= nbr_bytes[k];
+    }
+    indexPop(nbr_bytes[0]);
+}
+
+/**
+ * @brief   Record the array position of a new class-0 byte (as the newest entry).
+ * @param   endpos
+ *          Position of the new class-0 byte within the array.
+ */
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+void YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::indexAppend(size_t endpos) {
+    if (msgct < MSGINDEX) {
+        size_t slot = msgfirst + msgct;
+        if (slot >= MSGINDEX) slot -= MSGINDEX;
+        msgarray[slot] = static_cast<INDEX>(endpos);
+        msgct++;
+    }
+}
+
+/**
+ * @brief   Remove the positions of the oldest class-0 bytes, because they 
+ *          were removed from the ring buffer.
+ * @param   nbr_ends
+ *          Number of removed class-0 bytes.
+ */
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+void YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::indexPop(size_t nbr_ends) {
+    if (nbr_ends >= msgct) {
+        msgct = 0;
+        msgfirst = 0;
+    }
+    else {
+        msgct -= nbr_ends;
+        msgfirst += nbr_ends;
+        if (msgfirst >= MSGINDEX) msgfirst -= MSGINDEX;
+    }
+}
+
+/**
+ * @brief   Record the positions of class-0 bytes in a contiguous block of
+ *          new elements, until msgarray is full.
+ * @param   data
+ *          Pointer to the new elements (need not be within the ring buffer).
+ * @param   nbr_elements
+ *          Number of new elements.
+ * @param   start
+ *          Array position where data[0] is (or will be) stored.
+ */
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+void YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::indexBlock(const uint8_t *data, size_t nbr_elements, size_t start) {
+    for (size_t i=0; i<nbr_elements && msgct < MSGINDEX; i++) {
+        if (set.contains(0, data[i])) {
+            size_t endpos = start + i;
+            if (endpos >= idx::slots) endpos -= idx::slots;
+            indexAppend(endpos);
+        }
+    }
+}
+
+/**
+ * @brief   Scan the stored elements for class-0 bytes from readindex on,
+ *          when there are class-0 bytes in the ring buffer, but their
+ *          positions are not recorded.
+ */
+template <size_t CAPACITY, size_t NCLASSES, size_t MSGINDEX, typename INDEX>
+void YaRBpt<CAPACITY, NCLASSES, MSGINDEX, INDEX>::indexScan(void) {
+    // scan in at most two segments, see readSpan()
+    const uint8_t *region;
+    const size_t first = this->readSpan(&region);
+    const size_t second = this->size() - first;
+    indexBlock(region, first, idx::pos(readindex));
+    indexBlock(arr, second, 0);
+}
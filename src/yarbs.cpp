@@ -0,0 +1,246 @@
+/**
+ * @file    yarbs.cpp
+ * @brief   Implementation file for interrupt-safe single-producer/single-consumer ring buffers
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarbs_cpp License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "yarbs.h"
+
+#include <string.h>  // memcpy()
+
+/* YaRBs */
+
+/*
+ * Note:
+ * The algorithms are the same as for YaRB. The differences are:
+ * 
+ * - every method only reads its own index directly and uses 
+ *   yarb_load_acquire() for the index of the other side
+ * - indices are calculated in local variables and published exactly
+ *   once with yarb_store_release(), after the array was accessed
+ */
+
+/**
+ * @brief   The constructor.
+ * @param   capacity
+ *          The target capacity of the ring buffer. The array to hold all
+ *          elements is allocated upon construction. The size is constant
+ *          and cannot be changed afterwards.
+ * @note    capacity is the effectively usable capacity of the ring buffer.
+ *          This implementation allocates one additional byte internally.
+ */
+YaRBs::YaRBs(size_t capacity) 
+    : cap{capacity+1}, readindex{0}, writeindex{0}, arraypointer{nullptr} {
+    arraypointer = new uint8_t[cap];
+}
+
+/**
+ * @brief   The destructor.
+ */
+YaRBs::~YaRBs() {
+    delete[] arraypointer;
+}
+
+size_t YaRBs::put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) {
+    // check validity of input pointer (may be nullptr)
+    if (!new_elements ) {
+        return 0;
+    }
+    // only add at most free() elements to ring buffer
+    const size_t free_slots = this->free();
+    if (nbr_elements > free_slots) {
+        if (only_complete) return 0;
+        nbr_elements = free_slots;
+    }
+    // copy in at most two segments: 
+    // from writeindex to end of array, then from start of array
+    const size_t w = writeindex;
+    const size_t diff_to_max = cap - w;
+    if (nbr_elements < diff_to_max) { // does not wrap
+        memcpy(arraypointer+w, new_elements, nbr_elements);
+        // publish all new elements at once
+        yarb_store_release(&writeindex, w + nbr_elements);
+    }
+    else {
+        memcpy(arraypointer+w, new_elements, diff_to_max);
+        memcpy(arraypointer, new_elements+diff_to_max, nbr_elements-diff_to_max);
+        // publish all new elements at once
+        yarb_store_release(&writeindex, nbr_elements - diff_to_max);
+    }
+    return nbr_elements;
+}
+
+size_t YaRBs::peek(uint8_t *peeked_element, size_t offset) const {
+    // check for enough elements and validity of output pointer (may be nullptr)
+    if (offset >= this->size() || !peeked_element) {
+        return 0;
+    }
+    else {
+        // do modulus calculation "manually" (see discard())
+        const size_t r = readindex;
+        const size_t diff_to_end = cap - r;
+        *peeked_element = arraypointer[(offset < diff_to_end) ? (r + offset) : (offset - diff_to_end)];
+        return 1;
+    }
+}
+
+size_t YaRBs::peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const {
+    // check for nullptr
+    if (!peeked_elements) {
+        return 0;
+    }
+    // only peek at most the size()-offset elements after offset
+    const size_t used = this->size();
+    if (offset >= used) {
+        return 0;
+    }
+    if (nbr_elements > used - offset) {
+        nbr_elements = used - offset;
+    }
+    // first element to peek at, see peek(peeked_element, offset)
+    const size_t r = readindex;
+    const size_t diff = cap - r;
+    const size_t start = (offset < diff) ? (r + offset) : (offset - diff);
+    // copy out in at most two segments, exactly like get(), but leave
+    // readindex unchanged
+    const size_t diff_to_end = cap - start;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        memcpy(peeked_elements, arraypointer+start, nbr_elements);
+    }
+    else {
+        memcpy(peeked_elements, arraypointer+start, diff_to_end);
+        memcpy(peeked_elements+diff_to_end, arraypointer, nbr_elements-diff_to_end);
+    }
+    return nbr_elements;
+}
+
+size_t YaRBs::discard(size_t nbr_elements) {
+    const size_t r = readindex;
+    const size_t w = yarb_load_acquire(&writeindex);
+    const size_t used = (w >= r) ? (w - r) : (cap - (r - w));
+    if (used > nbr_elements) { // there will be remaining elements in buffer
+        // do modulus calculation "manually" to avoid overflow (see YaRB)
+        const size_t diff_to_max = cap - r;
+        if (nbr_elements >= diff_to_max) {
+            yarb_store_release(&readindex, nbr_elements - diff_to_max);
+        }
+        else { // adding nbr_elements to readindex does not wrap
+            yarb_store_release(&readindex, r + nbr_elements);
+        }
+        return nbr_elements;
+    }
+    else { // discard *all* elements --> same as flush(), but with the
+           // writeindex we already know
+        yarb_store_release(&readindex, w);
+        return used;
+    }
+}
+
+size_t YaRBs::writeReserve(uint8_t **region) {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
+        return 0;
+    }
+    const size_t w = writeindex;
+    *region = arraypointer+w;
+    // the free region ends at the end of the array at the latest
+    const size_t diff_to_end = cap - w;
+    const size_t free_slots = this->free();
+    return (free_slots < diff_to_end) ? free_slots : diff_to_end;
+}
+
+size_t YaRBs::commit(size_t nbr_elements) {
+    // only commit at most the region writeReserve() reports
+    uint8_t *region;
+    const size_t reserved = this->writeReserve(&region);
+    if (nbr_elements > reserved) {
+        nbr_elements = reserved;
+    }
+    // publish the new elements
+    // the region never wraps, but it may end exactly at the end of the array
+    const size_t w = writeindex + nbr_elements;
+    yarb_store_release(&writeindex, (w == cap) ? 0 : w);
+    return nbr_elements;
+}
+
+size_t YaRBs::readSpan(const uint8_t **region) const {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
+        return 0;
+    }
+    const size_t r = readindex;
+    *region = arraypointer+r;
+    // the stored region ends at the end of the array at the latest
+    const size_t diff_to_end = cap - r;
+    const size_t used = this->size();
+    return (used < diff_to_end) ? used : diff_to_end;
+}
+
+size_t YaRBs::consume(size_t nbr_elements) {
+    return this->discard(nbr_elements);
+}
+
+size_t YaRBs::get(uint8_t *returned_elements, size_t nbr_elements) {
+    // check for nullptr
+    if (!returned_elements) {
+        return 0;
+    }
+    else {
+        // only get at most size() elements from buffer
+        const size_t used = this->size();
+        if (nbr_elements > used) {
+            nbr_elements = used;
+        }
+        // copy out in at most two segments:
+        // from readindex to end of array, then from start of array
+        const size_t r = readindex;
+        const size_t diff_to_max = cap - r;
+        if (nbr_elements < diff_to_max) { // does not wrap
+            memcpy(returned_elements, arraypointer+r, nbr_elements);
+            // release all slots at once
+            yarb_store_release(&readindex, r + nbr_elements);
+        }
+        else {
+            memcpy(returned_elements, arraypointer+r, diff_to_max);
+            memcpy(returned_elements+diff_to_max, arraypointer, nbr_elements-diff_to_max);
+            // release all slots at once
+            yarb_store_release(&readindex, nbr_elements - diff_to_max);
+        }
+        return nbr_elements;
+    }
+}
+        
+void YaRBs::flush(void) {
+    // fast-forward readindex to position of writeindex
+    yarb_store_release(&readindex, yarb_load_acquire(&writeindex));
+}
+
+size_t YaRBs::limit(void) {
+    return SIZE_MAX - 1;
+}
@@ -0,0 +1,265 @@
+/**
+ * @file    yarbs.h
+ * @brief   Header file for interrupt-safe single-producer/single-consumer ring buffers
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarbs_h License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef yarbs_h
+#define yarbs_h
+
+#include "yarb_interface.h"
+#include "yarb_atomic.h"
+#include "yarb_index.h"
+
+/**
+ * @class   YaRBs
+ * @brief   Classic ring buffer implementation using dynamic allocated array and
+ *          two indices, safe for one producer and one consumer running in
+ *          different contexts (ISR and loop(), or two threads).
+ * @details readindex is only ever written by the consumer side, writeindex 
+ *          only by the producer side. Each side reads the index of the 
+ *          other side with acquire semantics and publishes its own index
+ *          with release semantics after the array was accessed. No critical
+ *          sections are needed (see yarb_atomic.h for the AVR special case).
+ *
+ *          Producer side: put(), writeReserve(), commit(), free(), isFull()
+ *
+ *          Consumer side: get(), peek(), discard(), readSpan(), consume(),
+ *          flush(), size(), isEmpty()
+ *
+ *          capacity() and limit() can be called from anywhere. Calling 
+ *          size(), free(), isFull() or isEmpty() from the "wrong" side is
+ *          allowed, but the result is only a snapshot.
+ * @note    Only a single producer and a single consumer are allowed. 
+ *          Calling put() from two different contexts (e.g. from two ISRs
+ *          with different priorities) is @b not safe.
+ */
+class YaRBs final : public IYaRB {
+    public:
+        // constructor
+        YaRBs(size_t capacity=63);
+        
+        // do not allow copies or assignments:
+        // the indices might be changed concurrently while copying
+        YaRBs(const YaRBs &rb) = delete;
+        YaRBs& operator= (const YaRBs &rb) = delete;
+        
+        // destructor
+        virtual ~YaRBs(void);
+        
+        // put element(s) into ring buffer (producer side)
+        size_t put(uint8_t new_element) override;
+        size_t put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) override;
+
+        // get/remove element(s) from ring buffer (consumer side)
+        size_t get(uint8_t *returned_element) override;
+        size_t get(uint8_t *returned_elements, size_t nbr_elements) override;
+        
+        // look at element(s) in ring buffer without removing them (consumer side)
+        size_t peek(uint8_t *peeked_element) const override; 
+        size_t peek(uint8_t *peeked_element, size_t offset) const override;
+        size_t peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const override;
+        
+        // discard some elements from ring buffer (consumer side), 
+        // return number of discarded elements
+        size_t discard(size_t nbr_elements) override;
+
+        // zero-copy access to the internal array
+        // (writeReserve()/commit(): producer side, readSpan()/consume(): consumer side)
+        size_t writeReserve(uint8_t **region) override;
+        size_t commit(size_t nbr_elements) override;
+        size_t readSpan(const uint8_t **region) const override;
+        size_t consume(size_t nbr_elements) override;
+
+        size_t size(void) const override;     // return number of slots in use
+        size_t free(void) const override;     // return number of free slots
+        size_t capacity(void) const override; // return total number of slots
+
+        bool   isFull(void) const override;   // return true when buffer is full
+        bool   isEmpty(void) const override;  // return true when buffer is empty
+        void   flush(void) override;          // clear all elements from buffer (consumer side)
+        
+        // no override for static functions...
+        static size_t limit(void);   // return maximum possible number of elements on a given platform
+
+    private:
+        const size_t  cap;     ///< store size of internaly array
+        size_t  readindex;     ///< index for get(), only written by consumer
+        size_t  writeindex;    ///< index for put(), only written by producer
+        uint8_t *arraypointer; ///< pointer to array which holds the elements
+};
+
+// inline definitions of the functions on the hot path
+
+inline size_t YaRBs::put(uint8_t new_element) {
+    const size_t w = writeindex;
+    // no division, even on CPUs without hardware divider
+    const size_t next = (w + 1 == cap) ? 0 : (w + 1);
+    if (next == yarb_load_acquire(&readindex)) { // full
+        return 0;
+    }
+    else {
+        arraypointer[w] = new_element;
+        yarb_store_release(&writeindex, next);
+        return 1;
+    }
+}
+
+inline size_t YaRBs::peek(uint8_t *peeked_element) const {
+    const size_t r = readindex;
+    // check for emptyness and validity of output pointer (may be nullptr)
+    if (r == yarb_load_acquire(&writeindex) || !peeked_element) {
+        return 0;
+    }
+    else {
+        *peeked_element = arraypointer[r];
+        return 1;
+    }
+}
+
+inline size_t YaRBs::get(uint8_t *returned_element) {
+    const size_t r = readindex;
+    // check for emptyness and validity of output pointer (may  be nullptr)
+    if (r == yarb_load_acquire(&writeindex) || !returned_element) {
+        return 0;
+    }
+    else {
+        *returned_element = arraypointer[r];
+        yarb_store_release(&readindex, (r + 1 == cap) ? 0 : (r + 1));
+        return 1;
+    }
+}
+
+inline size_t YaRBs::size(void) const {
+    const size_t r = yarb_load_acquire(&readindex);
+    const size_t w = yarb_load_acquire(&writeindex);
+    if (w >= r) {
+        return w - r;
+    }
+    else {
+        return cap - (r - w);
+    }
+}
+
+inline size_t YaRBs::free(void) const {
+    return this->capacity() - this->size();
+}
+
+inline size_t YaRBs::capacity(void) const {
+    return cap-1;
+}
+
+inline bool YaRBs::isFull(void) const {
+    const size_t w = yarb_load_acquire(&writeindex);
+    return yarb_load_acquire(&readindex) == ((w + 1 == cap) ? 0 : (w + 1));
+}
+
+inline bool YaRBs::isEmpty(void) const {
+    return yarb_load_acquire(&readindex) == yarb_load_acquire(&writeindex);
+}
+
+
+/**
+ * @class   YaRBst
+ * @brief   Classic ring buffer implementation using a template and two indices,
+ *          safe for one producer and one consumer running in different
+ *          contexts (ISR and loop(), or two threads).
+ * @details This is the templated version of YaRBs. The same rules regarding
+ *          producer and consumer side apply.
+ * @note    The template parameter specifies the @b effective, i.e. usable 
+ *          capacity of the ring buffer. Internally, one additional byte is
+ *          allocated, unless CAPACITY is a power of two (see YaRBt).
+ * @note    Only a single producer and a single consumer are allowed. 
+ *          Calling put() from two different contexts (e.g. from two ISRs
+ *          with different priorities) is @b not safe.
+ */
+template <size_t CAPACITY = 63> 
+class YaRBst final : public IYaRB {
+    public:
+        // sanity checking
+        static_assert(CAPACITY > 0, "not allowed to instantiate template with CAPACITY=0");
+        
+        // constructor
+        YaRBst(void);
+        
+        // do not allow copies or assignments:
+        // the indices might be changed concurrently while copying
+        YaRBst(const YaRBst &rb) = delete;
+        YaRBst<CAPACITY>& operator= (const YaRBst<CAPACITY> &rb) = delete;
+        
+        // destructor
+        virtual ~YaRBst(void) = default;
+
+        // put element(s) into ring buffer (producer side)
+        size_t put(uint8_t new_element) override;
+        size_t put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) override;
+
+        // get/remove element(s) from ring buffer (consumer side)
+        size_t get(uint8_t *returned_element) override;
+        size_t get(uint8_t *returned_elements, size_t nbr_elements) override;
+        
+        // look at element(s) in ring buffer without removing them (consumer side)
+        size_t peek(uint8_t *peeked_element) const override; 
+        size_t peek(uint8_t *peeked_element, size_t offset) const override;
+        size_t peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const override;
+        
+        // discard some elements from ring buffer (consumer side), 
+        // return number of discarded elements
+        size_t discard(size_t nbr_elements) override;
+
+        // zero-copy access to the internal array
+        // (writeReserve()/commit(): producer side, readSpan()/consume(): consumer side)
+        size_t writeReserve(uint8_t **region) override;
+        size_t commit(size_t nbr_elements) override;
+        size_t readSpan(const uint8_t **region) const override;
+        size_t consume(size_t nbr_elements) override;
+
+        size_t size(void) const override;     // return number of slots in use
+        size_t free(void) const override;     // return number of free slots
+        size_t capacity(void) const override; // return total number of slots
+
+        bool   isFull(void) const override;   // return true when buffer is full
+        bool   isEmpty(void) const override;  // return true when buffer is empty
+        void   flush(void) override;          // clear all elements from buffer (consumer side)
+        
+        // no override for static functions...
+        static size_t limit(void);   // return maximum possible number of elements on a given platform
+
+    private:
+        typedef YaRBIndex<CAPACITY> idx; ///< index arithmetic, selected by CAPACITY
+        
+        size_t  readindex;           ///< index for get(), only written by consumer
+        size_t  writeindex;          ///< index for put(), only written by producer
+        uint8_t arr[idx::slots];     ///< array which holds the elements
+};
+
+// include imlementation file for template here
+#include "yarbst.hpp"
+
+#endif // yarbs_h
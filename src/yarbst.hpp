@@ -0,0 +1,293 @@
+/**
+ * @file    yarbst.hpp
+ * @brief   Implementation file for interrupt-safe single-producer/single-consumer ring buffers in a template version
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarbst_hpp License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>  // memcpy()
+
+/*
+ * Note:
+ * The algorithms are the same as for YaRBs. All index calculations are
+ * done by the helper class idx (see yarb_index.h), exactly as for YaRBt.
+ */
+
+/**
+ * @brief   The constructor.
+ * @details This is the default constructor with no arguments. Capacity 
+ *          is not given as a parameter to the constructor, but as a
+ *          template parameter
+ */
+template <size_t CAPACITY>
+YaRBst<CAPACITY>::YaRBst(void) 
+    : readindex{0}, writeindex{0} {
+}
+
+template <size_t CAPACITY>
+size_t YaRBst<CAPACITY>::put(uint8_t new_element) {
+    const size_t w = writeindex;
+    if (idx::full(yarb_load_acquire(&readindex), w)) {
+        return 0;
+    }
+    else {
+        arr[idx::pos(w)] = new_element;
+        yarb_store_release(&writeindex, idx::next(w));
+        return 1;
+    }
+}
+        
+template <size_t CAPACITY>
+size_t YaRBst<CAPACITY>::put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) {
+    // check validity of input pointer (may be nullptr)
+    if (!new_elements ) {
+        return 0;
+    }
+    // only add at most free() elements to ring buffer
+    const size_t free_slots = this->free();
+    if (nbr_elements > free_slots) {
+        if (only_complete) return 0;
+        nbr_elements = free_slots;
+    }
+    // copy in at most two segments: 
+    // from writeindex to end of array, then from start of array
+    const size_t w = idx::pos(writeindex);
+    const size_t diff_to_end = idx::slots - w;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        memcpy(arr+w, new_elements, nbr_elements);
+    }
+    else {
+        memcpy(arr+w, new_elements, diff_to_end);
+        memcpy(arr, new_elements+diff_to_end, nbr_elements-diff_to_end);
+    }
+    // publish all new elements at once
+    yarb_store_release(&writeindex, idx::advance(writeindex, nbr_elements));
+    return nbr_elements;
+}
+
+template <size_t CAPACITY>
+size_t YaRBst<CAPACITY>::peek(uint8_t *peeked_element) const {
+    const size_t r = readindex;
+    // check for emptyness and validity of output pointer (may be nullptr)
+    if (r == yarb_load_acquire(&writeindex) || !peeked_element) {
+        return 0;
+    }
+    else {
+        *peeked_element = arr[idx::pos(r)];
+        return 1;
+    }
+}
+
+template <size_t CAPACITY>
+size_t YaRBst<CAPACITY>::peek(uint8_t *peeked_element, size_t offset) const {
+    // check for enough elements and validity of output pointer (may be nullptr)
+    if (offset >= this->size() || !peeked_element) {
+        return 0;
+    }
+    else {
+        // do modulus calculation "manually" (see discard())
+        const size_t r = idx::pos(readindex);
+        const size_t diff_to_end = idx::slots - r;
+        *peeked_element = arr[(offset < diff_to_end) ? (r + offset) : (offset - diff_to_end)];
+        return 1;
+    }
+}
+
+template <size_t CAPACITY>
+size_t YaRBst<CAPACITY>::peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const {
+    // check for nullptr
+    if (!peeked_elements) {
+        return 0;
+    }
+    // only peek at most the size()-offset elements after offset
+    const size_t used = this->size();
+    if (offset >= used) {
+        return 0;
+    }
+    if (nbr_elements > used - offset) {
+        nbr_elements = used - offset;
+    }
+    // first element to peek at, see peek(peeked_element, offset)
+    const size_t r = idx::pos(readindex);
+    const size_t diff = idx::slots - r;
+    const size_t start = (offset < diff) ? (r + offset) : (offset - diff);
+    // copy out in at most two segments, exactly like get(), but leave
+    // readindex unchanged
+    const size_t diff_to_end = idx::slots - start;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        memcpy(peeked_elements, arr+start, nbr_elements);
+    }
+    else {
+        memcpy(peeked_elements, arr+start, diff_to_end);
+        memcpy(peeked_elements+diff_to_end, arr, nbr_elements-diff_to_end);
+    }
+    return nbr_elements;
+}
+
+template <size_t CAPACITY>
+size_t YaRBst<CAPACITY>::discard(size_t nbr_elements) {
+    const size_t r = readindex;
+    const size_t w = yarb_load_acquire(&writeindex);
+    const size_t used = idx::used(r, w);
+    if (used > nbr_elements) { // there will be remaining elements in buffer
+        yarb_store_release(&readindex, idx::advance(r, nbr_elements));
+        return nbr_elements;
+    }
+    else { // discard *all* elements --> same as flush(), but with the
+           // writeindex we already know
+        yarb_store_release(&readindex, w);
+        return used;
+    }
+}
+
+template <size_t CAPACITY>
+size_t YaRBst<CAPACITY>::writeReserve(uint8_t **region) {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
+        return 0;
+    }
+    const size_t w = idx::pos(writeindex);
+    *region = arr+w;
+    // the free region ends at the end of the array at the latest
+    const size_t diff_to_end = idx::slots - w;
+    const size_t free_slots = this->free();
+    return (free_slots < diff_to_end) ? free_slots : diff_to_end;
+}
+
+template <size_t CAPACITY>
+size_t YaRBst<CAPACITY>::commit(size_t nbr_elements) {
+    // only commit at most the region writeReserve() reports
+    uint8_t *region;
+    const size_t reserved = this->writeReserve(&region);
+    if (nbr_elements > reserved) {
+        nbr_elements = reserved;
+    }
+    // publish the new elements
+    yarb_store_release(&writeindex, idx::advance(writeindex, nbr_elements));
+    return nbr_elements;
+}
+
+template <size_t CAPACITY>
+size_t YaRBst<CAPACITY>::readSpan(const uint8_t **region) const {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
+        return 0;
+    }
+    const size_t r = idx::pos(readindex);
+    *region = arr+r;
+    // the stored region ends at the end of the array at the latest
+    const size_t diff_to_end = idx::slots - r;
+    const size_t used = this->size();
+    return (used < diff_to_end) ? used : diff_to_end;
+}
+
+template <size_t CAPACITY>
+size_t YaRBst<CAPACITY>::consume(size_t nbr_elements) {
+    return this->discard(nbr_elements);
+}
+
+template <size_t CAPACITY>
+size_t YaRBst<CAPACITY>::get(uint8_t *returned_element) {
+    const size_t r = readindex;
+    // check for emptyness and validity of output pointer (may  be nullptr)
+    if (r == yarb_load_acquire(&writeindex) || !returned_element) {
+        return 0;
+    }
+    else {
+        *returned_element = arr[idx::pos(r)];
+        yarb_store_release(&readindex, idx::next(r));
+        return 1;
+    }
+}
+
+template <size_t CAPACITY>
+size_t YaRBst<CAPACITY>::get(uint8_t *returned_elements, size_t nbr_elements) {
+    // check for nullptr
+    if (!returned_elements) {
+        return 0;
+    }
+    else {
+        // only get at most size() elements from buffer
+        const size_t used = this->size();
+        if (nbr_elements > used) {
+            nbr_elements = used;
+        }
+        // copy out in at most two segments:
+        // from readindex to end of array, then from start of array
+        const size_t r = idx::pos(readindex);
+        const size_t diff_to_end = idx::slots - r;
+        if (nbr_elements <= diff_to_end) { // does not wrap
+            memcpy(returned_elements, arr+r, nbr_elements);
+        }
+        else {
+            memcpy(returned_elements, arr+r, diff_to_end);
+            memcpy(returned_elements+diff_to_end, arr, nbr_elements-diff_to_end);
+        }
+        // release all slots at once
+        yarb_store_release(&readindex, idx::advance(readindex, nbr_elements));
+        return nbr_elements;
+    }
+}
+        
+template <size_t CAPACITY>
+size_t YaRBst<CAPACITY>::size(void) const {
+    const size_t r = yarb_load_acquire(&readindex);
+    const size_t w = yarb_load_acquire(&writeindex);
+    return idx::used(r, w);
+}
+
+template <size_t CAPACITY>
+size_t YaRBst<CAPACITY>::free(void) const {
+    return this->capacity() - this->size();
+}
+
+template <size_t CAPACITY>
+size_t YaRBst<CAPACITY>::capacity(void) const {
+    return CAPACITY;
+}
+
+template <size_t CAPACITY>
+bool YaRBst<CAPACITY>::isFull(void) const {
+    return idx::full(yarb_load_acquire(&readindex), yarb_load_acquire(&writeindex));
+}
+
+template <size_t CAPACITY>
+bool YaRBst<CAPACITY>::isEmpty(void) const {
+    return yarb_load_acquire(&readindex) == yarb_load_acquire(&writeindex);
+}
+
+template <size_t CAPACITY>
+void YaRBst<CAPACITY>::flush(void) {
+    // fast-forward readindex to position of writeindex
+    yarb_store_release(&readindex, yarb_load_acquire(&writeindex));
+}
+
+template <size_t CAPACITY>
+size_t YaRBst<CAPACITY>::limit(void) {
+    return idx::max_capacity;
+}
@@ -30,17 +30,27 @@
  * SOFTWARE.
  */
 
-#include <string.h>  // memcpy(), for copy constructor
+
+/*
+ * Note:
+ * All index calculations are done by the helper class idx (see yarb_index.h).
+ * For power-of-two capacities, the indices are free-running, the array
+ * position is calculated with a bit mask and no slot is wasted. Otherwise,
+ * the classic algorithm with one unused slot is used.
+ */
 
 /**
  * @brief   The constructor.
  * @details This is the default constructor with no arguments. Capacity 
  *          is not given as a parameter to the constructor, but as a
  *          template parameter
+ * @note    The array is not initialized, only the indices are. No slot is
+ *          ever read before it was written. Static instances stay in .bss
+ *          and cost no more than a few stores at startup.
  */
-template <size_t CAPACITY>
-YaRBt<CAPACITY>::YaRBt(void) 
-    : readindex{0}, writeindex{0}, arr{0} {
+template <size_t CAPACITY, typename T, bool OVERWRITE, typename INDEX>
+YaRBt<CAPACITY, T, OVERWRITE, INDEX>::YaRBt(void) 
+    : readindex{0}, writeindex{0} {
 }
 
 /**
@@ -48,10 +58,10 @@ YaRBt<CAPACITY>::YaRBt(void)
  * @param   rb
  *          Reference to class instance to copy.
  */
-template <size_t CAPACITY>
-YaRBt<CAPACITY>::YaRBt(const YaRBt<CAPACITY> &rb)
-    : readindex{rb.readindex}, writeindex{rb.writeindex}, arr{nullptr} {
-    memcpy(arr, &(rb.arr), CAPACITY+1);        
+template <size_t CAPACITY, typename T, bool OVERWRITE, typename INDEX>
+YaRBt<CAPACITY, T, OVERWRITE, INDEX>::YaRBt(const YaRBt<CAPACITY, T, OVERWRITE, INDEX> &rb)
+    : readindex{rb.readindex}, writeindex{rb.writeindex} {
+    YaRBCopy<T>::copy(arr, rb.arr, idx::slots);        
 }
 
 /**
@@ -61,91 +71,147 @@ YaRBt<CAPACITY>::YaRBt(const YaRBt<CAPACITY> &rb)
  * @note    This works because both operands are guaranteed to be of 
  *          same capacity when using a template.
  */
-template <size_t CAPACITY>
-YaRBt<CAPACITY>& YaRBt<CAPACITY>::operator=(const YaRBt<CAPACITY> &rb) {
+template <size_t CAPACITY, typename T, bool OVERWRITE, typename INDEX>
+YaRBt<CAPACITY, T, OVERWRITE, INDEX>& YaRBt<CAPACITY, T, OVERWRITE, INDEX>::operator=(const YaRBt<CAPACITY, T, OVERWRITE, INDEX> &rb) {
     // protect against self-assignment
     if (this == &rb) return *this;
     // copy indices verbatim
     readindex = rb.readindex;
     writeindex = rb.writeindex;
-    // Copy content depending of relative position of indices.
-    // case 1: writeindex has not yet wrapped
-    // --> copy size() bytes of data, starting from readindex
-    if (readindex <= writeindex) { 
-        memcpy(arr+readindex, rb.arr+readindex, rb.size());
-    }
+    // Copy size() bytes of content, starting from readindex.
+    // case 1: data does not wrap around
+    // --> copy in one go
     // case 2: writeindex has already wrapped around, readindex not yet
     // --> copy from readindex to end of array
     // --> copy from start of array to writeindex-1
+    const size_t r = idx::pos(readindex);
+    const size_t n = rb.size();
+    const size_t diff_to_end = idx::slots - r;
+    if (n <= diff_to_end) { 
+        YaRBCopy<T>::copy(arr+r, rb.arr+r, n);
+    }
     else {
-        memcpy(arr+readindex, rb.arr+readindex, (CAPACITY+1)-readindex);
-        memcpy(arr, rb.arr, writeindex);
+        YaRBCopy<T>::copy(arr+r, rb.arr+r, diff_to_end);
+        YaRBCopy<T>::copy(arr, rb.arr, n-diff_to_end);
     }
     return *this;        
 }
 
-template <size_t CAPACITY>
-size_t YaRBt<CAPACITY>::put(uint8_t new_element) {
+template <size_t CAPACITY, typename T, bool OVERWRITE, typename INDEX>
+size_t YaRBt<CAPACITY, T, OVERWRITE, INDEX>::put(T new_element) {
     if (this->isFull()) {
-        return 0;
-    }
-    else {
-        arr[writeindex] = new_element;
-        writeindex = (writeindex + 1) % (CAPACITY+1);
-        return 1;
+        if (!OVERWRITE) return 0;
+        // overwrite mode: drop oldest element
+        readindex = idx::next(readindex);
     }
+    arr[idx::pos(writeindex)] = static_cast<T&&>(new_element);
+    writeindex = idx::next(writeindex);
+    return 1;
 }
 
-template <size_t CAPACITY>
-size_t YaRBt<CAPACITY>::put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) {
+template <size_t CAPACITY, typename T, bool OVERWRITE, typename INDEX>
+size_t YaRBt<CAPACITY, T, OVERWRITE, INDEX>::put(const T *new_elements, size_t nbr_elements, bool only_complete) {
     // check validity of input pointer (may be nullptr)
     if (!new_elements ) {
         return 0;
     }
+    const size_t requested = nbr_elements;
+    if (OVERWRITE) {
+        // overwrite mode: all elements are accepted
+        if (nbr_elements >= CAPACITY) {
+            // only the newest CAPACITY elements survive
+            new_elements += nbr_elements - CAPACITY;
+            nbr_elements = CAPACITY;
+            this->flush();
+        }
+        else if (nbr_elements > this->free()) {
+            // drop oldest elements in one go
+            readindex = idx::advance(readindex, nbr_elements - this->free());
+        }
+    }
     // only add at most free() elements to ring buffer
-    if (nbr_elements > this->free()) {
+    else if (nbr_elements > this->free()) {
         if (only_complete) return 0;
         nbr_elements = this->free();
     }
-    for (size_t i=0; i<nbr_elements; i++) {
-          // re-implementation is about 3-4 times faster than calling
-          // single-element put()
-          arr[writeindex] = *new_elements;
-          writeindex = (writeindex + 1) % (CAPACITY+1);
-          new_elements++;
+    // copy in at most two segments: 
+    // from writeindex to end of array, then from start of array
+    const size_t w = idx::pos(writeindex);
+    const size_t diff_to_end = idx::slots - w;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        YaRBCopy<T>::copy(arr+w, new_elements, nbr_elements);
     }
-    return nbr_elements;
+    else {
+        YaRBCopy<T>::copy(arr+w, new_elements, diff_to_end);
+        YaRBCopy<T>::copy(arr, new_elements+diff_to_end, nbr_elements-diff_to_end);
+    }
+    writeindex = idx::advance(writeindex, nbr_elements);
+    return OVERWRITE ? requested : nbr_elements;
 }
 
-template <size_t CAPACITY>
-size_t YaRBt<CAPACITY>::peek(uint8_t *peeked_element) const {
+template <size_t CAPACITY, typename T, bool OVERWRITE, typename INDEX>
+size_t YaRBt<CAPACITY, T, OVERWRITE, INDEX>::peek(T *peeked_element) const {
     // check for emptyness and validity of output pointer (may be nullptr)
     if (this->isEmpty() || !peeked_element) {
         return 0;
     }
     else {
-        *peeked_element = arr[readindex];
+        *peeked_element = arr[idx::pos(readindex)];
         return 1;
     }
 }
 
-template <size_t CAPACITY>
-size_t YaRBt<CAPACITY>::discard(size_t nbr_elements) {
+template <size_t CAPACITY, typename T, bool OVERWRITE, typename INDEX>
+size_t YaRBt<CAPACITY, T, OVERWRITE, INDEX>::peek(T *peeked_element, size_t offset) const {
+    // check for enough elements and validity of output pointer (may be nullptr)
+    if (offset >= this->size() || !peeked_element) {
+        return 0;
+    }
+    else {
+        // do modulus calculation "manually" (see discard())
+        const size_t r = idx::pos(readindex);
+        const size_t diff_to_end = idx::slots - r;
+        *peeked_element = arr[(offset < diff_to_end) ? (r + offset) : (offset - diff_to_end)];
+        return 1;
+    }
+}
+
+template <size_t CAPACITY, typename T, bool OVERWRITE, typename INDEX>
+size_t YaRBt<CAPACITY, T, OVERWRITE, INDEX>::peek(T *peeked_elements, size_t nbr_elements, size_t offset) const {
+    // check for nullptr
+    if (!peeked_elements) {
+        return 0;
+    }
+    // only peek at most the size()-offset elements after offset
+    const size_t used = this->size();
+    if (offset >= used) {
+        return 0;
+    }
+    if (nbr_elements > used - offset) {
+        nbr_elements = used - offset;
+    }
+    // first element to peek at, see peek(peeked_element, offset)
+    const size_t r = idx::pos(readindex);
+    const size_t diff = idx::slots - r;
+    const size_t start = (offset < diff) ? (r + offset) : (offset - diff);
+    // copy out in at most two segments, exactly like get(), but leave
+    // readindex unchanged
+    const size_t diff_to_end = idx::slots - start;
+    if (nbr_elements <= diff_to_end) { // does not wrap
+        YaRBCopy<T>::copy(peeked_elements, arr+start, nbr_elements);
+    }
+    else {
+        YaRBCopy<T>::copy(peeked_elements, arr+start, diff_to_end);
+        YaRBCopy<T>::copy(peeked_elements+diff_to_end, arr, nbr_elements-diff_to_end);
+    }
+    return nbr_elements;
+}
+
+template <size_t CAPACITY, typename T, bool OVERWRITE, typename INDEX>
+size_t YaRBt<CAPACITY, T, OVERWRITE, INDEX>::discard(size_t nbr_elements) {
     if (this->size() > nbr_elements) { // there will be remaining elements in buffer
-        // Due to danger of integer overflow, we cannot just do
-        // readindex = (readindex + nbr_elements) % (CAPACITY+1):
-        // readindex + nbr_elements *might* be larger than SIZE_MAX, which
-        // would then overflow, giving wrong results after modulus.
-        // --> Do modulus calculation "manually".
-        //
-        // The difference between current readindex and (CAPACITY+1) is always >= 0 (i.e. at least 1)
-        size_t diff_to_max = (CAPACITY+1) - readindex;
-        if (nbr_elements > diff_to_max) {
-            readindex = nbr_elements - diff_to_max;
-        }
-        else { // adding nbr_elements to readindex does not wrap
-            readindex += nbr_elements;
-        }
+        // idx::advance() takes care of integer overflow
+        readindex = idx::advance(readindex, nbr_elements);
         // return nbr_elements, no matter if we had to wrap around or not
         return nbr_elements;
     }
@@ -158,21 +224,66 @@ size_t YaRBt<CAPACITY>::discard(size_t nbr_elements) {
     }
 }
 
-template <size_t CAPACITY>
-size_t YaRBt<CAPACITY>::get(uint8_t *returned_element) {
+template <size_t CAPACITY, typename T, bool OVERWRITE, typename INDEX>
+size_t YaRBt<CAPACITY, T, OVERWRITE, INDEX>::writeReserve(T **region) {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
+        return 0;
+    }
+    const size_t w = idx::pos(writeindex);
+    *region = arr+w;
+    // the free region ends at the end of the array at the latest
+    const size_t diff_to_end = idx::slots - w;
+    const size_t free_slots = this->free();
+    return (free_slots < diff_to_end) ? free_slots : diff_to_end;
+}
+
+template <size_t CAPACITY, typename T, bool OVERWRITE, typename INDEX>
+size_t YaRBt<CAPACITY, T, OVERWRITE, INDEX>::commit(size_t nbr_elements) {
+    // only commit at most the region writeReserve() reports
+    T *region;
+    const size_t reserved = this->writeReserve(&region);
+    if (nbr_elements > reserved) {
+        nbr_elements = reserved;
+    }
+    writeindex = idx::advance(writeindex, nbr_elements);
+    return nbr_elements;
+}
+
+template <size_t CAPACITY, typename T, bool OVERWRITE, typename INDEX>
+size_t YaRBt<CAPACITY, T, OVERWRITE, INDEX>::readSpan(const T **region) const {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
+        return 0;
+    }
+    const size_t r = idx::pos(readindex);
+    *region = arr+r;
+    // the stored region ends at the end of the array at the latest
+    const size_t diff_to_end = idx::slots - r;
+    const size_t used = this->size();
+    return (used < diff_to_end) ? used : diff_to_end;
+}
+
+template <size_t CAPACITY, typename T, bool OVERWRITE, typename INDEX>
+size_t YaRBt<CAPACITY, T, OVERWRITE, INDEX>::consume(size_t nbr_elements) {
+    return this->discard(nbr_elements);
+}
+
+template <size_t CAPACITY, typename T, bool OVERWRITE, typename INDEX>
+size_t YaRBt<CAPACITY, T, OVERWRITE, INDEX>::get(T *returned_element) {
     // check for emptyness and validity of output pointer (may  be nullptr)
     if (this->isEmpty() || !returned_element) {
         return 0;
     }
     else {
-        *returned_element = arr[readindex];
-        readindex = (readindex + 1) % (CAPACITY+1);
+        *returned_element = static_cast<T&&>(arr[idx::pos(readindex)]);
+        readindex = idx::next(readindex);
         return 1;
     }
 }
 
-template <size_t CAPACITY>
-size_t YaRBt<CAPACITY>::get(uint8_t *returned_elements, size_t nbr_elements) {
+template <size_t CAPACITY, typename T, bool OVERWRITE, typename INDEX>
+size_t YaRBt<CAPACITY, T, OVERWRITE, INDEX>::get(T *returned_elements, size_t nbr_elements) {
     // check for nullptr
     if (!returned_elements) {
         return 0;
@@ -182,52 +293,54 @@ size_t YaRBt<CAPACITY>::get(uint8_t *returned_elements, size_t nbr_elements) {
         if (nbr_elements > this->size()) {
             nbr_elements = this->size();
         }
-        for (size_t i=0; i<nbr_elements; i++) {    
-            *returned_elements = arr[readindex];
-            readindex = (readindex+1) % (CAPACITY+1);
-            returned_elements++;
+        // copy out in at most two segments:
+        // from readindex to end of array, then from start of array
+        const size_t r = idx::pos(readindex);
+        const size_t diff_to_end = idx::slots - r;
+        if (nbr_elements <= diff_to_end) { // does not wrap
+            YaRBCopy<T>::move(returned_elements, arr+r, nbr_elements);
+        }
+        else {
+            YaRBCopy<T>::move(returned_elements, arr+r, diff_to_end);
+            YaRBCopy<T>::move(returned_elements+diff_to_end, arr, nbr_elements-diff_to_end);
         }
+        readindex = idx::advance(readindex, nbr_elements);
         return nbr_elements;
     }
 }
         
-template <size_t CAPACITY>
-size_t YaRBt<CAPACITY>::size(void) const {
-    if (writeindex >= readindex) {
-        return writeindex - readindex;
-    }
-    else {
-        return (CAPACITY+1) - (readindex - writeindex);
-    }
+template <size_t CAPACITY, typename T, bool OVERWRITE, typename INDEX>
+size_t YaRBt<CAPACITY, T, OVERWRITE, INDEX>::size(void) const {
+    return idx::used(readindex, writeindex);
 }
 
-template <size_t CAPACITY>
-size_t YaRBt<CAPACITY>::free(void) const {
+template <size_t CAPACITY, typename T, bool OVERWRITE, typename INDEX>
+size_t YaRBt<CAPACITY, T, OVERWRITE, INDEX>::free(void) const {
     return this->capacity() - this->size();
 }
 
-template <size_t CAPACITY>
-size_t YaRBt<CAPACITY>::capacity(void) const {
+template <size_t CAPACITY, typename T, bool OVERWRITE, typename INDEX>
+size_t YaRBt<CAPACITY, T, OVERWRITE, INDEX>::capacity(void) const {
     return CAPACITY;
 }
 
-template <size_t CAPACITY>
-bool YaRBt<CAPACITY>::isFull(void) const {
-    return readindex == (writeindex + 1) % (CAPACITY+1);
+template <size_t CAPACITY, typename T, bool OVERWRITE, typename INDEX>
+bool YaRBt<CAPACITY, T, OVERWRITE, INDEX>::isFull(void) const {
+    return idx::full(readindex, writeindex);
 }
 
-template <size_t CAPACITY>
-bool YaRBt<CAPACITY>::isEmpty(void) const {
+template <size_t CAPACITY, typename T, bool OVERWRITE, typename INDEX>
+bool YaRBt<CAPACITY, T, OVERWRITE, INDEX>::isEmpty(void) const {
     return readindex == writeindex;
 }
 
-template <size_t CAPACITY>
-void YaRBt<CAPACITY>::flush(void) {
+template <size_t CAPACITY, typename T, bool OVERWRITE, typename INDEX>
+void YaRBt<CAPACITY, T, OVERWRITE, INDEX>::flush(void) {
     // fast-forward readindex to position of writeindex
     readindex = writeindex;
 }
 
-template <size_t CAPACITY>
-size_t YaRBt<CAPACITY>::limit(void) {
-    return SIZE_MAX - 1;
+template <size_t CAPACITY, typename T, bool OVERWRITE, typename INDEX>
+size_t YaRBt<CAPACITY, T, OVERWRITE, INDEX>::limit(void) {
+    return idx::max_capacity;
 }
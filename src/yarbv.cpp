@@ -0,0 +1,268 @@
+/**
+ * @file    yarbv.cpp
+ * @brief   Implementation file for a mirrored ring buffer using virtual memory (hosted platforms only)
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarbv_cpp License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "yarbv.h"
+
+#if defined(YARB_HOSTED)
+
+#include <string.h>    // memcpy()
+#include <unistd.h>    // sysconf(), ftruncate(), close()
+#include <sys/mman.h>  // mmap(), munmap(), memfd_create() (Linux)
+#if defined(__APPLE__)
+#include <fcntl.h>     // O_CREAT, ...
+#include <stdio.h>     // snprintf()
+#endif
+
+/* YaRBv */
+
+/**
+ * @brief   Create an anonymous shared memory object of a given size.
+ * @param   nbr_bytes
+ *          Size of the memory object.
+ * @return  File descriptor of the memory object, -1 on failure.
+ */
+static int yarbv_create_fd(size_t nbr_bytes) {
+#if defined(__APPLE__)
+    // No memfd_create() on macOS: use a POSIX shared memory object with
+    // a unique name and remove the name immediately.
+    static unsigned int counter = 0;
+    char name[32];
+    snprintf(name, sizeof(name), "/yarbv.%ld.%u", static_cast<long>(getpid()), counter++);
+    const int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) return -1;
+    shm_unlink(name);
+#else
+    const int fd = memfd_create("yarbv", 0);
+    if (fd < 0) return -1;
+#endif
+    if (ftruncate(fd, static_cast<off_t>(nbr_bytes)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief   Map the same physical pages twice, back to back.
+ * @param   nbr_bytes
+ *          Size of one mapping, must be a multiple of the page size.
+ * @return  Start address of the first mapping, nullptr on failure.
+ */
+static uint8_t* yarbv_map(size_t nbr_bytes) {
+    const int fd = yarbv_create_fd(nbr_bytes);
+    if (fd < 0) return nullptr;
+    // reserve address space for both mappings...
+    void *base = mmap(nullptr, 2*nbr_bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return nullptr;
+    }
+    uint8_t *first = static_cast<uint8_t*>(base);
+    // ...and replace the reservation with two views onto the same memory object
+    void *a = mmap(first,           nbr_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    void *b = mmap(first+nbr_bytes, nbr_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    // the mappings keep the memory object alive
+    close(fd);
+    if (a == MAP_FAILED || b == MAP_FAILED) {
+        munmap(base, 2*nbr_bytes);
+        return nullptr;
+    }
+    return first;
+}
+
+/**
+ * @brief   The constructor.
+ * @param   capacity
+ *          The target capacity of the ring buffer. It is rounded up to a
+ *          multiple of the page size. The memory is mapped upon construction.
+ *          The size is constant and cannot be changed afterwards.
+ * @note    If the memory cannot be mapped, capacity() will return 0.
+ */
+YaRBv::YaRBv(size_t capacity) 
+    : cap{0}, readindex{0}, writeindex{0}, arraypointer{nullptr} {
+    const size_t pagesize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    if (capacity == 0) capacity = 1;
+    // round up to multiple of page size, check for overflow
+    const size_t pages = capacity / pagesize + ((capacity % pagesize) ? 1 : 0);
+    if (pages > limit() / pagesize) return;
+    arraypointer = yarbv_map(pages * pagesize);
+    if (arraypointer) {
+        cap = pages * pagesize;
+    }
+}
+
+/**
+ * @brief   The copy constructor.
+ * @details Creates a new mapping of the same capacity and copies only
+ *          the stored elements.
+ * @param   rb
+ *          Reference to class instance to copy.
+ */
+YaRBv::YaRBv(const YaRBv &rb)
+    : YaRBv(rb.cap) {
+    if (cap == rb.cap && cap != 0) {
+        readindex = rb.readindex;
+        writeindex = rb.writeindex;
+        // thanks to the mirroring, the stored elements are always contiguous
+        memcpy(arraypointer+pos(readindex), rb.arraypointer+pos(readindex), rb.size());
+    }
+}
+
+/**
+ * @brief   The destructor.
+ */
+YaRBv::~YaRBv() {
+    if (arraypointer) {
+        munmap(arraypointer, 2*cap);
+    }
+}
+
+size_t YaRBv::put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) {
+    // check validity of input pointer (may be nullptr)
+    if (!new_elements ) {
+        return 0;
+    }
+    // only add at most free() elements to ring buffer
+    if (nbr_elements > this->free()) {
+        if (only_complete) return 0;
+        nbr_elements = this->free();
+    }
+    // no wrap-around thanks to the second mapping
+    memcpy(arraypointer+pos(writeindex), new_elements, nbr_elements);
+    writeindex = advance(writeindex, nbr_elements);
+    return nbr_elements;
+}
+
+size_t YaRBv::peek(uint8_t *peeked_element, size_t offset) const {
+    // check for enough elements and validity of output pointer (may be nullptr)
+    if (offset >= this->size() || !peeked_element) {
+        return 0;
+    }
+    else {
+        // no wrap-around thanks to the second mapping
+        *peeked_element = arraypointer[pos(readindex) + offset];
+        return 1;
+    }
+}
+
+size_t YaRBv::peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const {
+    // check for nullptr
+    if (!peeked_elements) {
+        return 0;
+    }
+    // only peek at most the size()-offset elements after offset
+    const size_t used = this->size();
+    if (offset >= used) {
+        return 0;
+    }
+    if (nbr_elements > used - offset) {
+        nbr_elements = used - offset;
+    }
+    // no wrap-around thanks to the second mapping
+    memcpy(peeked_elements, arraypointer+pos(readindex)+offset, nbr_elements);
+    return nbr_elements;
+}
+
+size_t YaRBv::discard(size_t nbr_elements) {
+    if (this->size() > nbr_elements) { // there will be remaining elements in buffer
+        readindex = advance(readindex, nbr_elements);
+        return nbr_elements;
+    }
+    else { // discard *all* elements --> flush()
+        // we can only discard at many elements as are in the buffer
+        // --> return size()
+        size_t retval = this->size();
+        this->flush();
+        return retval;
+    }
+}
+
+size_t YaRBv::writeReserve(uint8_t **region) {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
+        return 0;
+    }
+    // all free slots are contiguous thanks to the second mapping
+    *region = arraypointer+pos(writeindex);
+    return this->free();
+}
+
+size_t YaRBv::commit(size_t nbr_elements) {
+    if (nbr_elements > this->free()) {
+        nbr_elements = this->free();
+    }
+    writeindex = advance(writeindex, nbr_elements);
+    return nbr_elements;
+}
+
+size_t YaRBv::readSpan(const uint8_t **region) const {
+    // check validity of output pointer (may be nullptr)
+    if (!region) {
+        return 0;
+    }
+    // all stored elements are contiguous thanks to the second mapping
+    *region = arraypointer+pos(readindex);
+    return this->size();
+}
+
+size_t YaRBv::consume(size_t nbr_elements) {
+    return this->discard(nbr_elements);
+}
+
+size_t YaRBv::get(uint8_t *returned_elements, size_t nbr_elements) {
+    // check nullptr
+    if (!returned_elements) {
+        return 0;
+    }
+    else {
+        // only get at most size() elements from buffer
+        if (nbr_elements > this->size()) {
+            nbr_elements = this->size();
+        }
+        // no wrap-around thanks to the second mapping
+        memcpy(returned_elements, arraypointer+pos(readindex), nbr_elements);
+        readindex = advance(readindex, nbr_elements);
+        return nbr_elements;
+    }
+}
+        
+void YaRBv::flush(void) {
+    // fast-forward readindex to position of writeindex
+    readindex = writeindex;
+}
+
+size_t YaRBv::limit(void) {
+    // two mappings of the array must fit into the address space
+    return SIZE_MAX / 2;
+}
+
+#endif // YARB_HOSTED
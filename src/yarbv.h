@@ -0,0 +1,219 @@
+/**
+ * @file    yarbv.h
+ * @brief   Header file for a mirrored ring buffer using virtual memory (hosted platforms only)
+ * @author  Andreas Grommek
+ * @version 1.5.0
+ * @date    2021-10-02
+ * 
+ * @section license_yarbv_h License
+ * 
+ * The MIT Licence (MIT)
+ * 
+ * Copyright (c) 2021 Andreas Grommek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef yarbv_h
+#define yarbv_h
+
+#include "yarb_interface.h"
+
+#if defined(YARB_HOSTED)
+
+/**
+ * @class   YaRBv
+ * @brief   Ring buffer implementation using an array which is mapped twice
+ *          into virtual memory, back to back ("v" for virtual memory).
+ * @details The same physical pages are visible at address arr and at
+ *          address arr+capacity(). Therefore, @b any range of up to 
+ *          capacity() elements starting at any position in the array is 
+ *          contiguous in memory - there is no wrap-around from the point
+ *          of view of the user:
+ *
+ *          @li bulk put() and get() are a single memcpy() each
+ *          @li readSpan() always returns all stored elements, size()
+ *          @li writeReserve() always returns all free slots, free()
+ *
+ *          This makes it possible to hand the contents of the ring buffer
+ *          directly to write()/send() or to a parser.
+ *
+ *          The indices are calculated modulo 2*capacity (as for YaRB2),
+ *          so all slots of the array can be used.
+ * @note    The capacity is rounded up to a multiple of the page size of
+ *          the operating system. Call capacity() to get the actual value.
+ *          If the mapping could not be created, capacity() returns 0 and
+ *          every put() or get() fails.
+ * @note    This class is only available on hosted platforms (Linux, macOS),
+ *          i.e. if YARB_HOSTED is defined.
+ * @warning This class is @b not thread-safe.
+ */
+class YaRBv final : public IYaRB {
+    public:
+        // constructor
+        YaRBv(size_t capacity=4096);
+        
+        // copy constructor
+        YaRBv(const YaRBv &rb);
+        
+        // destructor
+        virtual ~YaRBv(void);
+        
+        // do not allow assignments
+        YaRBv& operator= (const YaRBv &rb) = delete;
+
+        // put element(s) into ring buffer
+        size_t put(uint8_t new_element) override;
+        size_t put(const uint8_t *new_elements, size_t nbr_elements, bool only_complete) override;
+
+        // get/remove element(s) from ring buffer
+        size_t get(uint8_t *returned_element) override;
+        size_t get(uint8_t *returned_elements, size_t nbr_elements) override;
+        
+        // look at element(s) in ring buffer without removing them
+        size_t peek(uint8_t *peeked_element) const override; 
+        size_t peek(uint8_t *peeked_element, size_t offset) const override;
+        size_t peek(uint8_t *peeked_elements, size_t nbr_elements, size_t offset) const override;
+        
+        // discard some elements from ring buffer, 
+        // return number of discarded elements
+        size_t discard(size_t nbr_elements) override;
+
+        // zero-copy access to the internal array
+        // (regions are never split by the end of the array)
+        size_t writeReserve(uint8_t **region) override;
+        size_t commit(size_t nbr_elements) override;
+        size_t readSpan(const uint8_t **region) const override;
+        size_t consume(size_t nbr_elements) override;
+
+        size_t size(void) const override;     // return number of slots in use
+        size_t free(void) const override;     // return number of free slots
+        size_t capacity(void) const override; // return total number of slots
+
+        bool   isFull(void) const override;   // return true when buffer is full
+        bool   isEmpty(void) const override;  // return true when buffer is empty
+        void   flush(void) override;          // clear all elements from buffer
+        
+        // no override for static functions...
+        static size_t limit(void);   // return maximum possible number of elements on a given platform
+
+    private:
+        size_t  cap;           ///< store capacity of ring buffer (multiple of page size)
+        size_t  readindex;     ///< index for get()
+        size_t  writeindex;    ///< index for put()
+        uint8_t *arraypointer; ///< pointer to the first of the two mappings of the array
+        
+        size_t  pos(size_t val) const;
+        size_t  advance(size_t val, size_t nbr_elements) const;
+};
+
+// inline definitions of the functions on the hot path
+
+/**
+ * @brief   Get the position within the array for an index.
+ * @param   val
+ *          Index, must be smaller than 2*cap.
+ * @return  Position within the (first mapping of the) array.
+ */
+inline size_t YaRBv::pos(size_t val) const {
+    return (val >= cap) ? (val - cap) : val;
+}
+
+/**
+ * @brief   Advance an index by a number of elements, modulo 2*cap.
+ * @param   val
+ *          Index to advance, must be smaller than 2*cap.
+ * @param   nbr_elements
+ *          Number of elements to advance the index by, must not be larger
+ *          than cap.
+ * @return  New value of the index.
+ */
+inline size_t YaRBv::advance(size_t val, size_t nbr_elements) const {
+    // The difference between val and 2*cap is always > 0 (i.e. at least 1)
+    const size_t diff_to_max = 2*cap - val;
+    if (diff_to_max <= nbr_elements) { // val+nbr_elements >= 2*cap --> wrap
+        return nbr_elements - diff_to_max;
+    }
+    else { // adding nbr_elements to val stays in correct range
+        return val + nbr_elements;
+    }
+}
+
+inline size_t YaRBv::put(uint8_t new_element) {
+    if (this->isFull()) {
+        return 0;
+    }
+    else {
+        arraypointer[pos(writeindex)] = new_element;
+        writeindex = advance(writeindex, 1);
+        return 1;
+    }
+}
+
+inline size_t YaRBv::peek(uint8_t *peeked_element) const {
+    // check for emptyness and validity of output pointer (may be nullptr)
+    if (this->isEmpty() || !peeked_element) {
+        return 0;
+    }
+    else {
+        *peeked_element = arraypointer[pos(readindex)];
+        return 1;
+    }
+}
+
+inline size_t YaRBv::get(uint8_t *returned_element) {
+    // check for emptyness and validity of output pointer (may  be nullptr)
+    if (this->isEmpty() || !returned_element) {
+        return 0;
+    }
+    else {
+        *returned_element = arraypointer[pos(readindex)];
+        readindex = advance(readindex, 1);
+        return 1;
+    }
+}
+
+inline size_t YaRBv::size(void) const {
+    if (writeindex >= readindex) {
+        return writeindex - readindex;
+    }
+    else {
+        return 2*cap - (readindex - writeindex);
+    }
+}
+
+inline size_t YaRBv::free(void) const {
+    return cap - this->size();
+}
+
+inline size_t YaRBv::capacity(void) const {
+    return cap;
+}
+
+inline bool YaRBv::isFull(void) const {
+    return this->size() == cap;
+}
+
+inline bool YaRBv::isEmpty(void) const {
+    return readindex == writeindex;
+}
+
+#endif // YARB_HOSTED
+
+#endif // yarbv_h